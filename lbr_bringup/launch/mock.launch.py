@@ -1,5 +1,5 @@
 from launch import LaunchDescription
-from launch.actions import RegisterEventHandler
+from launch.actions import DeclareLaunchArgument, RegisterEventHandler
 from launch.event_handlers import OnProcessStart
 from launch.substitutions import LaunchConfiguration, PathJoinSubstitution
 from lbr_bringup.description import LBRDescriptionMixin
@@ -15,6 +15,14 @@ def generate_launch_description() -> LaunchDescription:
     ld.add_action(LBRROS2ControlMixin.arg_ctrl_cfg_pkg())
     ld.add_action(LBRROS2ControlMixin.arg_ctrl_cfg())
     ld.add_action(LBRROS2ControlMixin.arg_ctrl())
+    ld.add_action(
+        DeclareLaunchArgument(
+            name="mode",
+            default_value="mock",
+            description="The mock mode. lbr_mock emulates the FRI, including all LBR specific interfaces. lbr_sim further simulates the dynamics.",
+            choices=["mock", "lbr_mock", "lbr_sim"],
+        )
+    )
 
     # static transform world -> robot_name/world
     ld.add_action(
@@ -26,7 +34,9 @@ def generate_launch_description() -> LaunchDescription:
     )
 
     # robot description
-    robot_description = LBRDescriptionMixin.param_robot_description(mode="mock")
+    robot_description = LBRDescriptionMixin.param_robot_description(
+        mode=LaunchConfiguration("mode")
+    )
 
     # robot state publisher
     robot_state_publisher = LBRROS2ControlMixin.node_robot_state_publisher(
@@ -35,7 +45,9 @@ def generate_launch_description() -> LaunchDescription:
     ld.add_action(robot_state_publisher)
 
     # ros2 control node
-    ros2_control_node = LBRROS2ControlMixin.node_ros2_control(use_sim_time=False)
+    ros2_control_node = LBRROS2ControlMixin.node_ros2_control(
+        use_sim_time=False, mode=LaunchConfiguration("mode")
+    )
     ld.add_action(ros2_control_node)
 
     # joint state broad caster and controller on ros2 control node start
@@ -0,0 +1,51 @@
+from typing import List
+
+from launch import LaunchContext, LaunchDescription, LaunchDescriptionEntity
+from launch.actions import OpaqueFunction
+from launch.substitutions import LaunchConfiguration
+from lbr_bringup.description import LBRDescriptionMixin
+from lbr_bringup.move_group import LBRMoveGroupMixin, LBRMoveItServoMixin
+
+
+def hidden_setup(context: LaunchContext) -> List[LaunchDescriptionEntity]:
+    ld = LaunchDescription()
+
+    ld.add_action(LBRDescriptionMixin.arg_robot_name())
+
+    model = LaunchConfiguration("model").perform(context)
+    moveit_configs_builder = LBRMoveGroupMixin.moveit_configs_builder(
+        robot_name=model,
+        package_name=f"{model}_moveit_config",
+    )
+    moveit_servo_params = LBRMoveItServoMixin.params_moveit_servo(
+        package_name=f"{model}_moveit_config"
+    )
+
+    mode = LaunchConfiguration("mode").perform(context)
+    use_sim_time = False
+    if mode == "gazebo":
+        use_sim_time = True
+
+    # MoveIt Servo, commands the forward_position_controller
+    robot_name = LaunchConfiguration("robot_name")
+    ld.add_action(
+        LBRMoveItServoMixin.node_moveit_servo(
+            parameters=[
+                moveit_configs_builder.to_dict(),
+                moveit_servo_params,
+                {"use_sim_time": use_sim_time},
+            ],
+            namespace=robot_name,
+        )
+    )
+    return ld.entities
+
+
+def generate_launch_description() -> LaunchDescription:
+    ld = LaunchDescription()
+
+    ld.add_action(LBRDescriptionMixin.arg_mode())
+    ld.add_action(LBRDescriptionMixin.arg_model())
+
+    ld.add_action(OpaqueFunction(function=hidden_setup))
+    return ld
@@ -86,6 +86,8 @@ class LBRDescriptionMixin:
             description="The mode to launch in.",
             choices=[
                 "mock",
+                "lbr_mock",
+                "lbr_sim",
                 "hardware",
                 "gazebo",
             ],
@@ -4,6 +4,7 @@ from typing import Any, Dict, List
 from ament_index_python import get_package_share_directory
 from launch.actions import DeclareLaunchArgument
 from launch.substitutions import LaunchConfiguration
+from launch_param_builder import ParameterBuilder
 from launch_ros.actions import Node
 from launch_ros.parameter_descriptions import ParameterValue
 from moveit_configs_utils import MoveItConfigs, MoveItConfigsBuilder
@@ -118,3 +119,22 @@ class LBRMoveGroupMixin:
             output="screen",
             **kwargs,
         )
+
+
+class LBRMoveItServoMixin:
+    @staticmethod
+    def params_moveit_servo(
+        package_name: str, servo_cfg: str = "config/moveit_servo.yaml"
+    ) -> Dict[str, Any]:
+        return {
+            "moveit_servo": ParameterBuilder(package_name).yaml(servo_cfg).to_dict()
+        }
+
+    @staticmethod
+    def node_moveit_servo(**kwargs) -> Node:
+        return Node(
+            package="moveit_servo",
+            executable="servo_node_main",
+            output="screen",
+            **kwargs,
+        )
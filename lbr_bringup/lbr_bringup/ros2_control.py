@@ -1,11 +1,67 @@
-from typing import Dict, Optional, Union
+import os
+from typing import Dict, Optional, Text, Union
 
+import yaml
+from ament_index_python import get_package_share_directory
 from launch.actions import DeclareLaunchArgument
+from launch.launch_context import LaunchContext
+from launch.some_substitutions_type import SomeSubstitutionsType
+from launch.substitution import Substitution
 from launch.substitutions import LaunchConfiguration, PathJoinSubstitution
+from launch.utilities import (
+    normalize_to_list_of_substitutions,
+    perform_substitutions,
+)
 from launch_ros.actions import Node
 from launch_ros.substitutions import FindPackageShare
 
 
+class ROS2ControlNodeSubstitution(Substitution):
+    """Resolves the package or executable of the controller_manager node for a mode. The
+    lbr_ros2_control_node only where the hardware plugin synchronizes to the FRI cycle via the
+    lbr_fri_ros2::CycleSync, i.e. hardware with cycle_sync, lbr_mock and lbr_sim with cycle_sync
+    or free_running. The controller_manager's ros2_control_node otherwise."""
+
+    def __init__(
+        self,
+        mode: SomeSubstitutionsType,
+        executable: bool,
+        system_parameters_path: Optional[str] = None,
+    ) -> None:
+        super().__init__()
+        self._mode = normalize_to_list_of_substitutions(mode)
+        self._executable = executable
+        self._system_parameters_path = system_parameters_path
+
+    def describe(self) -> Text:
+        return "ROS2ControlNodeSubstitution(mode={}, executable={})".format(
+            " + ".join([sub.describe() for sub in self._mode]), self._executable
+        )
+
+    def perform(self, context: LaunchContext) -> Text:
+        if self.uses_cycle_sync(
+            perform_substitutions(context, self._mode), self._system_parameters_path
+        ):
+            return "lbr_ros2_control_node" if self._executable else "lbr_ros2_control"
+        return "ros2_control_node" if self._executable else "controller_manager"
+
+    @staticmethod
+    def uses_cycle_sync(mode: str, system_parameters_path: Optional[str] = None) -> bool:
+        if system_parameters_path is None:
+            system_parameters_path = os.path.join(
+                get_package_share_directory("lbr_ros2_control"),
+                "config/lbr_system_parameters.yaml",
+            )
+        with open(system_parameters_path, "r") as f:
+            system_parameters = yaml.safe_load(f)
+        cycle_sync = bool(system_parameters["hardware"].get("cycle_sync", False))
+        if mode == "hardware":
+            return cycle_sync
+        if mode in ["lbr_mock", "lbr_sim"]:
+            return cycle_sync or bool(system_parameters["mock"].get("free_running", False))
+        return False
+
+
 class LBRROS2ControlMixin:
     @staticmethod
     def arg_ctrl_cfg_pkg() -> DeclareLaunchArgument:
@@ -33,8 +89,13 @@ class LBRROS2ControlMixin:
                 "joint_trajectory_controller",
                 "forward_position_controller",
                 "lbr_joint_position_command_controller",
+                "lbr_joint_position_stream_controller",
                 "lbr_torque_command_controller",
                 "lbr_wrench_command_controller",
+                "admittance_controller",
+                "admittance_rcm_controller",
+                "cartesian_impedance_controller",
+                "joint_impedance_controller",
             ],
         )
 
@@ -54,11 +115,14 @@ class LBRROS2ControlMixin:
         use_sim_time: Optional[Union[LaunchConfiguration, bool]] = LaunchConfiguration(
             "use_sim_time", default="false"
         ),
+        mode: Optional[Union[LaunchConfiguration, str]] = LaunchConfiguration(
+            "mode", default="mock"
+        ),
         **kwargs,
     ) -> Node:
         return Node(
-            package="controller_manager",
-            executable="ros2_control_node",
+            package=ROS2ControlNodeSubstitution(mode=mode, executable=False),
+            executable=ROS2ControlNodeSubstitution(mode=mode, executable=True),
             parameters=[
                 {"use_sim_time": use_sim_time},
                 PathJoinSubstitution(
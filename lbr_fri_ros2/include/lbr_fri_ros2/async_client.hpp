@@ -5,12 +5,14 @@
 #include <memory>
 #include <string>
 
+#include "rclcpp/clock.hpp"
 #include "rclcpp/logger.hpp"
 #include "rclcpp/logging.hpp"
 
 #include "friClientVersion.h"
 #include "friLBRClient.h"
 
+#include "lbr_fri_ros2/cycle_sync.hpp"
 #include "lbr_fri_ros2/filters.hpp"
 #include "lbr_fri_ros2/formatting.hpp"
 #include "lbr_fri_ros2/interfaces/base_command.hpp"
@@ -23,6 +25,7 @@ namespace lbr_fri_ros2 {
 class AsyncClient : public KUKA::FRI::LBRClient {
 protected:
   static constexpr char LOGGER_NAME[] = "lbr_fri_ros2::AsyncClient";
+  static constexpr double CYCLE_SYNC_TIMEOUT_RATIO = 0.5; // fraction of the sample time
 
 public:
   AsyncClient() = delete;
@@ -31,7 +34,7 @@ public:
               const CommandGuardParameters &command_guard_parameters,
               const std::string &command_guard_variant,
               const StateInterfaceParameters &state_interface_parameters = {10.0, 10.0},
-              const bool &open_loop = true);
+              const bool &open_loop = true, const bool &cycle_sync = false);
 
   inline std::shared_ptr<BaseCommandInterface> get_command_interface() {
     return command_interface_ptr_;
@@ -49,6 +52,12 @@ protected:
   std::shared_ptr<StateInterface> state_interface_ptr_;
 
   bool open_loop_;
+
+  // synchronous control, the command to a state goes into the reply of the same cycle
+  bool cycle_sync_;
+  rclcpp::Clock steady_clock_{RCL_STEADY_TIME};
+  void sync_state_();
+  void sync_command_();
 };
 } // namespace lbr_fri_ros2
 #endif // LBR_FRI_ROS2__ASYNC_CLIENT_HPP_
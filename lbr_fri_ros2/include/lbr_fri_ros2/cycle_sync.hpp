@@ -0,0 +1,106 @@
+#ifndef LBR_FRI_ROS2__CYCLE_SYNC_HPP_
+#define LBR_FRI_ROS2__CYCLE_SYNC_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <pthread.h>
+
+namespace lbr_fri_ros2 {
+/**
+ * @brief Synchronizes a control loop, e.g. the controller_manager's read, update and write, with
+ * the FRI cycle. The FRI thread notifies each received state and, while commanding, waits for
+ * the control loop's command, so that it goes into the reply of the same cycle.
+ *
+ * The hardware plugin and the controller_manager node do not share objects, hence a single
+ * process-wide instance.
+ *
+ * The FRI thread (hardware rt_prio) and the control loop (lbr_ros2_control_node rt_prio) share a
+ * priority-inheritance mutex. A control loop holding it runs at the FRI thread's priority until
+ * released, so that threads in between cannot preempt it while the FRI thread waits.
+ */
+class CycleSync {
+protected:
+  using clock_t = std::chrono::steady_clock;
+
+public:
+  static CycleSync &instance();
+
+  CycleSync(const CycleSync &) = delete;
+  CycleSync &operator=(const CycleSync &) = delete;
+
+  /**
+   * @brief Enable synchronization, set by the FRI side. While disabled, the control loop runs at
+   * its own rate and does not wait for states.
+   *
+   * @param[in] enabled Whether states are notified and commands awaited.
+   * @param[in] emulated_clock Whether the state time stamps are an emulated clock, e.g. of a
+   * free-running emulation that runs faster than the wall clock. The control loop then takes its
+   * time from the time stamps, rather than the ROS clock.
+   */
+  inline void enable(const bool &enabled, const bool &emulated_clock = false) {
+    emulated_clock_ = emulated_clock;
+    enabled_ = enabled;
+  }
+  inline bool is_enabled() const { return enabled_; }
+  inline bool is_clock_emulated() const { return emulated_clock_; }
+
+  /**
+   * @brief FRI thread. Notify a new state, i.e. the start of a cycle.
+   *
+   * @param[in] stamp The state's time stamp, the robot's (or an emulated) clock.
+   */
+  void notify_state(const std::chrono::nanoseconds &stamp);
+
+  /**
+   * @brief FRI thread. Wait for the control loop's command to the latest state.
+   *
+   * @param[in] timeout Timeout, should leave sufficient margin to reply within the sample time.
+   * @return true if the command arrived in time, false if the previous command has to be used.
+   */
+  bool wait_for_command(const std::chrono::nanoseconds &timeout);
+
+  /**
+   * @brief Control loop. Wait for a state that has not yet been handled.
+   *
+   * @param[in] deadline Deadline, e.g. the next iteration of a free-running loop.
+   * @return true if a new state arrived before the deadline.
+   */
+  bool wait_for_state_until(const clock_t::time_point &deadline);
+
+  /**
+   * @brief Control loop. Time stamp of the latest handled state.
+   *
+   */
+  inline const std::chrono::nanoseconds &get_state_stamp() const { return handled_stamp_; }
+
+  /**
+   * @brief Control loop. Notify that the command to the latest handled state was written.
+   *
+   */
+  void notify_command();
+
+  /**
+   * @brief Number of cycles in which the command missed the reply.
+   *
+   */
+  inline uint64_t get_missed_cycles() const { return missed_cycles_; }
+
+protected:
+  CycleSync();
+  ~CycleSync();
+
+  // wait on condition until predicate or deadline, mutex_ locked
+  bool wait_until_(pthread_cond_t &condition, const clock_t::time_point &deadline,
+                   const std::function<bool()> &predicate);
+
+  std::atomic_bool enabled_, emulated_clock_;
+  pthread_mutex_t mutex_;
+  pthread_cond_t state_cond_, command_cond_;
+  uint64_t state_cycle_, handled_cycle_, command_cycle_;
+  std::chrono::nanoseconds state_stamp_, handled_stamp_;
+  std::atomic<uint64_t> missed_cycles_;
+};
+} // namespace lbr_fri_ros2
+#endif // LBR_FRI_ROS2__CYCLE_SYNC_HPP_
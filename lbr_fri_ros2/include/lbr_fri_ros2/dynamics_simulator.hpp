@@ -0,0 +1,127 @@
+#ifndef LBR_FRI_ROS2__DYNAMICS_SIMULATOR_HPP_
+#define LBR_FRI_ROS2__DYNAMICS_SIMULATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "eigen3/Eigen/Cholesky"
+#include "eigen3/Eigen/Core"
+#include "kdl/chain.hpp"
+#include "kdl/chaindynparam.hpp"
+#include "kdl/chainfksolverpos_recursive.hpp"
+#include "kdl/chainjnttojacsolver.hpp"
+#include "kdl/frames.hpp"
+#include "kdl/jacobian.hpp"
+#include "kdl/jntarray.hpp"
+#include "kdl/jntspaceinertiamatrix.hpp"
+#include "rclcpp/logger.hpp"
+#include "rclcpp/logging.hpp"
+
+#include "friLBRState.h"
+
+#include "lbr_fri_idl/msg/lbr_command.hpp"
+#include "lbr_fri_idl/msg/lbr_state.hpp"
+
+namespace lbr_fri_ros2 {
+struct DynamicsSimulatorParameters {
+  using jnt_array_t = std::array<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS>;
+  jnt_array_t stiffness{1000., 1000., 1000., 1000., 500., 500., 200.}; // joint stiffness [Nm/rad]
+  jnt_array_t damping{50., 50., 30., 30., 10., 10., 5.};               // joint damping [Nms/rad]
+  jnt_array_t friction{0.5, 0.5, 0.5, 0.5, 0.2, 0.2, 0.1};             // viscous [Nms/rad]
+  jnt_array_t min_position{-2.96, -2.09, -2.96, -2.09, -2.96, -2.09, -3.05}; // [rad]
+  jnt_array_t max_position{2.96, 2.09, 2.96, 2.09, 2.96, 2.09, 3.05};        // [rad]
+  double time_step{0.001};                                                   // integration [s]
+  std::array<double, 3> gravity{0., 0., -9.81}; // gravity in the chain root frame [m/s^2]
+};
+
+/**
+ * @brief Rigid-body simulator of the LBR under the robot's own joint impedance controller. The
+ * controller compensates gravity and renders the configured stiffness and damping around the
+ * IPO joint position, on top of which a joint torque or a wrench at the chain tip is overlaid.
+ * Integrated with linearly implicit Euler steps, which are stable for any stiffness and damping.
+ * Does not allocate when stepping.
+ */
+class DynamicsSimulator {
+protected:
+  static constexpr char LOGGER_NAME[] = "lbr_fri_ros2::DynamicsSimulator";
+  static constexpr uint8_t N = KUKA::FRI::LBRState::NUMBER_OF_JOINTS;
+  using jnt_array_t = lbr_fri_idl::msg::LBRState::_measured_joint_position_type;
+  using const_jnt_array_t_ref = const jnt_array_t &;
+  using wrench_array_t = lbr_fri_idl::msg::LBRCommand::_wrench_type;
+  using const_wrench_array_t_ref = const wrench_array_t &;
+  using vector_t = Eigen::Matrix<double, N, 1>;
+  using matrix_t = Eigen::Matrix<double, N, N>;
+
+public:
+  /**
+   * @brief Construct a new Dynamics Simulator object.
+   *
+   * @param[in] chain The chain, with link inertias, e.g. from KinematicsCache::get_chain.
+   * @param[in] parameters The controller and integration parameters.
+   */
+  DynamicsSimulator(const KDL::Chain &chain, const DynamicsSimulatorParameters &parameters = {});
+
+  /**
+   * @brief Reset to rest at the given joint position.
+   *
+   */
+  void reset(const_jnt_array_t_ref joint_position);
+
+  /**
+   * @brief Advance the simulation.
+   *
+   * @param[in] dt The duration, split into steps of at most time_step.
+   * @param[in] ipo_joint_position The joint position the impedance controller tracks.
+   * @param[in] torque_overlay Joint torque overlay, e.g. the commanded torque.
+   * @param[in] wrench_overlay Wrench overlay at the chain tip, expressed in the chain tip frame.
+   * @param[in] external_torque External joint torque acting on the robot.
+   */
+  void step(const double &dt, const_jnt_array_t_ref ipo_joint_position,
+            const_jnt_array_t_ref torque_overlay, const_wrench_array_t_ref wrench_overlay,
+            const_jnt_array_t_ref external_torque);
+
+  inline const jnt_array_t &get_joint_position() const { return joint_position_; };
+  inline const jnt_array_t &get_joint_velocity() const { return joint_velocity_; };
+
+  /**
+   * @brief Joint torque applied by the controller, including gravity compensation, as measured
+   * by the joint torque sensors.
+   *
+   */
+  inline const jnt_array_t &get_measured_torque() const { return measured_torque_; };
+
+  /**
+   * @brief External joint torque as estimated by the robot, i.e. the measured torque minus the
+   * rigid-body model torque. Settles to the negated external torque acting on the robot.
+   *
+   */
+  inline const jnt_array_t &get_external_torque() const { return external_torque_; };
+
+protected:
+  void integrate_(const double &dt, const vector_t &ipo_joint_position,
+                  const vector_t &torque_overlay, const Eigen::Matrix<double, 6, 1> &wrench,
+                  const vector_t &external_torque);
+
+  DynamicsSimulatorParameters parameters_;
+  KDL::Chain chain_;
+  KDL::ChainDynParam dyn_param_;
+  KDL::ChainJntToJacSolver jacobian_solver_;
+  KDL::ChainFkSolverPos_recursive fk_solver_;
+
+  // state
+  jnt_array_t joint_position_, joint_velocity_, measured_torque_, external_torque_;
+
+  // preallocated
+  KDL::JntArray q_, qd_, coriolis_, gravity_;
+  KDL::JntSpaceInertiaMatrix mass_;
+  KDL::Jacobian jacobian_;
+  KDL::Frame tip_frame_;
+  vector_t stiffness_, damping_, friction_;
+  matrix_t system_;
+  Eigen::LLT<matrix_t> llt_;
+};
+} // namespace lbr_fri_ros2
+#endif // LBR_FRI_ROS2__DYNAMICS_SIMULATOR_HPP_
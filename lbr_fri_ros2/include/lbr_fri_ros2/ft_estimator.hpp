@@ -4,21 +4,24 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/Geometry"
+#include "eigen3/Eigen/SVD"
 #include "kdl/chain.hpp"
-#include "kdl/chainfksolverpos_recursive.hpp"
-#include "kdl/chainjnttojacsolver.hpp"
-#include "kdl/tree.hpp"
-#include "kdl_parser/kdl_parser.hpp"
+#include "kdl/frames.hpp"
 #include "rclcpp/logger.hpp"
 #include "rclcpp/logging.hpp"
 
 #include "friLBRState.h"
 
 #include "lbr_fri_idl/msg/lbr_state.hpp"
-#include "lbr_fri_ros2/pinv.hpp"
+#include "lbr_fri_ros2/kinematics_cache.hpp"
+#include "lbr_fri_ros2/payload_identifier.hpp"
+#include "lbr_fri_ros2/torque_bias_map.hpp"
 
 namespace lbr_fri_ros2 {
 class FTEstimator {
@@ -38,33 +41,124 @@ public:
   FTEstimator(const std::string &robot_description, const std::string &chain_root = "link_0",
               const std::string &chain_tip = "link_ee",
               const_cart_array_t_ref f_ext_th = {2., 2., 2., 0.5, 0.5, 0.5});
+  FTEstimator(const std::shared_ptr<KinematicsCache> kinematics_cache_ptr,
+              const_cart_array_t_ref f_ext_th = {2., 2., 2., 0.5, 0.5, 0.5});
+
+  /**
+   * @brief Evaluate the kinematics for measured_joint_position and estimate the external
+   * force-torque.
+   *
+   */
   void compute(const_jnt_pos_array_t_ref measured_joint_position,
                const_ext_tau_array_t_ref external_torque, cart_array_t_ref f_ext,
                const double &damping = 0.2);
+
+  /**
+   * @brief Estimate the external force-torque for the configuration that was last evaluated by
+   * the shared KinematicsCache.
+   *
+   */
+  void compute(const_ext_tau_array_t_ref external_torque, cart_array_t_ref f_ext,
+               const double &damping = 0.2);
+
+  /**
+   * @brief Estimate the external force-torque at the chain tip for the configuration that was last
+   * evaluated by the shared KinematicsCache. Query the result per frame via get_f_ext.
+   *
+   */
+  void estimate(const_ext_tau_array_t_ref external_torque, const double &damping = 0.2);
+
+  /**
+   * @brief Get the last estimate, expressed in and referenced to an estimation frame, thresholded.
+   * Does not allocate.
+   *
+   * @param[in] frame The frame index, as returned by add_frame. Index 0 is the chain tip.
+   * @param[out] f_ext The external force-torque.
+   */
+  void get_f_ext(const std::size_t &frame, cart_array_t_ref f_ext) const;
+
+  /**
+   * @brief Add an estimation frame. The frame has to be rigidly attached to the chain tip, e.g.
+   * a tool center point, or to the chain root, e.g. a fixture. The offset is resolved once from
+   * the kinematic tree, so call this during setup only.
+   *
+   * @param[in] frame The link name.
+   * @return std::size_t The frame index for get_f_ext.
+   */
+  std::size_t add_frame(const std::string &frame);
+  inline std::size_t get_number_of_frames() const { return frames_.size() + 1; }
+
+  /**
+   * @brief Confidence of the last estimate. Near singularities the smallest singular value of the
+   * Jacobian vanishes and the damping dominates the pseudo-inverse, i.e. the damping factor
+   * lambda^2 / (sigma_min^2 + lambda^2) approaches 1 and the estimate becomes biased.
+   *
+   */
+  inline const double &get_sigma_min() const { return sigma_min_; }
+  inline const double &get_manipulability() const { return manipulability_; }
+  inline const double &get_damping_factor() const { return damping_factor_; }
+
   void reset();
 
+  /**
+   * @brief Set the payload at the chain tip. Its gravitational wrench is removed from the
+   * estimate before thresholding.
+   *
+   * @param[in] payload The payload, e.g. from PayloadIdentifier.
+   * @param[in] gravity Gravity vector in the chain root frame.
+   */
+  void set_payload(const Payload &payload,
+                   PayloadIdentifier::const_gravity_t_ref gravity = {0., 0., -9.81});
+  inline const Payload &get_payload() const { return payload_; }
+
+  /**
+   * @brief Set a configuration-dependent external torque bias. The bias is interpolated and
+   * removed from the external torque before the projection onto the chain tip.
+   *
+   * @param[in] torque_bias_map_ptr Calibrated bias map. Pass nullptr to disable.
+   */
+  inline void set_torque_bias_map(const std::shared_ptr<const TorqueBiasMap> torque_bias_map_ptr) {
+    torque_bias_map_ptr_ = torque_bias_map_ptr;
+  }
+
+  inline std::shared_ptr<KinematicsCache> get_kinematics_cache() { return kinematics_cache_ptr_; }
+
 protected:
   // force threshold
   cart_array_t f_ext_th_;
 
-  KDL::Tree tree_;
-  KDL::Chain chain_;
+  // shared forward kinematics and Jacobian
+  std::shared_ptr<KinematicsCache> kinematics_cache_ptr_;
 
-  // solvers
-  std::unique_ptr<KDL::ChainJntToJacSolver> jacobian_solver_;
-  std::unique_ptr<KDL::ChainFkSolverPos_recursive> fk_solver_;
+  // additional estimation frames
+  struct EstimationFrame {
+    std::string name;
+    bool chain_root_attached;
+    KDL::Frame frame_to_reference;
+  };
+  std::vector<EstimationFrame> frames_;
 
-  // robot state
-  KDL::JntArray q_;
+  // payload compensation
+  Payload payload_;
+  Eigen::Vector3d gravity_, payload_mass_com_, gravity_tip_;
 
-  // forward kinematics
-  KDL::Frame chain_tip_frame_;
+  // configuration-dependent torque bias
+  std::shared_ptr<const TorqueBiasMap> torque_bias_map_ptr_;
+  jnt_pos_array_t joint_position_;
+  ext_tau_array_t tau_bias_;
 
   // force estimation
-  KDL::Jacobian jacobian_;
+  Eigen::Matrix<double, CARTESIAN_DOF, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> jacobian_;
+  Eigen::JacobiSVD<Eigen::Matrix<double, CARTESIAN_DOF, KUKA::FRI::LBRState::NUMBER_OF_JOINTS>>
+      jacobian_svd_;
+  Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, CARTESIAN_DOF>
+      damped_singular_values_inv_;
   Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, CARTESIAN_DOF> jacobian_inv_;
   Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, 1> tau_ext_;
   Eigen::Matrix<double, CARTESIAN_DOF, 1> f_ext_;
+
+  // confidence
+  double sigma_min_, manipulability_, damping_factor_;
 };
 } // namespace lbr_fri_ros2
 #endif // LBR_FRI_ROS2__FT_ESTIMATOR_HPP_
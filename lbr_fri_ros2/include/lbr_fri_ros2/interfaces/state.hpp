@@ -1,6 +1,10 @@
 #ifndef LBR_FRI_ROS2__INTERFACES__STATE_HPP_
 #define LBR_FRI_ROS2__INTERFACES__STATE_HPP_
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
 #include <string>
 
 #include "rclcpp/logger.hpp"
@@ -11,6 +15,7 @@
 
 #include "lbr_fri_idl/msg/lbr_state.hpp"
 #include "lbr_fri_ros2/filters.hpp"
+#include "lbr_fri_ros2/triple_buffer.hpp"
 
 namespace lbr_fri_ros2 {
 struct StateInterfaceParameters {
@@ -18,6 +23,34 @@ struct StateInterfaceParameters {
   double measured_torque_cutoff_frequency; /*Hz*/
 };
 
+struct StateBlock {
+  lbr_fri_idl::msg::LBRState state;
+
+  // enum and integer fields, cast on the FRI side for ros2_control handles
+  double session_state;
+  double connection_quality;
+  double safety_state;
+  double operation_mode;
+  double drive_state;
+  double client_command_mode;
+  double overlay_type;
+  double control_mode;
+  double time_stamp_sec;
+  double time_stamp_nano_sec;
+
+  // incremented per state sample
+  uint64_t sequence;
+
+  /**
+   * @brief Copy the sample and cast its enum and integer fields. In place, so that the block is
+   * not copied again in the real-time loop.
+   *
+   * @param[in] sample The state sample.
+   * @param[in] sample_sequence The sequence number of the sample.
+   */
+  void assign(const lbr_fri_idl::msg::LBRState &sample, const uint64_t &sample_sequence);
+};
+
 class StateInterface {
 protected:
   static constexpr char LOGGER_NAME[] = "lbr_fri_ros2::StateInterface";
@@ -37,21 +70,106 @@ public:
   StateInterface() = delete;
   StateInterface(const StateInterfaceParameters &state_interface_parameters = {10.0, 10.0});
 
+  /**
+   * @brief Get the state. Only to be called from the FRI thread, see get_state_block for the
+   * single real-time consumer, or get_session_state, get_control_mode and get_sample_time for
+   * any other thread.
+   *
+   */
   inline const_idl_state_t_ref get_state() const { return state_; };
 
+  /**
+   * @brief Get the latest state block, published by the FRI thread. Lock-free and safe to call from
+   * a single consumer thread, e.g. the ros2_control read.
+   *
+   */
+  inline const StateBlock &get_state_block() {
+    state_blocks_.acquire();
+    return state_blocks_.front();
+  };
+
   void set_state(const_fri_state_t_ref state);
   void set_state_open_loop(const_fri_state_t_ref state, const_idl_joint_pos_t_ref joint_position);
 
   inline void uninitialize() { state_initialized_ = false; }
   inline bool is_initialized() const { return state_initialized_; };
 
+  /**
+   * @brief Latest session state, safe to call from any thread.
+   *
+   */
+  inline fri_session_state_t get_session_state() const {
+    return static_cast<fri_session_state_t>(session_state_.load());
+  };
+
+  /**
+   * @brief Latest control mode, safe to call from any thread.
+   *
+   */
+  inline KUKA::FRI::EControlMode get_control_mode() const {
+    return static_cast<KUKA::FRI::EControlMode>(control_mode_.load());
+  };
+
+  /**
+   * @brief Latest sample time [s], safe to call from any thread.
+   *
+   */
+  inline double get_sample_time() const { return sample_time_.load(); };
+
+  /**
+   * @brief Latest client command mode, as configured on the robot, safe to call from any thread.
+   *
+   */
+  inline KUKA::FRI::EClientCommandMode get_client_command_mode() const {
+    return static_cast<KUKA::FRI::EClientCommandMode>(client_command_mode_.load());
+  };
+
+  /**
+   * @brief Block until the first state is received or the timeout expires. Woken by the FRI
+   * thread, not to be called from it.
+   *
+   * @param[in] timeout The timeout.
+   * @return true if initialized.
+   */
+  bool wait_for_initialized(const std::chrono::milliseconds &timeout);
+
+  /**
+   * @brief Block until the session state is at least session_state or the timeout expires. Woken
+   * by the FRI thread, not to be called from it.
+   *
+   * @param[in] session_state The minimum session state, e.g. COMMANDING_WAIT.
+   * @param[in] timeout The timeout.
+   * @return true if the session state was reached.
+   */
+  bool wait_for_session_state(const fri_session_state_t &session_state,
+                              const std::chrono::milliseconds &timeout);
+
   void log_info() const;
 
 protected:
   void init_filters_();
+  void publish_state_block_();
+
+  // wakes waiting threads, only locks if there are any, so the FRI thread is not blocked otherwise
+  void notify_();
+  template <typename Predicate>
+  bool wait_(const Predicate &predicate, const std::chrono::milliseconds &timeout) {
+    std::unique_lock<std::mutex> lock(notify_mutex_);
+    ++waiters_;
+    const bool satisfied = notify_cv_.wait_for(lock, timeout, predicate);
+    --waiters_;
+    return satisfied;
+  }
 
   std::atomic_bool state_initialized_;
+  std::atomic_int session_state_, control_mode_, client_command_mode_;
+  std::atomic<double> sample_time_;
+  std::atomic_uint32_t waiters_;
+  std::mutex notify_mutex_;
+  std::condition_variable notify_cv_;
   idl_state_t state_;
+  uint64_t sequence_;
+  TripleBuffer<StateBlock> state_blocks_;
   StateInterfaceParameters parameters_;
   JointExponentialFilterArray external_torque_filter_, measured_torque_filter_;
 };
@@ -0,0 +1,114 @@
+#ifndef LBR_FRI_ROS2__KINEMATICS_CACHE_HPP_
+#define LBR_FRI_ROS2__KINEMATICS_CACHE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "eigen3/Eigen/Core"
+#include "kdl/chain.hpp"
+#include "kdl/frames.hpp"
+#include "kdl/jacobian.hpp"
+#include "kdl/jntarray.hpp"
+#include "kdl/tree.hpp"
+#include "kdl_parser/kdl_parser.hpp"
+#include "rclcpp/logger.hpp"
+#include "rclcpp/logging.hpp"
+#include "urdf/model.h"
+
+#include "friLBRState.h"
+
+#include "lbr_fri_idl/msg/lbr_state.hpp"
+
+namespace lbr_fri_ros2 {
+class KinematicsCache {
+protected:
+  static constexpr char LOGGER_NAME[] = "lbr_fri_ros2::KinematicsCache";
+  using jnt_pos_array_t = lbr_fri_idl::msg::LBRState::_measured_joint_position_type;
+  using const_jnt_pos_array_t_ref = const jnt_pos_array_t &;
+
+public:
+  /**
+   * @brief Construct a new Kinematics Cache object. Evaluates the forward kinematics of all
+   * segments and the chain tip Jacobian in a single pass over the chain, so that every consumer,
+   * e.g. the FTEstimator, shares one evaluation per state sample.
+   *
+   * @param[in] robot_description The URDF robot description.
+   * @param[in] chain_root The root link of the chain.
+   * @param[in] chain_tip The tip link of the chain.
+   */
+  KinematicsCache(const std::string &robot_description, const std::string &chain_root = "link_0",
+                  const std::string &chain_tip = "link_ee");
+
+  /**
+   * @brief Evaluate the kinematics for the given joint position. Skipped if the state with
+   * sequence number sequence was already evaluated.
+   *
+   * @param[in] joint_position The joint position.
+   * @param[in] sequence The sequence number of the state sample joint_position belongs to.
+   * @return true if the kinematics were evaluated.
+   * @return false if the cached kinematics were already up to date.
+   */
+  bool update(const_jnt_pos_array_t_ref joint_position, const uint64_t &sequence);
+
+  /**
+   * @brief Evaluate the kinematics for the given joint position unconditionally. Invalidates the
+   * sequence number.
+   *
+   * @param[in] joint_position The joint position.
+   */
+  void update(const_jnt_pos_array_t_ref joint_position);
+
+  void reset();
+
+  inline const std::string &get_robot_name() const { return robot_name_; };
+  inline const KDL::Tree &get_tree() const { return tree_; };
+  inline const KDL::Chain &get_chain() const { return chain_; };
+  inline const std::string &get_chain_root() const { return chain_root_; };
+  inline const std::string &get_chain_tip() const { return chain_tip_; };
+
+  inline const KDL::JntArray &get_joint_position() const { return q_; };
+
+  /**
+   * @brief Get the frames of all segment tips with respect to the chain root.
+   *
+   * @return const std::vector<KDL::Frame>& Frames, indexed like the chain segments.
+   */
+  inline const std::vector<KDL::Frame> &get_frames() const { return frames_; };
+  inline const KDL::Frame &get_tip_frame() const { return frames_.back(); };
+
+  /**
+   * @brief Get the chain tip Jacobian, reference point chain tip, expressed in the chain root.
+   *
+   * @return const KDL::Jacobian&
+   */
+  inline const KDL::Jacobian &get_jacobian() const { return jacobian_; };
+
+  inline const uint64_t &get_sequence() const { return sequence_; };
+  inline const bool &is_sequence_valid() const { return sequence_valid_; };
+
+protected:
+  void compute_();
+
+  std::string robot_name_, chain_root_, chain_tip_;
+
+  KDL::Tree tree_;
+  KDL::Chain chain_;
+
+  // cache key
+  uint64_t sequence_;
+  bool sequence_valid_;
+
+  // robot state
+  KDL::JntArray q_;
+
+  // forward kinematics and Jacobian
+  std::vector<KDL::Frame> frames_;
+  std::array<KDL::Twist, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> joint_twists_;
+  std::array<KDL::Vector, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> joint_twist_ref_points_;
+  KDL::Jacobian jacobian_;
+};
+} // namespace lbr_fri_ros2
+#endif // LBR_FRI_ROS2__KINEMATICS_CACHE_HPP_
@@ -0,0 +1,107 @@
+#ifndef LBR_FRI_ROS2__PAYLOAD_IDENTIFIER_HPP_
+#define LBR_FRI_ROS2__PAYLOAD_IDENTIFIER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/QR"
+#include "rclcpp/logger.hpp"
+#include "rclcpp/logging.hpp"
+
+#include "friLBRState.h"
+
+#include "lbr_fri_idl/msg/lbr_state.hpp"
+#include "lbr_fri_ros2/kinematics_cache.hpp"
+
+namespace lbr_fri_ros2 {
+struct Payload {
+  double mass{0.0};                               // payload mass [kg]
+  std::array<double, 3> center_of_mass{0., 0., 0.}; // center of mass in chain tip frame [m]
+};
+
+class PayloadIdentifier {
+protected:
+  static constexpr char LOGGER_NAME[] = "lbr_fri_ros2::PayloadIdentifier";
+  static constexpr uint8_t PARAMETERS = 4; // mass, mass * center of mass
+  static constexpr std::size_t MAX_POSES = 16;
+  static constexpr double RANK_THRESHOLD = 1.e-9; // relative to the largest pivot
+  using ext_tau_array_t = lbr_fri_idl::msg::LBRState::_external_torque_type;
+  using const_ext_tau_array_t_ref = const ext_tau_array_t &;
+
+public:
+  using gravity_t = std::array<double, 3>;
+  using const_gravity_t_ref = const gravity_t &;
+
+  /**
+   * @brief Construct a new Payload Identifier object. Identifies mass and center of mass of a
+   * payload at the chain tip from the external joint torque of standstill samples. The
+   * external torque is modelled as tau_ext = J^T A(R) theta, with theta = [m, m*c], which is
+   * linear in theta and solved in the least squares sense. The center of mass along gravity is
+   * unobservable in a single pose, so samples are required in at least min_poses distinct poses,
+   * i.e. with gravity differently oriented in the chain tip frame.
+   *
+   * @param[in] kinematics_cache_ptr Kinematics, evaluated at the sample's joint position.
+   * @param[in] gravity Gravity vector in the chain root frame.
+   * @param[in] min_poses Minimum number of distinct poses, at least 2.
+   * @param[in] min_pose_angle Minimum angle between gravity in the chain tip frame of distinct
+   * poses [rad].
+   */
+  PayloadIdentifier(const std::shared_ptr<KinematicsCache> kinematics_cache_ptr,
+                    const_gravity_t_ref gravity = {0., 0., -9.81},
+                    const std::size_t &min_poses = 2, const double &min_pose_angle = 0.2);
+
+  /**
+   * @brief Add a standstill sample. The kinematics cache has to be evaluated at the sample's
+   * joint position. Does not allocate.
+   *
+   * @param[in] external_torque The external joint torque at standstill.
+   */
+  void add_sample(const_ext_tau_array_t_ref external_torque);
+
+  /**
+   * @brief Solve for the payload from all samples added since the last reset.
+   *
+   * @param[out] payload The identified payload, unchanged if not identifiable.
+   * @return true if the payload is fully identifiable from the samples.
+   * @return false if the samples are insufficient, e.g. taken in less than min_poses distinct
+   * poses, or the regressor is rank-deficient.
+   */
+  bool identify(Payload &payload);
+  void reset();
+
+  inline const std::size_t &get_number_of_samples() const { return number_of_samples_; };
+  inline const std::size_t &get_number_of_poses() const { return number_of_poses_; };
+
+  static bool save(const std::string &file_name, const Payload &payload);
+  static bool load(const std::string &file_name, Payload &payload);
+
+protected:
+  std::shared_ptr<KinematicsCache> kinematics_cache_ptr_;
+  Eigen::Vector3d gravity_;
+  std::size_t min_poses_;
+  double max_pose_cos_;
+
+  // gravity direction in the chain tip frame, per distinct pose
+  std::size_t number_of_poses_;
+  std::array<Eigen::Vector3d, MAX_POSES> poses_;
+
+  // normal equations
+  std::size_t number_of_samples_;
+  Eigen::Matrix<double, PARAMETERS, PARAMETERS> ata_;
+  Eigen::Matrix<double, PARAMETERS, 1> atb_;
+
+  // regressor
+  Eigen::Matrix<double, 6, PARAMETERS> wrench_regressor_;
+  Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, PARAMETERS> regressor_;
+};
+} // namespace lbr_fri_ros2
+#endif // LBR_FRI_ROS2__PAYLOAD_IDENTIFIER_HPP_
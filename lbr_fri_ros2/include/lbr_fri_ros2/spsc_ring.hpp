@@ -0,0 +1,77 @@
+#ifndef LBR_FRI_ROS2__SPSC_RING_HPP_
+#define LBR_FRI_ROS2__SPSC_RING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace lbr_fri_ros2 {
+/**
+ * @brief Lock-free single producer, single consumer ring buffer. Unlike the TripleBuffer, every
+ * pushed element is delivered, as long as the consumer keeps up on average. Storage is allocated
+ * by reset only, so that push and pop never allocate.
+ *
+ * @tparam T Element type, should be statically sized.
+ */
+template <class T> class SPSCRing {
+public:
+  explicit SPSCRing(const std::size_t &capacity = 0) { reset(capacity); }
+
+  /**
+   * @brief Neither producer nor consumer may be active. Clear and resize.
+   *
+   */
+  void reset(const std::size_t &capacity) {
+    buffer_.resize(capacity + 1); // one slot distinguishes full from empty
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Producer only. Copy an element into the ring.
+   *
+   * @return false if the ring is full, the element is dropped.
+   */
+  inline bool push(const T &value) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t next = increment_(head);
+    if (next == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    buffer_[head] = value;
+    head_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Consumer only. Copy the oldest element out of the ring.
+   *
+   * @return false if the ring is empty.
+   */
+  inline bool pop(T &value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    value = buffer_[tail];
+    tail_.store(increment_(tail), std::memory_order_release);
+    return true;
+  }
+
+  inline std::size_t size() const {
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    return head >= tail ? head - tail : head + buffer_.size() - tail;
+  }
+  inline std::size_t capacity() const { return buffer_.size() - 1; }
+
+protected:
+  inline std::size_t increment_(const std::size_t &index) const {
+    return index + 1 == buffer_.size() ? 0 : index + 1;
+  }
+
+  std::vector<T> buffer_;
+  std::atomic<std::size_t> head_{0}, tail_{0};
+};
+} // namespace lbr_fri_ros2
+#endif // LBR_FRI_ROS2__SPSC_RING_HPP_
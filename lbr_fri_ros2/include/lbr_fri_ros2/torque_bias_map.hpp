@@ -0,0 +1,142 @@
+#ifndef LBR_FRI_ROS2__TORQUE_BIAS_MAP_HPP_
+#define LBR_FRI_ROS2__TORQUE_BIAS_MAP_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rclcpp/logger.hpp"
+#include "rclcpp/logging.hpp"
+
+#include "friLBRState.h"
+
+#include "lbr_fri_idl/msg/lbr_state.hpp"
+
+namespace lbr_fri_ros2 {
+class TorqueBiasMap {
+protected:
+  static constexpr char LOGGER_NAME[] = "lbr_fri_ros2::TorqueBiasMap";
+  using jnt_pos_array_t = lbr_fri_idl::msg::LBRState::_measured_joint_position_type;
+  using const_jnt_pos_array_t_ref = const jnt_pos_array_t &;
+  using ext_tau_array_t = lbr_fri_idl::msg::LBRState::_external_torque_type;
+  using const_ext_tau_array_t_ref = const ext_tau_array_t &;
+  using ext_tau_array_t_ref = ext_tau_array_t &;
+
+public:
+  static constexpr uint8_t MAX_GRID_JOINTS = 4;
+  static constexpr std::size_t MAX_NAME_LENGTH = 64; // including the terminating null
+  static constexpr std::size_t NODE_SIZE =
+      KUKA::FRI::LBRState::NUMBER_OF_JOINTS + 1; // calibration weight, bias
+
+  struct Header {
+    char magic[8];
+    char robot_name[MAX_NAME_LENGTH]; // robot model, as in the URDF
+    char chain_root[MAX_NAME_LENGTH];
+    char chain_tip[MAX_NAME_LENGTH];
+    uint32_t joints;
+    uint32_t grid_joints;
+    uint32_t grid_joint_indices[MAX_GRID_JOINTS];
+    uint32_t nodes[MAX_GRID_JOINTS];
+    double min[MAX_GRID_JOINTS];
+    double max[MAX_GRID_JOINTS];
+  };
+
+  /**
+   * @brief Construct an empty Torque Bias Map for calibration. The external torque bias is
+   * sampled over a regular grid that spans the given joints. The remaining joints are assumed
+   * not to affect the bias. The map is bound to the robot model and chain it is calibrated on.
+   *
+   * @param[in] grid_joint_indices Joints that span the grid, at most MAX_GRID_JOINTS.
+   * @param[in] min Lower grid bound per grid joint [rad].
+   * @param[in] max Upper grid bound per grid joint [rad].
+   * @param[in] resolution Grid spacing [rad].
+   * @param[in] robot_name The robot model, e.g. iiwa7.
+   * @param[in] chain_root The root link of the chain.
+   * @param[in] chain_tip The tip link of the chain.
+   */
+  TorqueBiasMap(const std::vector<uint32_t> &grid_joint_indices, const std::vector<double> &min,
+                const std::vector<double> &max, const double &resolution,
+                const std::string &robot_name, const std::string &chain_root,
+                const std::string &chain_tip);
+
+  /**
+   * @brief Construct a Torque Bias Map by memory-mapping a calibrated table from file. The table
+   * is pre-faulted and locked into memory, so that interpolate() does not page fault.
+   *
+   * @param[in] file_name The file, as written by save().
+   * @param[in] robot_name The expected robot model.
+   * @param[in] chain_root The expected root link of the chain.
+   * @param[in] chain_tip The expected tip link of the chain.
+   * @throws std::runtime_error If the file is invalid or calibrated on a different robot model
+   * or chain.
+   */
+  TorqueBiasMap(const std::string &file_name, const std::string &robot_name,
+                const std::string &chain_root, const std::string &chain_tip);
+  ~TorqueBiasMap();
+
+  TorqueBiasMap(const TorqueBiasMap &) = delete;
+  TorqueBiasMap &operator=(const TorqueBiasMap &) = delete;
+
+  /**
+   * @brief Accumulate a calibration sample onto the surrounding grid nodes. Does not allocate.
+   *
+   * @param[in] joint_position The joint position.
+   * @param[in] external_torque The external torque, assumed to be bias only.
+   */
+  void add_sample(const_jnt_pos_array_t_ref joint_position,
+                  const_ext_tau_array_t_ref external_torque);
+
+  /**
+   * @brief Interpolate the bias multilinearly from the surrounding visited grid nodes, i.e.
+   * nodes that received calibration samples. Zero if none of them was visited. Constant time and
+   * allocation free. Joint positions outside the grid are clamped.
+   *
+   * @param[in] joint_position The joint position.
+   * @param[out] bias The interpolated external torque bias.
+   */
+  void interpolate(const_jnt_pos_array_t_ref joint_position, ext_tau_array_t_ref bias) const;
+
+  bool save(const std::string &file_name) const;
+
+  /**
+   * @brief Fraction of grid nodes that received calibration samples.
+   *
+   */
+  double get_coverage() const;
+  inline const Header &get_header() const { return header_; };
+
+protected:
+  void init_strides_();
+  bool matches_(const std::string &robot_name, const std::string &chain_root,
+                const std::string &chain_tip) const;
+  void corners_(const_jnt_pos_array_t_ref joint_position,
+                std::array<uint32_t, MAX_GRID_JOINTS> &index,
+                std::array<double, MAX_GRID_JOINTS> &fraction) const;
+
+  Header header_;
+  std::size_t number_of_nodes_;
+  std::array<std::size_t, MAX_GRID_JOINTS> strides_;
+
+  // calibration, owned
+  std::vector<double> bias_sums_;
+  std::vector<double> weights_;
+
+  // calibrated, memory-mapped, NODE_SIZE values per node
+  void *mapped_data_;
+  std::size_t mapped_size_;
+  bool locked_;
+  const double *nodes_;
+};
+} // namespace lbr_fri_ros2
+#endif // LBR_FRI_ROS2__TORQUE_BIAS_MAP_HPP_
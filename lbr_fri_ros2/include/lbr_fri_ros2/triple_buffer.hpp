@@ -0,0 +1,64 @@
+#ifndef LBR_FRI_ROS2__TRIPLE_BUFFER_HPP_
+#define LBR_FRI_ROS2__TRIPLE_BUFFER_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace lbr_fri_ros2 {
+/**
+ * @brief Lock-free single producer, single consumer triple buffer. The producer writes into the
+ * back buffer and publishes it by exchanging it with the middle buffer. The consumer acquires the
+ * latest published buffer by exchanging the middle buffer with the front buffer. Neither side
+ * ever blocks and the consumer always sees a complete buffer.
+ *
+ * @tparam T Buffer type, should be statically sized.
+ */
+template <class T> class TripleBuffer {
+protected:
+  static constexpr uint8_t INDEX_MASK = 0x3;
+  static constexpr uint8_t FRESH = 0x4;
+
+public:
+  TripleBuffer() : middle_(1), back_(0), front_(2) {}
+
+  /**
+   * @brief Producer only. Buffer to write into before calling publish.
+   *
+   */
+  inline T &back() { return buffers_[back_]; }
+
+  /**
+   * @brief Producer only. Publish the back buffer.
+   *
+   */
+  inline void publish() {
+    back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+  }
+
+  /**
+   * @brief Consumer only. Acquire the latest published buffer, if any.
+   *
+   * @return true if a new buffer was published since the last acquire.
+   */
+  inline bool acquire() {
+    if (!(middle_.load(std::memory_order_relaxed) & FRESH)) {
+      return false;
+    }
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX_MASK;
+    return true;
+  }
+
+  /**
+   * @brief Consumer only. Buffer acquired by the last call to acquire.
+   *
+   */
+  inline const T &front() const { return buffers_[front_]; }
+
+protected:
+  std::array<T, 3> buffers_;
+  std::atomic<uint8_t> middle_;
+  uint8_t back_, front_;
+};
+} // namespace lbr_fri_ros2
+#endif // LBR_FRI_ROS2__TRIPLE_BUFFER_HPP_
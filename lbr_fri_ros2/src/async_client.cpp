@@ -6,8 +6,8 @@ AsyncClient::AsyncClient(const KUKA::FRI::EClientCommandMode &client_command_mod
                          const CommandGuardParameters &command_guard_parameters,
                          const std::string &command_guard_variant,
                          const StateInterfaceParameters &state_interface_parameters,
-                         const bool &open_loop)
-    : open_loop_(open_loop) {
+                         const bool &open_loop, const bool &cycle_sync)
+    : open_loop_(open_loop), cycle_sync_(cycle_sync) {
   RCLCPP_INFO_STREAM(rclcpp::get_logger(LOGGER_NAME),
                      ColorScheme::OKBLUE << "Configuring client" << ColorScheme::ENDC);
 
@@ -50,6 +50,9 @@ AsyncClient::AsyncClient(const KUKA::FRI::EClientCommandMode &client_command_mod
   state_interface_ptr_->log_info();
   RCLCPP_INFO_STREAM(rclcpp::get_logger(LOGGER_NAME),
                      "Open loop '" << (open_loop_ ? "true" : "false") << "'");
+  RCLCPP_INFO_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                     "Cycle sync '" << (cycle_sync_ ? "true" : "false") << "'");
+  CycleSync::instance().enable(cycle_sync_);
   RCLCPP_INFO_STREAM(rclcpp::get_logger(LOGGER_NAME),
                      ColorScheme::OKGREEN << "Client configured" << ColorScheme::ENDC);
 }
@@ -69,11 +72,15 @@ void AsyncClient::onStateChange(KUKA::FRI::ESessionState old_state,
   command_interface_ptr_->init_command(state_interface_ptr_->get_state());
 }
 
-void AsyncClient::monitor() { state_interface_ptr_->set_state(robotState()); };
+void AsyncClient::monitor() {
+  state_interface_ptr_->set_state(robotState());
+  sync_state_();
+};
 
 void AsyncClient::waitForCommand() {
   KUKA::FRI::LBRClient::waitForCommand();
   state_interface_ptr_->set_state(robotState());
+  sync_state_();
   command_interface_ptr_->init_command(state_interface_ptr_->get_state());
   command_interface_ptr_->buffered_command_to_fri(robotCommand(),
                                                   state_interface_ptr_->get_state());
@@ -86,9 +93,36 @@ void AsyncClient::command() {
   } else {
     state_interface_ptr_->set_state(robotState());
   }
+  sync_state_();
+  sync_command_();
   command_interface_ptr_->buffered_command_to_fri(
       robotCommand(),
       state_interface_ptr_->get_state()); // current state accessed via state interface (allows for
                                           // open loop and is statically sized)
 }
+
+void AsyncClient::sync_state_() {
+  if (!cycle_sync_) {
+    return;
+  }
+  CycleSync::instance().notify_state(
+      std::chrono::seconds(robotState().getTimestampSec()) +
+      std::chrono::nanoseconds(robotState().getTimestampNanoSec()));
+}
+
+void AsyncClient::sync_command_() {
+  if (!cycle_sync_) {
+    return;
+  }
+  // the previously buffered command is used on timeout, as in asynchronous control
+  if (!CycleSync::instance().wait_for_command(std::chrono::nanoseconds(static_cast<int64_t>(
+          CYCLE_SYNC_TIMEOUT_RATIO * robotState().getSampleTime() * 1.e9)))) {
+    RCLCPP_WARN_STREAM_THROTTLE(rclcpp::get_logger(LOGGER_NAME), steady_clock_, 1000,
+                                ColorScheme::WARNING
+                                    << "Command missed the FRI cycle, "
+                                    << CycleSync::instance().get_missed_cycles()
+                                    << " cycles missed in total. Is lbr_ros2_control_node running?"
+                                    << ColorScheme::ENDC);
+  }
+}
 } // namespace lbr_fri_ros2
@@ -0,0 +1,86 @@
+#include "lbr_fri_ros2/cycle_sync.hpp"
+
+namespace lbr_fri_ros2 {
+CycleSync::CycleSync()
+    : enabled_(false), emulated_clock_(false), state_cycle_(0), handled_cycle_(0),
+      command_cycle_(0), state_stamp_(0), handled_stamp_(0), missed_cycles_(0) {
+  pthread_mutexattr_t mutex_attr;
+  pthread_mutexattr_init(&mutex_attr);
+  pthread_mutexattr_setprotocol(&mutex_attr, PTHREAD_PRIO_INHERIT);
+  pthread_mutex_init(&mutex_, &mutex_attr);
+  pthread_mutexattr_destroy(&mutex_attr);
+
+  // deadlines are given in std::chrono::steady_clock, i.e. CLOCK_MONOTONIC
+  pthread_condattr_t cond_attr;
+  pthread_condattr_init(&cond_attr);
+  pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&state_cond_, &cond_attr);
+  pthread_cond_init(&command_cond_, &cond_attr);
+  pthread_condattr_destroy(&cond_attr);
+}
+
+CycleSync::~CycleSync() {
+  pthread_cond_destroy(&command_cond_);
+  pthread_cond_destroy(&state_cond_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+CycleSync &CycleSync::instance() {
+  static CycleSync cycle_sync;
+  return cycle_sync;
+}
+
+void CycleSync::notify_state(const std::chrono::nanoseconds &stamp) {
+  pthread_mutex_lock(&mutex_);
+  ++state_cycle_;
+  state_stamp_ = stamp;
+  pthread_mutex_unlock(&mutex_);
+  pthread_cond_signal(&state_cond_);
+}
+
+bool CycleSync::wait_for_command(const std::chrono::nanoseconds &timeout) {
+  pthread_mutex_lock(&mutex_);
+  const bool commanded = wait_until_(command_cond_, clock_t::now() + timeout,
+                                     [this]() { return command_cycle_ == state_cycle_; });
+  pthread_mutex_unlock(&mutex_);
+  if (!commanded) {
+    ++missed_cycles_;
+  }
+  return commanded;
+}
+
+bool CycleSync::wait_for_state_until(const clock_t::time_point &deadline) {
+  pthread_mutex_lock(&mutex_);
+  const bool state =
+      wait_until_(state_cond_, deadline, [this]() { return state_cycle_ != handled_cycle_; });
+  if (state) {
+    handled_cycle_ = state_cycle_; // states missed in between are skipped
+    handled_stamp_ = state_stamp_;
+  }
+  pthread_mutex_unlock(&mutex_);
+  return state;
+}
+
+void CycleSync::notify_command() {
+  pthread_mutex_lock(&mutex_);
+  command_cycle_ = handled_cycle_;
+  pthread_mutex_unlock(&mutex_);
+  pthread_cond_signal(&command_cond_);
+}
+
+bool CycleSync::wait_until_(pthread_cond_t &condition, const clock_t::time_point &deadline,
+                            const std::function<bool()> &predicate) {
+  const auto since_epoch = deadline.time_since_epoch();
+  const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+  timespec deadline_ts;
+  deadline_ts.tv_sec = seconds.count();
+  deadline_ts.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - seconds)
+                            .count();
+  while (!predicate()) {
+    if (pthread_cond_timedwait(&condition, &mutex_, &deadline_ts) != 0) {
+      return predicate(); // timed out
+    }
+  }
+  return true;
+}
+} // namespace lbr_fri_ros2
@@ -0,0 +1,132 @@
+#include "lbr_fri_ros2/dynamics_simulator.hpp"
+
+namespace lbr_fri_ros2 {
+DynamicsSimulator::DynamicsSimulator(const KDL::Chain &chain,
+                                     const DynamicsSimulatorParameters &parameters)
+    : parameters_(parameters), chain_(chain),
+      dyn_param_(chain_, KDL::Vector(parameters.gravity[0], parameters.gravity[1],
+                                     parameters.gravity[2])),
+      jacobian_solver_(chain_), fk_solver_(chain_) {
+  if (chain_.getNrOfJoints() != N) {
+    std::string err = "Expected " + std::to_string(N) + " joints in chain, got " +
+                      std::to_string(chain_.getNrOfJoints()) + ".";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  if (parameters_.time_step <= 0.) {
+    std::string err = "Expected positive time step.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  for (std::size_t i = 0; i < N; ++i) {
+    if (parameters_.stiffness[i] < 0. || parameters_.damping[i] < 0. ||
+        parameters_.friction[i] < 0.) {
+      std::string err = "Expected non-negative stiffness, damping and friction.";
+      RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+      throw std::runtime_error(err);
+    }
+  }
+  q_.resize(N);
+  qd_.resize(N);
+  coriolis_.resize(N);
+  gravity_.resize(N);
+  mass_.resize(N);
+  jacobian_.resize(N);
+  stiffness_ = Eigen::Map<const vector_t>(parameters_.stiffness.data());
+  damping_ = Eigen::Map<const vector_t>(parameters_.damping.data());
+  friction_ = Eigen::Map<const vector_t>(parameters_.friction.data());
+
+  jnt_array_t zero;
+  zero.fill(0.);
+  reset(zero);
+}
+
+void DynamicsSimulator::reset(const_jnt_array_t_ref joint_position) {
+  joint_position_ = joint_position;
+  joint_velocity_.fill(0.);
+
+  // at rest, the controller only compensates gravity
+  q_.data = Eigen::Map<const vector_t>(joint_position_.data());
+  dyn_param_.JntToGravity(q_, gravity_);
+  Eigen::Map<vector_t>(measured_torque_.data()) = gravity_.data;
+  external_torque_.fill(0.);
+}
+
+void DynamicsSimulator::step(const double &dt, const_jnt_array_t_ref ipo_joint_position,
+                             const_jnt_array_t_ref torque_overlay,
+                             const_wrench_array_t_ref wrench_overlay,
+                             const_jnt_array_t_ref external_torque) {
+  const vector_t ipo = Eigen::Map<const vector_t>(ipo_joint_position.data());
+  const vector_t tau_overlay = Eigen::Map<const vector_t>(torque_overlay.data());
+  const Eigen::Matrix<double, 6, 1> wrench =
+      Eigen::Map<const Eigen::Matrix<double, 6, 1>>(wrench_overlay.data());
+  const vector_t tau_ext = Eigen::Map<const vector_t>(external_torque.data());
+
+  // split into equal steps of at most time_step
+  const int steps = std::max(1, static_cast<int>(std::ceil(dt / parameters_.time_step - 1.e-9)));
+  for (int i = 0; i < steps; ++i) {
+    integrate_(dt / steps, ipo, tau_overlay, wrench, tau_ext);
+  }
+}
+
+void DynamicsSimulator::integrate_(const double &dt, const vector_t &ipo_joint_position,
+                                   const vector_t &torque_overlay,
+                                   const Eigen::Matrix<double, 6, 1> &wrench,
+                                   const vector_t &external_torque) {
+  q_.data = Eigen::Map<const vector_t>(joint_position_.data());
+  qd_.data = Eigen::Map<const vector_t>(joint_velocity_.data());
+  dyn_param_.JntToMass(q_, mass_);
+  dyn_param_.JntToCoriolis(q_, qd_, coriolis_);
+  dyn_param_.JntToGravity(q_, gravity_);
+
+  // wrench at the chain tip, expressed in the chain tip frame, to joint torques
+  vector_t tau_wrench = vector_t::Zero();
+  if (!wrench.isZero()) {
+    jacobian_solver_.JntToJac(q_, jacobian_);
+    fk_solver_.JntToCart(q_, tip_frame_);
+    const Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>> rotation(
+        tip_frame_.M.data);
+    Eigen::Matrix<double, 6, 1> root_wrench;
+    root_wrench.head<3>() = rotation * wrench.head<3>();
+    root_wrench.tail<3>() = rotation * wrench.tail<3>();
+    tau_wrench.noalias() = jacobian_.data.transpose() * root_wrench;
+  }
+
+  // M qdd + C + G = tau_motor + tau_ext - F qd, with the controller's
+  // tau_motor = K (q_ipo - q) - D qd + G + tau_overlay. Implicit in stiffness, damping and
+  // friction: (M + dt (D + F) + dt^2 K) qd' = M qd + dt (K (q_ipo - q) + tau - C)
+  const vector_t q = q_.data;
+  const vector_t qd = qd_.data;
+  system_ = mass_.data;
+  vector_t rhs;
+  rhs.noalias() = system_ * qd;
+  rhs += dt * (stiffness_.cwiseProduct(ipo_joint_position - q) + torque_overlay + tau_wrench +
+               external_torque - coriolis_.data);
+  system_.diagonal() += dt * (damping_ + friction_) + dt * dt * stiffness_;
+  llt_.compute(system_);
+  const vector_t qd_next = llt_.solve(rhs);
+  vector_t q_next = q + dt * qd_next;
+
+  // hard joint limits, the robot stops
+  vector_t qd_limited = qd_next;
+  for (std::size_t i = 0; i < N; ++i) {
+    if (q_next[i] < parameters_.min_position[i] || q_next[i] > parameters_.max_position[i]) {
+      q_next[i] =
+          std::min(std::max(q_next[i], parameters_.min_position[i]), parameters_.max_position[i]);
+      qd_limited[i] = 0.;
+    }
+  }
+  Eigen::Map<vector_t>(joint_position_.data()) = q_next;
+  Eigen::Map<vector_t>(joint_velocity_.data()) = qd_limited;
+
+  // controller torque as measured by the joint torque sensors, friction excluded
+  Eigen::Map<vector_t>(measured_torque_.data()) =
+      stiffness_.cwiseProduct(ipo_joint_position - q_next) - damping_.cwiseProduct(qd_limited) +
+      gravity_.data + torque_overlay + tau_wrench;
+
+  // as estimated by the robot, measured minus model torque, i.e. F qd - external_torque
+  Eigen::Map<vector_t>(external_torque_.data()) =
+      Eigen::Map<const vector_t>(measured_torque_.data()) -
+      mass_.data * (qd_next - qd) / dt - coriolis_.data - gravity_.data;
+}
+} // namespace lbr_fri_ros2
@@ -3,42 +3,92 @@
 namespace lbr_fri_ros2 {
 FTEstimator::FTEstimator(const std::string &robot_description, const std::string &chain_root,
                          const std::string &chain_tip, const_cart_array_t_ref f_ext_th)
-    : f_ext_th_(f_ext_th) {
-  if (!kdl_parser::treeFromString(robot_description, tree_)) {
-    std::string err = "Failed to construct kdl tree from robot description.";
-    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
-    throw std::runtime_error(err);
-  }
-  if (!tree_.getChain(chain_root, chain_tip, chain_)) {
-    std::string err = "Failed to construct kdl chain from robot description.";
+    : FTEstimator(std::make_shared<KinematicsCache>(robot_description, chain_root, chain_tip),
+                  f_ext_th) {}
+
+FTEstimator::FTEstimator(const std::shared_ptr<KinematicsCache> kinematics_cache_ptr,
+                         const_cart_array_t_ref f_ext_th)
+    : f_ext_th_(f_ext_th), kinematics_cache_ptr_(kinematics_cache_ptr) {
+  if (!kinematics_cache_ptr_) {
+    std::string err = "Uninitialized kinematics cache.";
     RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
     throw std::runtime_error(err);
   }
-  jacobian_solver_ = std::make_unique<KDL::ChainJntToJacSolver>(chain_);
-  fk_solver_ = std::make_unique<KDL::ChainFkSolverPos_recursive>(chain_);
-  jacobian_.resize(KUKA::FRI::LBRState::NUMBER_OF_JOINTS);
-  q_.resize(KUKA::FRI::LBRState::NUMBER_OF_JOINTS);
-
+  set_payload(Payload());
   reset();
 }
 
 void FTEstimator::compute(const_jnt_pos_array_t_ref measured_joint_position,
                           const_ext_tau_array_t_ref external_torque, cart_array_t_ref f_ext,
                           const double &damping) {
-  q_.data = Eigen::Map<const Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, 1>>(
-      measured_joint_position.data());
+  kinematics_cache_ptr_->update(measured_joint_position);
+  compute(external_torque, f_ext, damping);
+}
+
+void FTEstimator::compute(const_ext_tau_array_t_ref external_torque, cart_array_t_ref f_ext,
+                          const double &damping) {
+  estimate(external_torque, damping);
+  get_f_ext(0, f_ext);
+}
+
+void FTEstimator::estimate(const_ext_tau_array_t_ref external_torque, const double &damping) {
   tau_ext_ = Eigen::Map<const Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, 1>>(
       external_torque.data());
-  jacobian_solver_->JntToJac(q_, jacobian_);
-  jacobian_inv_ = pinv(jacobian_.data, damping);
-  f_ext_ = jacobian_inv_.transpose() * tau_ext_;
+
+  // remove configuration-dependent bias
+  if (torque_bias_map_ptr_) {
+    Eigen::Map<Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, 1>>(
+        joint_position_.data()) = kinematics_cache_ptr_->get_joint_position().data;
+    torque_bias_map_ptr_->interpolate(joint_position_, tau_bias_);
+    tau_ext_ -= Eigen::Map<Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, 1>>(
+        tau_bias_.data());
+  }
+
+  // damped pseudo-inverse, singular values are re-used for the confidence
+  jacobian_ = kinematics_cache_ptr_->get_jacobian().data;
+  jacobian_svd_.compute(jacobian_, Eigen::ComputeFullU | Eigen::ComputeFullV);
+  const auto &singular_values = jacobian_svd_.singularValues();
+  damped_singular_values_inv_.setZero();
+  for (int i = 0; i < singular_values.size(); ++i) {
+    damped_singular_values_inv_(i, i) =
+        singular_values(i) / (singular_values(i) * singular_values(i) + damping * damping);
+  }
+  jacobian_inv_.noalias() =
+      jacobian_svd_.matrixV() * damped_singular_values_inv_ * jacobian_svd_.matrixU().transpose();
+  f_ext_.noalias() = jacobian_inv_.transpose() * tau_ext_;
+
+  // confidence
+  sigma_min_ = singular_values(singular_values.size() - 1);
+  manipulability_ = singular_values.prod();
+  damping_factor_ = damping * damping / (sigma_min_ * sigma_min_ + damping * damping);
 
   // rotate into chain tip frame
-  fk_solver_->JntToCart(q_, chain_tip_frame_);
-  f_ext_.topRows(3) = Eigen::Matrix3d::Map(chain_tip_frame_.M.data) * f_ext_.topRows(3);
-  f_ext_.bottomRows(3) = Eigen::Matrix3d::Map(chain_tip_frame_.M.data) * f_ext_.bottomRows(3);
+  const KDL::Frame &chain_tip_frame = kinematics_cache_ptr_->get_tip_frame();
+  f_ext_.topRows(3) = Eigen::Matrix3d::Map(chain_tip_frame.M.data) * f_ext_.topRows(3);
+  f_ext_.bottomRows(3) = Eigen::Matrix3d::Map(chain_tip_frame.M.data) * f_ext_.bottomRows(3);
 
-  Eigen::Map<Eigen::Matrix<double, CARTESIAN_DOF, 1>>(f_ext.data()) = f_ext_;
+  // remove payload wrench, expressed in chain tip frame
+  gravity_tip_ = Eigen::Matrix3d::Map(chain_tip_frame.M.data) * gravity_;
+  f_ext_.topRows(3) -= payload_.mass * gravity_tip_;
+  f_ext_.bottomRows(3) -= payload_mass_com_.cross(gravity_tip_);
+}
+
+void FTEstimator::get_f_ext(const std::size_t &frame, cart_array_t_ref f_ext) const {
+  const KDL::Wrench chain_tip_wrench(KDL::Vector(f_ext_(0), f_ext_(1), f_ext_(2)),
+                                     KDL::Vector(f_ext_(3), f_ext_(4), f_ext_(5)));
+  KDL::Wrench wrench;
+  if (frame == 0) {
+    wrench = chain_tip_wrench;
+  } else if (frames_[frame - 1].chain_root_attached) {
+    wrench = frames_[frame - 1].frame_to_reference *
+             (kinematics_cache_ptr_->get_tip_frame() * chain_tip_wrench);
+  } else {
+    wrench = frames_[frame - 1].frame_to_reference * chain_tip_wrench;
+  }
+  for (std::size_t i = 0; i < 3; ++i) {
+    f_ext[i] = wrench.force(i);
+    f_ext[i + 3] = wrench.torque(i);
+  }
 
   // threshold force-torque
   std::transform(f_ext.begin(), f_ext.end(), f_ext_th_.begin(), f_ext.begin(),
@@ -51,9 +101,55 @@ void FTEstimator::compute(const_jnt_pos_array_t_ref measured_joint_position,
                  });
 }
 
+std::size_t FTEstimator::add_frame(const std::string &frame) {
+  if (frame == kinematics_cache_ptr_->get_chain_tip()) {
+    return 0;
+  }
+  for (std::size_t i = 0; i < frames_.size(); ++i) {
+    if (frames_[i].name == frame) {
+      return i + 1;
+    }
+  }
+
+  // resolve the rigid offset once, frames may only be attached through fixed joints
+  EstimationFrame estimation_frame;
+  estimation_frame.name = frame;
+  KDL::Chain chain;
+  const KDL::Tree &tree = kinematics_cache_ptr_->get_tree();
+  if (tree.getChain(kinematics_cache_ptr_->get_chain_tip(), frame, chain) &&
+      chain.getNrOfJoints() == 0) {
+    estimation_frame.chain_root_attached = false;
+  } else if (tree.getChain(kinematics_cache_ptr_->get_chain_root(), frame, chain) &&
+             chain.getNrOfJoints() == 0) {
+    estimation_frame.chain_root_attached = true;
+  } else {
+    std::string err = "Frame '" + frame + "' is not rigidly attached to '" +
+                      kinematics_cache_ptr_->get_chain_tip() + "' or '" +
+                      kinematics_cache_ptr_->get_chain_root() + "'.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  KDL::Frame offset = KDL::Frame::Identity();
+  for (unsigned int i = 0; i < chain.getNrOfSegments(); ++i) {
+    offset = offset * chain.getSegment(i).pose(0.0);
+  }
+  estimation_frame.frame_to_reference = offset.Inverse();
+  frames_.push_back(estimation_frame);
+  return frames_.size();
+}
+
+void FTEstimator::set_payload(const Payload &payload,
+                              PayloadIdentifier::const_gravity_t_ref gravity) {
+  payload_ = payload;
+  gravity_ = Eigen::Vector3d::Map(gravity.data());
+  payload_mass_com_ = payload_.mass * Eigen::Vector3d::Map(payload_.center_of_mass.data());
+}
+
 void FTEstimator::reset() {
-  q_.data.setZero();
   tau_ext_.setZero();
   f_ext_.setZero();
+  sigma_min_ = 0.;
+  manipulability_ = 0.;
+  damping_factor_ = 1.;
 }
 } // namespace lbr_fri_ros2
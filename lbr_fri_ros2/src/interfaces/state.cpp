@@ -1,8 +1,27 @@
 #include "lbr_fri_ros2/interfaces/state.hpp"
 
 namespace lbr_fri_ros2 {
+void StateBlock::assign(const lbr_fri_idl::msg::LBRState &sample,
+                        const uint64_t &sample_sequence) {
+  state = sample;
+  session_state = static_cast<double>(sample.session_state);
+  connection_quality = static_cast<double>(sample.connection_quality);
+  safety_state = static_cast<double>(sample.safety_state);
+  operation_mode = static_cast<double>(sample.operation_mode);
+  drive_state = static_cast<double>(sample.drive_state);
+  client_command_mode = static_cast<double>(sample.client_command_mode);
+  overlay_type = static_cast<double>(sample.overlay_type);
+  control_mode = static_cast<double>(sample.control_mode);
+  time_stamp_sec = static_cast<double>(sample.time_stamp_sec);
+  time_stamp_nano_sec = static_cast<double>(sample.time_stamp_nano_sec);
+  sequence = sample_sequence;
+}
+
 StateInterface::StateInterface(const StateInterfaceParameters &state_interface_parameters)
-    : state_initialized_(false), parameters_(state_interface_parameters) {}
+    : state_initialized_(false), session_state_(fri_session_state_t::IDLE),
+      control_mode_(KUKA::FRI::EControlMode::POSITION_CONTROL_MODE),
+      client_command_mode_(KUKA::FRI::EClientCommandMode::NO_COMMAND_MODE), sample_time_(0.),
+      waiters_(0), sequence_(0), parameters_(state_interface_parameters) {}
 
 void StateInterface::set_state(const_fri_state_t_ref state) {
   state_.client_command_mode = state.getClientCommandMode();
@@ -37,7 +56,13 @@ void StateInterface::set_state(const_fri_state_t_ref state) {
     // initialize once state_ is available
     init_filters_();
   }
+  publish_state_block_();
+  session_state_ = state_.session_state;
+  control_mode_ = state_.control_mode;
+  client_command_mode_ = state_.client_command_mode;
+  sample_time_ = state_.sample_time;
   state_initialized_ = true;
+  notify_();
 };
 
 void StateInterface::set_state_open_loop(const_fri_state_t_ref state,
@@ -74,7 +99,42 @@ void StateInterface::set_state_open_loop(const_fri_state_t_ref state,
     // initialize once state_ is available
     init_filters_();
   }
+  publish_state_block_();
+  session_state_ = state_.session_state;
+  control_mode_ = state_.control_mode;
+  client_command_mode_ = state_.client_command_mode;
+  sample_time_ = state_.sample_time;
   state_initialized_ = true;
+  notify_();
+}
+
+void StateInterface::publish_state_block_() {
+  state_blocks_.back().assign(state_, ++sequence_);
+  state_blocks_.publish();
+}
+
+bool StateInterface::wait_for_initialized(const std::chrono::milliseconds &timeout) {
+  return wait_([this]() { return state_initialized_.load(); }, timeout);
+}
+
+bool StateInterface::wait_for_session_state(const fri_session_state_t &session_state,
+                                            const std::chrono::milliseconds &timeout) {
+  return wait_(
+      [this, &session_state]() {
+        return state_initialized_.load() && session_state_.load() >= session_state;
+      },
+      timeout);
+}
+
+void StateInterface::notify_() {
+  if (waiters_.load() == 0) {
+    return;
+  }
+  {
+    // a waiter is either before its predicate check or waiting, so no wake-up is lost
+    std::lock_guard<std::mutex> lock(notify_mutex_);
+  }
+  notify_cv_.notify_all();
 }
 
 void StateInterface::init_filters_() {
@@ -0,0 +1,86 @@
+#include "lbr_fri_ros2/kinematics_cache.hpp"
+
+namespace lbr_fri_ros2 {
+KinematicsCache::KinematicsCache(const std::string &robot_description,
+                                 const std::string &chain_root, const std::string &chain_tip)
+    : chain_root_(chain_root), chain_tip_(chain_tip), sequence_(0), sequence_valid_(false) {
+  urdf::Model model;
+  if (!model.initString(robot_description) || !kdl_parser::treeFromUrdfModel(model, tree_)) {
+    std::string err = "Failed to construct kdl tree from robot description.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  robot_name_ = model.getName();
+  if (!tree_.getChain(chain_root_, chain_tip_, chain_)) {
+    std::string err = "Failed to construct kdl chain from robot description.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  if (chain_.getNrOfJoints() != KUKA::FRI::LBRState::NUMBER_OF_JOINTS ||
+      chain_.getNrOfSegments() == 0) {
+    std::string err = "Expected " + std::to_string(KUKA::FRI::LBRState::NUMBER_OF_JOINTS) +
+                      " joints in chain from '" + chain_root_ + "' to '" + chain_tip_ + "', got " +
+                      std::to_string(chain_.getNrOfJoints()) + ".";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  q_.resize(KUKA::FRI::LBRState::NUMBER_OF_JOINTS);
+  frames_.resize(chain_.getNrOfSegments());
+  jacobian_.resize(KUKA::FRI::LBRState::NUMBER_OF_JOINTS);
+
+  reset();
+}
+
+bool KinematicsCache::update(const_jnt_pos_array_t_ref joint_position, const uint64_t &sequence) {
+  if (sequence_valid_ && sequence == sequence_) {
+    return false;
+  }
+  q_.data = Eigen::Map<const Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, 1>>(
+      joint_position.data());
+  compute_();
+  sequence_ = sequence;
+  sequence_valid_ = true;
+  return true;
+}
+
+void KinematicsCache::update(const_jnt_pos_array_t_ref joint_position) {
+  q_.data = Eigen::Map<const Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, 1>>(
+      joint_position.data());
+  compute_();
+  sequence_valid_ = false;
+}
+
+void KinematicsCache::reset() {
+  sequence_ = 0;
+  sequence_valid_ = false;
+  q_.data.setZero();
+  compute_();
+}
+
+void KinematicsCache::compute_() {
+  // single pass over the chain, refer KDL::ChainJntToJacSolver::JntToJac
+  KDL::Frame chain_root_to_segment_root = KDL::Frame::Identity();
+  unsigned int j = 0;
+  for (unsigned int i = 0; i < chain_.getNrOfSegments(); ++i) {
+    const KDL::Segment &segment = chain_.getSegment(i);
+    if (segment.getJoint().getType() != KDL::Joint::None) {
+      frames_[i] = chain_root_to_segment_root * segment.pose(q_(j));
+
+      // unit joint twist, reference point segment tip, expressed in chain root
+      joint_twists_[j] = chain_root_to_segment_root.M * segment.twist(q_(j), 1.0);
+      joint_twist_ref_points_[j] = frames_[i].p;
+      ++j;
+    } else {
+      frames_[i] = chain_root_to_segment_root * segment.pose(0.0);
+    }
+    chain_root_to_segment_root = frames_[i];
+  }
+
+  // change reference points to chain tip
+  const KDL::Vector &chain_tip_position = frames_.back().p;
+  for (j = 0; j < KUKA::FRI::LBRState::NUMBER_OF_JOINTS; ++j) {
+    jacobian_.setColumn(j,
+                        joint_twists_[j].RefPoint(chain_tip_position - joint_twist_ref_points_[j]));
+  }
+}
+} // namespace lbr_fri_ros2
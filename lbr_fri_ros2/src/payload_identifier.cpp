@@ -0,0 +1,149 @@
+#include "lbr_fri_ros2/payload_identifier.hpp"
+
+namespace lbr_fri_ros2 {
+PayloadIdentifier::PayloadIdentifier(const std::shared_ptr<KinematicsCache> kinematics_cache_ptr,
+                                     const_gravity_t_ref gravity,
+                                     const std::size_t &min_poses,
+                                     const double &min_pose_angle)
+    : kinematics_cache_ptr_(kinematics_cache_ptr), min_poses_(min_poses),
+      max_pose_cos_(std::cos(min_pose_angle)) {
+  if (!kinematics_cache_ptr_) {
+    std::string err = "Uninitialized kinematics cache.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  if (min_poses_ < 2 || min_poses_ > MAX_POSES) {
+    std::string err = "Minimum number of poses must be in [2, " + std::to_string(MAX_POSES) + "].";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  gravity_ = Eigen::Vector3d::Map(gravity.data());
+  reset();
+}
+
+void PayloadIdentifier::add_sample(const_ext_tau_array_t_ref external_torque) {
+  // chain tip rotation with respect to chain root (KDL stores rotations row-major)
+  const Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>> rotation(
+      kinematics_cache_ptr_->get_tip_frame().M.data);
+
+  // wrench at chain tip, expressed in chain root: f = m*g, tau = (R*m*c) x g = -[g]x R m*c
+  Eigen::Matrix3d gravity_skew;
+  gravity_skew << 0., -gravity_.z(), gravity_.y(), gravity_.z(), 0., -gravity_.x(), -gravity_.y(),
+      gravity_.x(), 0.;
+  wrench_regressor_.setZero();
+  wrench_regressor_.block<3, 1>(0, 0) = gravity_;
+  wrench_regressor_.block<3, 3>(3, 1) = -gravity_skew * rotation;
+
+  // new pose if gravity is differently oriented in the chain tip frame, c along gravity is
+  // unobservable in a single pose, hence -g is not distinct from g
+  const Eigen::Vector3d direction = rotation.transpose() * gravity_.normalized();
+  if (number_of_poses_ < MAX_POSES &&
+      std::none_of(poses_.cbegin(), poses_.cbegin() + number_of_poses_,
+                   [&](const Eigen::Vector3d &pose) {
+                     return std::abs(pose.dot(direction)) > max_pose_cos_;
+                   })) {
+    poses_[number_of_poses_++] = direction;
+  }
+
+  // joint torque
+  regressor_.noalias() = kinematics_cache_ptr_->get_jacobian().data.transpose() * wrench_regressor_;
+
+  ata_.noalias() += regressor_.transpose() * regressor_;
+  atb_.noalias() +=
+      regressor_.transpose() *
+      Eigen::Map<const Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, 1>>(
+          external_torque.data());
+  ++number_of_samples_;
+}
+
+bool PayloadIdentifier::identify(Payload &payload) {
+  if (number_of_samples_ == 0) {
+    RCLCPP_WARN(rclcpp::get_logger(LOGGER_NAME), "No samples for payload identification.");
+    return false;
+  }
+  if (number_of_poses_ < min_poses_) {
+    RCLCPP_WARN(rclcpp::get_logger(LOGGER_NAME),
+                "Payload not identifiable from %zu samples in %zu of %zu required distinct poses. "
+                "Add samples in differently oriented poses.",
+                number_of_samples_, number_of_poses_, min_poses_);
+    return false;
+  }
+  Eigen::CompleteOrthogonalDecomposition<Eigen::Matrix<double, PARAMETERS, PARAMETERS>> cod;
+  cod.setThreshold(RANK_THRESHOLD);
+  cod.compute(ata_);
+  if (cod.rank() < PARAMETERS) {
+    RCLCPP_WARN(rclcpp::get_logger(LOGGER_NAME),
+                "Payload not identifiable, rank-deficient regressor from %zu samples in %zu "
+                "poses. Add samples in differently oriented poses.",
+                number_of_samples_, number_of_poses_);
+    return false;
+  }
+  const Eigen::Matrix<double, PARAMETERS, 1> theta = cod.solve(atb_);
+  payload = Payload();
+  payload.mass = theta(0);
+  if (std::abs(payload.mass) > std::numeric_limits<double>::epsilon()) {
+    Eigen::Vector3d::Map(payload.center_of_mass.data()) = theta.tail<3>() / payload.mass;
+  }
+  return true;
+}
+
+void PayloadIdentifier::reset() {
+  number_of_samples_ = 0;
+  number_of_poses_ = 0;
+  ata_.setZero();
+  atb_.setZero();
+  wrench_regressor_.setZero();
+  regressor_.setZero();
+}
+
+bool PayloadIdentifier::save(const std::string &file_name, const Payload &payload) {
+  std::ofstream file(file_name);
+  if (!file.is_open()) {
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), "Failed to open '%s' for writing.",
+                 file_name.c_str());
+    return false;
+  }
+  file.precision(17);
+  file << "mass: " << payload.mass << "\n";
+  file << "center_of_mass: [" << payload.center_of_mass[0] << ", " << payload.center_of_mass[1]
+       << ", " << payload.center_of_mass[2] << "]\n";
+  return file.good();
+}
+
+bool PayloadIdentifier::load(const std::string &file_name, Payload &payload) {
+  std::ifstream file(file_name);
+  if (!file.is_open()) {
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), "Failed to open '%s' for reading.",
+                 file_name.c_str());
+    return false;
+  }
+  bool has_mass = false, has_center_of_mass = false;
+  std::string line;
+  while (std::getline(file, line)) {
+    const std::size_t colon = line.find(':');
+    if (colon == std::string::npos) {
+      continue;
+    }
+    const std::string key = line.substr(0, colon);
+    std::string value = line.substr(colon + 1);
+    std::replace_if(
+        value.begin(), value.end(), [](const char &c) { return c == '[' || c == ']' || c == ','; },
+        ' ');
+    std::istringstream value_stream(value);
+    if (key == "mass") {
+      has_mass = static_cast<bool>(value_stream >> payload.mass);
+    } else if (key == "center_of_mass") {
+      has_center_of_mass =
+          static_cast<bool>(value_stream >> payload.center_of_mass[0] >>
+                            payload.center_of_mass[1] >> payload.center_of_mass[2]);
+    }
+  }
+  if (!has_mass || !has_center_of_mass) {
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), "Failed to parse payload from '%s'.",
+                 file_name.c_str());
+    payload = Payload();
+    return false;
+  }
+  return true;
+}
+} // namespace lbr_fri_ros2
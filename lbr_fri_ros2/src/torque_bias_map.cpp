@@ -0,0 +1,280 @@
+#include "lbr_fri_ros2/torque_bias_map.hpp"
+
+namespace lbr_fri_ros2 {
+namespace {
+constexpr char TORQUE_BIAS_MAP_MAGIC[8] = "LBRTBM2";
+
+bool copy_name(const std::string &name, char (&dest)[TorqueBiasMap::MAX_NAME_LENGTH]) {
+  if (name.empty() || name.size() >= TorqueBiasMap::MAX_NAME_LENGTH) {
+    return false;
+  }
+  std::memset(dest, 0, TorqueBiasMap::MAX_NAME_LENGTH);
+  std::memcpy(dest, name.data(), name.size());
+  return true;
+}
+}
+
+TorqueBiasMap::TorqueBiasMap(const std::vector<uint32_t> &grid_joint_indices,
+                             const std::vector<double> &min, const std::vector<double> &max,
+                             const double &resolution, const std::string &robot_name,
+                             const std::string &chain_root, const std::string &chain_tip)
+    : mapped_data_(nullptr), mapped_size_(0), locked_(false), nodes_(nullptr) {
+  if (grid_joint_indices.empty() || grid_joint_indices.size() > MAX_GRID_JOINTS ||
+      grid_joint_indices.size() != min.size() || grid_joint_indices.size() != max.size()) {
+    std::string err = "Expected between 1 and " + std::to_string(MAX_GRID_JOINTS) +
+                      " grid joints with matching bounds.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  if (resolution <= 0.) {
+    std::string err = "Expected positive grid resolution.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  std::memset(&header_, 0, sizeof(Header));
+  std::memcpy(header_.magic, TORQUE_BIAS_MAP_MAGIC, sizeof(header_.magic));
+  if (!copy_name(robot_name, header_.robot_name) || !copy_name(chain_root, header_.chain_root) ||
+      !copy_name(chain_tip, header_.chain_tip)) {
+    std::string err = "Expected robot name, chain root and chain tip of 1 to " +
+                      std::to_string(MAX_NAME_LENGTH - 1) + " characters.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  header_.joints = KUKA::FRI::LBRState::NUMBER_OF_JOINTS;
+  header_.grid_joints = grid_joint_indices.size();
+  for (std::size_t i = 0; i < grid_joint_indices.size(); ++i) {
+    if (grid_joint_indices[i] >= KUKA::FRI::LBRState::NUMBER_OF_JOINTS || max[i] <= min[i]) {
+      std::string err = "Invalid grid joint index or bounds.";
+      RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+      throw std::runtime_error(err);
+    }
+    header_.grid_joint_indices[i] = grid_joint_indices[i];
+    header_.min[i] = min[i];
+    header_.max[i] = max[i];
+    header_.nodes[i] = static_cast<uint32_t>(std::ceil((max[i] - min[i]) / resolution)) + 1;
+  }
+  init_strides_();
+  bias_sums_.assign(number_of_nodes_ * KUKA::FRI::LBRState::NUMBER_OF_JOINTS, 0.);
+  weights_.assign(number_of_nodes_, 0.);
+}
+
+TorqueBiasMap::TorqueBiasMap(const std::string &file_name, const std::string &robot_name,
+                             const std::string &chain_root, const std::string &chain_tip)
+    : mapped_data_(nullptr), mapped_size_(0), locked_(false), nodes_(nullptr) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::string err = "Failed to open torque bias map '" + file_name + "'.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || static_cast<std::size_t>(file_stat.st_size) < sizeof(Header)) {
+    close(fd);
+    std::string err = "Invalid torque bias map '" + file_name + "'.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  mapped_size_ = file_stat.st_size;
+  mapped_data_ = mmap(nullptr, mapped_size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (mapped_data_ == MAP_FAILED) {
+    mapped_data_ = nullptr;
+    std::string err = "Failed to memory-map torque bias map '" + file_name + "'.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+
+  // validate
+  std::memcpy(&header_, mapped_data_, sizeof(Header));
+  bool valid = std::memcmp(header_.magic, TORQUE_BIAS_MAP_MAGIC, sizeof(header_.magic)) == 0 &&
+               header_.joints == KUKA::FRI::LBRState::NUMBER_OF_JOINTS &&
+               header_.grid_joints > 0 && header_.grid_joints <= MAX_GRID_JOINTS;
+  for (uint32_t i = 0; valid && i < header_.grid_joints; ++i) {
+    valid = header_.grid_joint_indices[i] < KUKA::FRI::LBRState::NUMBER_OF_JOINTS &&
+            header_.nodes[i] > 1 && header_.max[i] > header_.min[i];
+  }
+  if (valid) {
+    init_strides_();
+    valid = mapped_size_ == sizeof(Header) + number_of_nodes_ * NODE_SIZE * sizeof(double);
+  }
+  if (!valid) {
+    munmap(mapped_data_, mapped_size_);
+    mapped_data_ = nullptr;
+    std::string err = "Invalid torque bias map '" + file_name + "'.";
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+  if (!matches_(robot_name, chain_root, chain_tip)) {
+    std::string err = "Torque bias map '" + file_name + "' was calibrated on '" +
+                      std::string(header_.robot_name) + "' from '" +
+                      std::string(header_.chain_root) + "' to '" + std::string(header_.chain_tip) +
+                      "', expected '" + robot_name + "' from '" + chain_root + "' to '" +
+                      chain_tip + "'.";
+    munmap(mapped_data_, mapped_size_);
+    mapped_data_ = nullptr;
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), err.c_str());
+    throw std::runtime_error(err);
+  }
+
+  // keep resident, MAP_POPULATE pre-faults but does not prevent eviction
+  locked_ = mlock(mapped_data_, mapped_size_) == 0;
+  if (!locked_) {
+    RCLCPP_WARN(rclcpp::get_logger(LOGGER_NAME),
+                "Failed to lock torque bias map '%s' into memory, interpolation may page fault. "
+                "Consider raising the memlock limit.",
+                file_name.c_str());
+  }
+  nodes_ = reinterpret_cast<const double *>(static_cast<const char *>(mapped_data_) +
+                                            sizeof(Header));
+}
+
+TorqueBiasMap::~TorqueBiasMap() {
+  if (mapped_data_) {
+    if (locked_) {
+      munlock(mapped_data_, mapped_size_);
+    }
+    munmap(mapped_data_, mapped_size_);
+  }
+}
+
+void TorqueBiasMap::add_sample(const_jnt_pos_array_t_ref joint_position,
+                               const_ext_tau_array_t_ref external_torque) {
+  if (bias_sums_.empty()) {
+    return; // loaded from file, read only
+  }
+  std::array<uint32_t, MAX_GRID_JOINTS> index;
+  std::array<double, MAX_GRID_JOINTS> fraction;
+  corners_(joint_position, index, fraction);
+
+  // distribute onto surrounding nodes with multilinear weights
+  for (uint32_t corner = 0; corner < (1u << header_.grid_joints); ++corner) {
+    double weight = 1.;
+    std::size_t node = 0;
+    for (uint32_t i = 0; i < header_.grid_joints; ++i) {
+      const bool upper = corner & (1u << i);
+      weight *= upper ? fraction[i] : 1. - fraction[i];
+      node += (index[i] + upper) * strides_[i];
+    }
+    weights_[node] += weight;
+    for (std::size_t j = 0; j < KUKA::FRI::LBRState::NUMBER_OF_JOINTS; ++j) {
+      bias_sums_[node * KUKA::FRI::LBRState::NUMBER_OF_JOINTS + j] += weight * external_torque[j];
+    }
+  }
+}
+
+void TorqueBiasMap::interpolate(const_jnt_pos_array_t_ref joint_position,
+                                ext_tau_array_t_ref bias) const {
+  bias.fill(0.);
+  if (!nodes_) {
+    return; // not calibrated
+  }
+  std::array<uint32_t, MAX_GRID_JOINTS> index;
+  std::array<double, MAX_GRID_JOINTS> fraction;
+  corners_(joint_position, index, fraction);
+
+  // blend visited nodes only, renormalized, so that unvisited nodes do not pull towards zero
+  double weight_sum = 0.;
+  for (uint32_t corner = 0; corner < (1u << header_.grid_joints); ++corner) {
+    double weight = 1.;
+    std::size_t node = 0;
+    for (uint32_t i = 0; i < header_.grid_joints; ++i) {
+      const bool upper = corner & (1u << i);
+      weight *= upper ? fraction[i] : 1. - fraction[i];
+      node += (index[i] + upper) * strides_[i];
+    }
+    const double *node_data = nodes_ + node * NODE_SIZE;
+    if (node_data[0] <= 0.) {
+      continue; // unvisited
+    }
+    weight_sum += weight;
+    for (std::size_t j = 0; j < KUKA::FRI::LBRState::NUMBER_OF_JOINTS; ++j) {
+      bias[j] += weight * node_data[j + 1];
+    }
+  }
+  if (weight_sum <= 0.) {
+    bias.fill(0.);
+    return;
+  }
+  for (auto &bias_j : bias) {
+    bias_j /= weight_sum;
+  }
+}
+
+bool TorqueBiasMap::save(const std::string &file_name) const {
+  if (bias_sums_.empty()) {
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), "No calibration to save.");
+    return false;
+  }
+  std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    RCLCPP_ERROR(rclcpp::get_logger(LOGGER_NAME), "Failed to open '%s' for writing.",
+                 file_name.c_str());
+    return false;
+  }
+  file.write(reinterpret_cast<const char *>(&header_), sizeof(Header));
+
+  // calibration weight, marks visited nodes, and normalized bias
+  std::array<double, NODE_SIZE> node_data;
+  for (std::size_t node = 0; node < number_of_nodes_; ++node) {
+    node_data[0] = weights_[node];
+    for (std::size_t j = 0; j < KUKA::FRI::LBRState::NUMBER_OF_JOINTS; ++j) {
+      node_data[j + 1] =
+          weights_[node] > 0.
+              ? bias_sums_[node * KUKA::FRI::LBRState::NUMBER_OF_JOINTS + j] / weights_[node]
+              : 0.;
+    }
+    file.write(reinterpret_cast<const char *>(node_data.data()), sizeof(node_data));
+  }
+  return file.good();
+}
+
+double TorqueBiasMap::get_coverage() const {
+  std::size_t visited = 0;
+  if (nodes_) {
+    for (std::size_t node = 0; node < number_of_nodes_; ++node) {
+      visited += nodes_[node * NODE_SIZE] > 0.;
+    }
+  } else {
+    for (const auto &weight : weights_) {
+      visited += weight > 0.;
+    }
+  }
+  return static_cast<double>(visited) / static_cast<double>(number_of_nodes_);
+}
+
+void TorqueBiasMap::init_strides_() {
+  strides_.fill(0);
+  number_of_nodes_ = 1;
+  for (uint32_t i = 0; i < header_.grid_joints; ++i) {
+    strides_[i] = number_of_nodes_;
+    number_of_nodes_ *= header_.nodes[i];
+  }
+}
+
+bool TorqueBiasMap::matches_(const std::string &robot_name, const std::string &chain_root,
+                             const std::string &chain_tip) const {
+  // names are null-terminated within MAX_NAME_LENGTH
+  return strnlen(header_.robot_name, MAX_NAME_LENGTH) < MAX_NAME_LENGTH &&
+         strnlen(header_.chain_root, MAX_NAME_LENGTH) < MAX_NAME_LENGTH &&
+         strnlen(header_.chain_tip, MAX_NAME_LENGTH) < MAX_NAME_LENGTH &&
+         robot_name == header_.robot_name && chain_root == header_.chain_root &&
+         chain_tip == header_.chain_tip;
+}
+
+void TorqueBiasMap::corners_(const_jnt_pos_array_t_ref joint_position,
+                             std::array<uint32_t, MAX_GRID_JOINTS> &index,
+                             std::array<double, MAX_GRID_JOINTS> &fraction) const {
+  for (uint32_t i = 0; i < header_.grid_joints; ++i) {
+    const double spacing = (header_.max[i] - header_.min[i]) / (header_.nodes[i] - 1);
+    double position = (joint_position[header_.grid_joint_indices[i]] - header_.min[i]) / spacing;
+    if (!std::isfinite(position)) {
+      position = 0.;
+    }
+    position = std::min(std::max(position, 0.), static_cast<double>(header_.nodes[i] - 1));
+
+    // lower node, such that the upper node always exists
+    index[i] = std::min(static_cast<uint32_t>(position), header_.nodes[i] - 2);
+    fraction[i] = position - index[i];
+  }
+}
+} // namespace lbr_fri_ros2
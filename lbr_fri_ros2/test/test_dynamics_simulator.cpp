@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "kdl_parser/kdl_parser.hpp"
+
+#include "lbr_fri_idl/msg/lbr_command.hpp"
+#include "lbr_fri_idl/msg/lbr_state.hpp"
+#include "lbr_fri_ros2/dynamics_simulator.hpp"
+
+class TestDynamicsSimulator : public ::testing::Test {
+public:
+  TestDynamicsSimulator() {
+    KDL::Tree tree;
+    if (!kdl_parser::treeFromString(robot_description_(), tree) ||
+        !tree.getChain("link_0", "link_ee", chain_)) {
+      throw std::runtime_error("Failed to construct kdl chain.");
+    }
+    simulator_ = std::make_unique<lbr_fri_ros2::DynamicsSimulator>(chain_, parameters_);
+    q_.fill(0.);
+    tau_.fill(0.);
+    tau_ext_.fill(0.);
+    wrench_.fill(0.);
+  }
+
+protected:
+  std::string robot_description_() const {
+    // simplified 7 DoF serial chain with alternating joint axes and link inertias, similar to the
+    // LBR
+    const double offsets[] = {0.1575, 0.2025, 0.2045, 0.2155, 0.1845, 0.2155, 0.081, 0.045};
+    const double masses[] = {4., 4., 3., 2.7, 1.7, 1.8, 0.3};
+    const char *axes[] = {"0 0 1", "0 1 0", "0 0 1", "0 -1 0", "0 0 1", "0 1 0", "0 0 1"};
+    std::string urdf = "<?xml version=\"1.0\"?><robot name=\"lbr\">";
+    urdf += "<link name=\"link_0\"/>";
+    for (int i = 1; i <= 7; ++i) {
+      urdf += "<link name=\"link_" + std::to_string(i) + "\"><inertial>";
+      urdf += "<origin xyz=\"0 0.01 0.1\" rpy=\"0 0 0\"/>";
+      urdf += "<mass value=\"" + std::to_string(masses[i - 1]) + "\"/>";
+      urdf += "<inertia ixx=\"0.05\" ixy=\"0\" ixz=\"0\" iyy=\"0.05\" iyz=\"0\" izz=\"0.01\"/>";
+      urdf += "</inertial></link>";
+    }
+    urdf += "<link name=\"link_ee\"/>";
+    for (int i = 0; i < 7; ++i) {
+      urdf += "<joint name=\"A" + std::to_string(i + 1) + "\" type=\"revolute\">";
+      urdf += "<parent link=\"link_" + std::to_string(i) + "\"/>";
+      urdf += "<child link=\"link_" + std::to_string(i + 1) + "\"/>";
+      urdf += "<origin xyz=\"0 0 " + std::to_string(offsets[i]) + "\" rpy=\"0 0 0\"/>";
+      urdf += "<axis xyz=\"" + std::string(axes[i]) + "\"/>";
+      urdf += "<limit lower=\"-2.9\" upper=\"2.9\" effort=\"300\" velocity=\"10\"/>";
+      urdf += "</joint>";
+    }
+    urdf += "<joint name=\"joint_ee\" type=\"fixed\"><parent link=\"link_7\"/>"
+            "<child link=\"link_ee\"/><origin xyz=\"0 0 " +
+            std::to_string(offsets[7]) + "\" rpy=\"0 0 0\"/></joint>";
+    urdf += "</robot>";
+    return urdf;
+  }
+
+  void simulate_(const double &duration,
+                 const lbr_fri_idl::msg::LBRState::_ipo_joint_position_type &ipo) {
+    for (int i = 0; i < static_cast<int>(duration / sample_time_); ++i) {
+      simulator_->step(sample_time_, ipo, tau_, wrench_, tau_ext_);
+    }
+  }
+
+  const double sample_time_{0.005};
+  KDL::Chain chain_;
+  lbr_fri_ros2::DynamicsSimulatorParameters parameters_;
+  std::unique_ptr<lbr_fri_ros2::DynamicsSimulator> simulator_;
+  lbr_fri_idl::msg::LBRState::_measured_joint_position_type q_, tau_, tau_ext_;
+  lbr_fri_idl::msg::LBRCommand::_wrench_type wrench_;
+};
+
+TEST_F(TestDynamicsSimulator, TestHoldsUnderGravity) {
+  q_ = {0.3, 0.8, -0.2, -1.2, 0.1, 0.6, 0.};
+  simulator_->reset(q_);
+  simulate_(1., q_);
+  for (std::size_t i = 0; i < q_.size(); ++i) {
+    EXPECT_NEAR(simulator_->get_joint_position()[i], q_[i], 1.e-9);
+    EXPECT_NEAR(simulator_->get_joint_velocity()[i], 0., 1.e-9);
+  }
+
+  // the measured torque holds the gravity load
+  EXPECT_GT(std::abs(simulator_->get_measured_torque()[1]), 1.);
+}
+
+TEST_F(TestDynamicsSimulator, TestTracksIPOJointPosition) {
+  simulator_->reset(q_);
+  lbr_fri_idl::msg::LBRState::_ipo_joint_position_type ipo = {0.2, -0.3, 0.4, 0.5,
+                                                              -0.2, 0.3, 0.1};
+  simulate_(5., ipo);
+  for (std::size_t i = 0; i < ipo.size(); ++i) {
+    EXPECT_NEAR(simulator_->get_joint_position()[i], ipo[i], 1.e-3);
+  }
+}
+
+TEST_F(TestDynamicsSimulator, TestExternalTorqueDeflects) {
+  simulator_->reset(q_);
+  tau_ext_[3] = 10.;
+  simulate_(5., q_);
+
+  // static equilibrium of stiffness and external torque
+  EXPECT_NEAR(simulator_->get_joint_position()[3], tau_ext_[3] / parameters_.stiffness[3], 1.e-3);
+  EXPECT_NEAR(simulator_->get_measured_torque()[3], -tau_ext_[3], 1.);
+
+  // as the robot estimates it, the external torque opposes the torque acting on the robot
+  EXPECT_NEAR(simulator_->get_external_torque()[3], -tau_ext_[3], 1.e-3);
+}
+
+TEST_F(TestDynamicsSimulator, TestJointLimits) {
+  simulator_->reset(q_);
+  tau_[0] = 1.e4;
+  simulate_(1., q_);
+  EXPECT_LE(simulator_->get_joint_position()[0], parameters_.max_position[0]);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
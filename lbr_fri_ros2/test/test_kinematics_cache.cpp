@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+#include "kdl/chainfksolverpos_recursive.hpp"
+#include "kdl/chainjnttojacsolver.hpp"
+
+#include "lbr_fri_idl/msg/lbr_state.hpp"
+#include "lbr_fri_ros2/kinematics_cache.hpp"
+
+class TestKinematicsCache : public ::testing::Test {
+public:
+  TestKinematicsCache() : random_engine_(std::random_device{}()) {
+    kinematics_cache_ = std::make_unique<lbr_fri_ros2::KinematicsCache>(robot_description_());
+    fk_solver_ = std::make_unique<KDL::ChainFkSolverPos_recursive>(kinematics_cache_->get_chain());
+    jacobian_solver_ =
+        std::make_unique<KDL::ChainJntToJacSolver>(kinematics_cache_->get_chain());
+  }
+
+protected:
+  std::string robot_description_() const {
+    // simplified 7 DoF serial chain with alternating joint axes, similar to the LBR
+    const double offsets[] = {0.1575, 0.2025, 0.2045, 0.2155, 0.1845, 0.2155, 0.081, 0.045};
+    const char *axes[] = {"0 0 1", "0 1 0", "0 0 1", "0 -1 0", "0 0 1", "0 1 0", "0 0 1"};
+    std::string urdf = "<?xml version=\"1.0\"?><robot name=\"lbr\">";
+    for (int i = 0; i <= 7; ++i) {
+      urdf += "<link name=\"link_" + std::to_string(i) + "\"/>";
+    }
+    urdf += "<link name=\"link_ee\"/>";
+    for (int i = 0; i < 7; ++i) {
+      urdf += "<joint name=\"A" + std::to_string(i + 1) + "\" type=\"revolute\">";
+      urdf += "<parent link=\"link_" + std::to_string(i) + "\"/>";
+      urdf += "<child link=\"link_" + std::to_string(i + 1) + "\"/>";
+      urdf += "<origin xyz=\"0 0 " + std::to_string(offsets[i]) + "\" rpy=\"0 0 0\"/>";
+      urdf += "<axis xyz=\"" + std::string(axes[i]) + "\"/>";
+      urdf += "<limit lower=\"-2.9\" upper=\"2.9\" effort=\"300\" velocity=\"10\"/>";
+      urdf += "</joint>";
+    }
+    urdf += "<joint name=\"joint_ee\" type=\"fixed\"><parent link=\"link_7\"/>"
+            "<child link=\"link_ee\"/><origin xyz=\"0 0 " +
+            std::to_string(offsets[7]) + "\" rpy=\"0.3 0 0\"/></joint>";
+    urdf += "</robot>";
+    return urdf;
+  }
+
+  lbr_fri_idl::msg::LBRState::_measured_joint_position_type random_joint_position_() {
+    lbr_fri_idl::msg::LBRState::_measured_joint_position_type q;
+    for (auto &q_i : q) {
+      q_i = uniform_real_dist_(random_engine_);
+    }
+    return q;
+  }
+
+  void expect_matches_solvers_(
+      const lbr_fri_idl::msg::LBRState::_measured_joint_position_type &joint_position) {
+    KDL::JntArray q(KUKA::FRI::LBRState::NUMBER_OF_JOINTS);
+    for (std::size_t i = 0; i < joint_position.size(); ++i) {
+      q(i) = joint_position[i];
+    }
+    KDL::Frame frame;
+    fk_solver_->JntToCart(q, frame);
+    KDL::Jacobian jacobian(KUKA::FRI::LBRState::NUMBER_OF_JOINTS);
+    jacobian_solver_->JntToJac(q, jacobian);
+
+    EXPECT_TRUE(KDL::Equal(kinematics_cache_->get_tip_frame(), frame, 1.e-9));
+    EXPECT_TRUE(kinematics_cache_->get_jacobian().data.isApprox(jacobian.data, 1.e-9));
+  }
+
+  std::default_random_engine random_engine_;
+  std::uniform_real_distribution<double> uniform_real_dist_{-2.0, 2.0};
+
+  std::unique_ptr<lbr_fri_ros2::KinematicsCache> kinematics_cache_;
+  std::unique_ptr<KDL::ChainFkSolverPos_recursive> fk_solver_;
+  std::unique_ptr<KDL::ChainJntToJacSolver> jacobian_solver_;
+};
+
+TEST_F(TestKinematicsCache, TestMatchesKDLSolvers) {
+  for (int i = 0; i < 100; ++i) {
+    auto q = random_joint_position_();
+    kinematics_cache_->update(q);
+    expect_matches_solvers_(q);
+  }
+}
+
+TEST_F(TestKinematicsCache, TestSequence) {
+  auto q = random_joint_position_();
+  EXPECT_TRUE(kinematics_cache_->update(q, 1));
+  expect_matches_solvers_(q);
+
+  // same sample, expect cached result
+  auto q_other = random_joint_position_();
+  EXPECT_FALSE(kinematics_cache_->update(q_other, 1));
+  expect_matches_solvers_(q);
+
+  // new sample, expect re-evaluation
+  EXPECT_TRUE(kinematics_cache_->update(q_other, 2));
+  expect_matches_solvers_(q_other);
+
+  // reset invalidates the sequence
+  kinematics_cache_->reset();
+  EXPECT_FALSE(kinematics_cache_->is_sequence_valid());
+  EXPECT_TRUE(kinematics_cache_->update(q, 2));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/Geometry"
+
+#include "lbr_fri_idl/msg/lbr_state.hpp"
+#include "lbr_fri_ros2/kinematics_cache.hpp"
+#include "lbr_fri_ros2/payload_identifier.hpp"
+
+class TestPayloadIdentifier : public ::testing::Test {
+public:
+  TestPayloadIdentifier() {
+    kinematics_cache_ptr_ = std::make_shared<lbr_fri_ros2::KinematicsCache>(robot_description_());
+    payload_identifier_ =
+        std::make_unique<lbr_fri_ros2::PayloadIdentifier>(kinematics_cache_ptr_, gravity_);
+    payload_.mass = 1.5;
+    payload_.center_of_mass = {0.01, -0.02, 0.08};
+  }
+
+protected:
+  using jnt_pos_array_t = lbr_fri_idl::msg::LBRState::_measured_joint_position_type;
+  using ext_tau_array_t = lbr_fri_idl::msg::LBRState::_external_torque_type;
+
+  std::string robot_description_() const {
+    // simplified 7 DoF serial chain with alternating joint axes, similar to the LBR
+    const double offsets[] = {0.1575, 0.2025, 0.2045, 0.2155, 0.1845, 0.2155, 0.081, 0.045};
+    const char *axes[] = {"0 0 1", "0 1 0", "0 0 1", "0 -1 0", "0 0 1", "0 1 0", "0 0 1"};
+    std::string urdf = "<?xml version=\"1.0\"?><robot name=\"lbr\">";
+    for (int i = 0; i <= 7; ++i) {
+      urdf += "<link name=\"link_" + std::to_string(i) + "\"/>";
+    }
+    urdf += "<link name=\"link_ee\"/>";
+    for (int i = 0; i < 7; ++i) {
+      urdf += "<joint name=\"A" + std::to_string(i + 1) + "\" type=\"revolute\">";
+      urdf += "<parent link=\"link_" + std::to_string(i) + "\"/>";
+      urdf += "<child link=\"link_" + std::to_string(i + 1) + "\"/>";
+      urdf += "<origin xyz=\"0 0 " + std::to_string(offsets[i]) + "\" rpy=\"0 0 0\"/>";
+      urdf += "<axis xyz=\"" + std::string(axes[i]) + "\"/>";
+      urdf += "<limit lower=\"-2.9\" upper=\"2.9\" effort=\"300\" velocity=\"10\"/>";
+      urdf += "</joint>";
+    }
+    urdf += "<joint name=\"joint_ee\" type=\"fixed\"><parent link=\"link_7\"/>"
+            "<child link=\"link_ee\"/><origin xyz=\"0 0 " +
+            std::to_string(offsets[7]) + "\" rpy=\"0 0 0\"/></joint>";
+    urdf += "</robot>";
+    return urdf;
+  }
+
+  // synthetic standstill samples, tau_ext = J^T [m g; (R m c) x g]
+  void add_samples_(const jnt_pos_array_t &q, const std::size_t &samples = 10) {
+    kinematics_cache_ptr_->update(q);
+    const Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>> rotation(
+        kinematics_cache_ptr_->get_tip_frame().M.data);
+    const Eigen::Vector3d gravity = Eigen::Vector3d::Map(gravity_.data());
+    Eigen::Matrix<double, 6, 1> wrench;
+    wrench.head<3>() = payload_.mass * gravity;
+    wrench.tail<3>() =
+        (rotation * payload_.mass * Eigen::Vector3d::Map(payload_.center_of_mass.data()))
+            .cross(gravity);
+    ext_tau_array_t external_torque;
+    Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, 1>::Map(external_torque.data()) =
+        kinematics_cache_ptr_->get_jacobian().data.transpose() * wrench;
+    for (std::size_t i = 0; i < samples; ++i) {
+      payload_identifier_->add_sample(external_torque);
+    }
+  }
+
+  const lbr_fri_ros2::PayloadIdentifier::gravity_t gravity_{0., 0., -9.81};
+  std::shared_ptr<lbr_fri_ros2::KinematicsCache> kinematics_cache_ptr_;
+  std::unique_ptr<lbr_fri_ros2::PayloadIdentifier> payload_identifier_;
+  lbr_fri_ros2::Payload payload_;
+};
+
+TEST_F(TestPayloadIdentifier, TestRecoversPayload) {
+  add_samples_({0., 0.5, 0., -1.0, 0., 1.0, 0.});
+  add_samples_({0., 0.2, 0., 0.3, 1.2, 1.0, 0.5});
+  add_samples_({-0.5, 0.8, -0.3, 0.6, -1.0, 1.2, -0.7});
+  EXPECT_EQ(payload_identifier_->get_number_of_poses(), 3u);
+
+  lbr_fri_ros2::Payload payload;
+  ASSERT_TRUE(payload_identifier_->identify(payload));
+  EXPECT_NEAR(payload.mass, payload_.mass, 1.e-6);
+  for (std::size_t i = 0; i < payload.center_of_mass.size(); ++i) {
+    EXPECT_NEAR(payload.center_of_mass[i], payload_.center_of_mass[i], 1.e-6);
+  }
+}
+
+TEST_F(TestPayloadIdentifier, TestRankDeficientKeepsPayload) {
+  // a single pose, and rotations about gravity, leave the center of mass along gravity
+  // unobservable
+  add_samples_({0., 0.5, 0., -1.0, 0., 1.0, 0.}, 100);
+  add_samples_({1.0, 0.5, 0., -1.0, 0., 1.0, 0.}, 100);
+  EXPECT_EQ(payload_identifier_->get_number_of_poses(), 1u);
+
+  lbr_fri_ros2::Payload payload;
+  payload.mass = 0.7;
+  payload.center_of_mass = {0.1, 0.2, 0.3};
+  EXPECT_FALSE(payload_identifier_->identify(payload));
+  EXPECT_EQ(payload.mass, 0.7);
+  EXPECT_EQ(payload.center_of_mass[0], 0.1);
+  EXPECT_EQ(payload.center_of_mass[1], 0.2);
+  EXPECT_EQ(payload.center_of_mass[2], 0.3);
+
+  // identifiable once a distinct pose is added
+  add_samples_({0., 0.2, 0., 0.3, 1.2, 1.0, 0.5});
+  EXPECT_EQ(payload_identifier_->get_number_of_poses(), 2u);
+  EXPECT_TRUE(payload_identifier_->identify(payload));
+  EXPECT_NEAR(payload.mass, payload_.mass, 1.e-6);
+}
+
+TEST_F(TestPayloadIdentifier, TestNoSamples) {
+  lbr_fri_ros2::Payload payload;
+  EXPECT_FALSE(payload_identifier_->identify(payload));
+  add_samples_({0., 0.5, 0., -1.0, 0., 1.0, 0.});
+  add_samples_({0., 0.2, 0., 0.3, 1.2, 1.0, 0.5});
+  payload_identifier_->reset();
+  EXPECT_EQ(payload_identifier_->get_number_of_samples(), 0u);
+  EXPECT_EQ(payload_identifier_->get_number_of_poses(), 0u);
+  EXPECT_FALSE(payload_identifier_->identify(payload));
+}
+
+TEST_F(TestPayloadIdentifier, TestSaveLoad) {
+  const std::string file_name = ::testing::TempDir() + "test_payload_identifier.yaml";
+  ASSERT_TRUE(lbr_fri_ros2::PayloadIdentifier::save(file_name, payload_));
+  lbr_fri_ros2::Payload payload;
+  ASSERT_TRUE(lbr_fri_ros2::PayloadIdentifier::load(file_name, payload));
+  EXPECT_DOUBLE_EQ(payload.mass, payload_.mass);
+  for (std::size_t i = 0; i < payload.center_of_mass.size(); ++i) {
+    EXPECT_DOUBLE_EQ(payload.center_of_mass[i], payload_.center_of_mass[i]);
+  }
+  std::remove(file_name.c_str());
+  EXPECT_FALSE(lbr_fri_ros2::PayloadIdentifier::load(file_name, payload));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <thread>
+
+#include "lbr_fri_ros2/spsc_ring.hpp"
+
+namespace {
+struct Block {
+  uint64_t sequence{0};
+  std::array<uint64_t, 16> data{};
+};
+} // namespace
+
+TEST(TestSPSCRing, TestFullEmpty) {
+  lbr_fri_ros2::SPSCRing<uint64_t> ring(3);
+  EXPECT_EQ(ring.capacity(), 3u);
+  EXPECT_EQ(ring.size(), 0u);
+
+  uint64_t value = 0;
+  EXPECT_FALSE(ring.pop(value));
+  for (uint64_t i = 1; i <= 3; ++i) {
+    EXPECT_TRUE(ring.push(i));
+    EXPECT_EQ(ring.size(), i);
+  }
+
+  // full, the element is dropped
+  EXPECT_FALSE(ring.push(4));
+  EXPECT_EQ(ring.size(), 3u);
+  for (uint64_t i = 1; i <= 3; ++i) {
+    ASSERT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(ring.pop(value));
+  EXPECT_EQ(value, 3u);
+  EXPECT_EQ(ring.size(), 0u);
+
+  // a zero capacity ring is always full and empty
+  lbr_fri_ros2::SPSCRing<uint64_t> zero;
+  EXPECT_EQ(zero.capacity(), 0u);
+  EXPECT_FALSE(zero.push(1));
+  EXPECT_FALSE(zero.pop(value));
+}
+
+TEST(TestSPSCRing, TestWraparound) {
+  lbr_fri_ros2::SPSCRing<uint64_t> ring(4);
+
+  // interleaved push and pop, indices wrap around many times
+  uint64_t pushed = 0, popped = 0, value = 0;
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(ring.push(++pushed));
+    }
+    EXPECT_EQ(ring.size(), 3u);
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(ring.pop(value));
+      EXPECT_EQ(value, ++popped);
+    }
+    EXPECT_EQ(ring.size(), 0u);
+  }
+
+  // full across the wraparound
+  for (uint64_t i = 0; i < ring.capacity(); ++i) {
+    ASSERT_TRUE(ring.push(++pushed));
+  }
+  EXPECT_FALSE(ring.push(0));
+  EXPECT_EQ(ring.size(), ring.capacity());
+
+  // reset clears
+  ring.reset(2);
+  EXPECT_EQ(ring.capacity(), 2u);
+  EXPECT_EQ(ring.size(), 0u);
+  EXPECT_FALSE(ring.pop(value));
+}
+
+TEST(TestSPSCRing, TestConcurrentProducerConsumer) {
+  constexpr uint64_t BLOCKS = 1000000;
+  lbr_fri_ros2::SPSCRing<Block> ring(64);
+
+  std::thread producer([&]() {
+    Block block;
+    for (uint64_t sequence = 1; sequence <= BLOCKS; ++sequence) {
+      block.sequence = sequence;
+      block.data.fill(sequence);
+      while (!ring.push(block)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  // every block is delivered complete and in order
+  Block block;
+  uint64_t expected = 1, torn = 0, reordered = 0;
+  while (expected <= BLOCKS) {
+    if (!ring.pop(block)) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (const auto &value : block.data) {
+      torn += value != block.sequence;
+    }
+    reordered += block.sequence != expected;
+    expected = block.sequence + 1;
+  }
+  producer.join();
+
+  EXPECT_EQ(torn, 0u);
+  EXPECT_EQ(reordered, 0u);
+  EXPECT_EQ(ring.size(), 0u);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
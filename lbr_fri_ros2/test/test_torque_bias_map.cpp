@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "lbr_fri_idl/msg/lbr_state.hpp"
+#include "lbr_fri_ros2/torque_bias_map.hpp"
+
+class TestTorqueBiasMap : public ::testing::Test {
+public:
+  TestTorqueBiasMap() : file_name_(::testing::TempDir() + "test_torque_bias_map.bin") {
+    // grid over joints 1 and 3 in [-1, 1] with nodes at multiples of 0.5
+    torque_bias_map_ = std::make_unique<lbr_fri_ros2::TorqueBiasMap>(
+        std::vector<uint32_t>{1, 3}, std::vector<double>{-1., -1.}, std::vector<double>{1., 1.},
+        0.5, "iiwa7", "link_0", "link_ee");
+    q_.fill(0.);
+  }
+
+  ~TestTorqueBiasMap() { std::remove(file_name_.c_str()); }
+
+protected:
+  using jnt_pos_array_t = lbr_fri_idl::msg::LBRState::_measured_joint_position_type;
+  using ext_tau_array_t = lbr_fri_idl::msg::LBRState::_external_torque_type;
+
+  // bias, linear in the grid joints
+  ext_tau_array_t bias_(const jnt_pos_array_t &q) const {
+    ext_tau_array_t bias;
+    for (std::size_t j = 0; j < bias.size(); ++j) {
+      bias[j] = 0.1 * j + 2. * q[1] - 3. * q[3];
+    }
+    return bias;
+  }
+
+  void add_node_sample_(const double &q1, const double &q3) {
+    q_[1] = q1;
+    q_[3] = q3;
+    torque_bias_map_->add_sample(q_, bias_(q_));
+  }
+
+  std::unique_ptr<lbr_fri_ros2::TorqueBiasMap> load_() const {
+    if (!torque_bias_map_->save(file_name_)) {
+      throw std::runtime_error("Failed to save torque bias map.");
+    }
+    return std::make_unique<lbr_fri_ros2::TorqueBiasMap>(file_name_, "iiwa7", "link_0",
+                                                          "link_ee");
+  }
+
+  const std::string file_name_;
+  std::unique_ptr<lbr_fri_ros2::TorqueBiasMap> torque_bias_map_;
+  jnt_pos_array_t q_;
+};
+
+TEST_F(TestTorqueBiasMap, TestAccumulation) {
+  EXPECT_EQ(torque_bias_map_->get_coverage(), 0.);
+
+  // samples between nodes are distributed onto the surrounding nodes and averaged
+  add_node_sample_(0.25, 0.25);
+  EXPECT_DOUBLE_EQ(torque_bias_map_->get_coverage(), 4. / 25.);
+  const ext_tau_array_t bias_sample = bias_(q_);
+  for (int i = 0; i < 10; ++i) {
+    torque_bias_map_->add_sample(q_, bias_sample);
+  }
+  auto loaded = load_();
+  EXPECT_DOUBLE_EQ(loaded->get_coverage(), 4. / 25.);
+  ext_tau_array_t bias;
+  loaded->interpolate(q_, bias);
+  for (std::size_t j = 0; j < bias.size(); ++j) {
+    EXPECT_NEAR(bias[j], bias_sample[j], 1.e-9);
+  }
+
+  // not interpolated before saved and loaded
+  torque_bias_map_->interpolate(q_, bias);
+  for (const auto &bias_j : bias) {
+    EXPECT_EQ(bias_j, 0.);
+  }
+}
+
+TEST_F(TestTorqueBiasMap, TestInterpolation) {
+  for (double q1 = -1.; q1 <= 1.; q1 += 0.5) {
+    for (double q3 = -1.; q3 <= 1.; q3 += 0.5) {
+      add_node_sample_(q1, q3);
+    }
+  }
+  auto loaded = load_();
+  EXPECT_DOUBLE_EQ(loaded->get_coverage(), 1.);
+
+  // multilinear interpolation reproduces a linear bias, other joints do not affect the bias
+  ext_tau_array_t bias;
+  for (const auto &q : {jnt_pos_array_t{0., 0.1, 0., 0.3, 0., 0., 0.},
+                        jnt_pos_array_t{1., -0.77, 2., 0.61, -1., 0.5, 3.},
+                        jnt_pos_array_t{0., 0.5, 0., -0.5, 0., 0., 0.}}) {
+    loaded->interpolate(q, bias);
+    const ext_tau_array_t expected = bias_(q);
+    for (std::size_t j = 0; j < bias.size(); ++j) {
+      EXPECT_NEAR(bias[j], expected[j], 1.e-9);
+    }
+  }
+
+  // clamped outside the grid
+  jnt_pos_array_t q_outside = q_;
+  q_outside[1] = 5.;
+  q_outside[3] = -5.;
+  loaded->interpolate(q_outside, bias);
+  q_outside[1] = 1.;
+  q_outside[3] = -1.;
+  const ext_tau_array_t expected = bias_(q_outside);
+  for (std::size_t j = 0; j < bias.size(); ++j) {
+    EXPECT_NEAR(bias[j], expected[j], 1.e-9);
+  }
+}
+
+TEST_F(TestTorqueBiasMap, TestUnvisitedNodes) {
+  // visit the nodes at q1 = 0 only
+  for (double q3 = -1.; q3 <= 1.; q3 += 0.5) {
+    add_node_sample_(0., q3);
+  }
+  auto loaded = load_();
+
+  // next to unvisited nodes, the visited nodes are not blended towards zero
+  jnt_pos_array_t q = q_;
+  q[1] = 0.4;
+  q[3] = 0.25;
+  jnt_pos_array_t q_visited = q;
+  q_visited[1] = 0.;
+  ext_tau_array_t bias;
+  loaded->interpolate(q, bias);
+  const ext_tau_array_t expected = bias_(q_visited);
+  for (std::size_t j = 0; j < bias.size(); ++j) {
+    EXPECT_NEAR(bias[j], expected[j], 1.e-9);
+  }
+
+  // no bias if all surrounding nodes are unvisited
+  q[1] = 0.75;
+  loaded->interpolate(q, bias);
+  for (const auto &bias_j : bias) {
+    EXPECT_EQ(bias_j, 0.);
+  }
+}
+
+TEST_F(TestTorqueBiasMap, TestSaveLoad) {
+  add_node_sample_(0.5, -0.5);
+  auto loaded = load_();
+  const auto &header = loaded->get_header();
+  EXPECT_STREQ(header.robot_name, "iiwa7");
+  EXPECT_STREQ(header.chain_root, "link_0");
+  EXPECT_STREQ(header.chain_tip, "link_ee");
+  EXPECT_EQ(header.grid_joints, 2u);
+  EXPECT_EQ(header.grid_joint_indices[0], 1u);
+  EXPECT_EQ(header.grid_joint_indices[1], 3u);
+  EXPECT_EQ(header.nodes[0], 5u);
+  EXPECT_EQ(header.nodes[1], 5u);
+
+  // read only
+  loaded->add_sample(q_, bias_(q_));
+  EXPECT_FALSE(loaded->save(file_name_ + ".copy"));
+
+  // reject other robot models and chains
+  EXPECT_THROW(lbr_fri_ros2::TorqueBiasMap(file_name_, "iiwa14", "link_0", "link_ee"),
+               std::runtime_error);
+  EXPECT_THROW(lbr_fri_ros2::TorqueBiasMap(file_name_, "iiwa7", "link_0", "link_7"),
+               std::runtime_error);
+
+  // reject truncated files
+  {
+    std::ofstream file(file_name_, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+  EXPECT_THROW(lbr_fri_ros2::TorqueBiasMap(file_name_, "iiwa7", "link_0", "link_ee"),
+               std::runtime_error);
+  EXPECT_THROW(lbr_fri_ros2::TorqueBiasMap(file_name_ + ".missing", "iiwa7", "link_0", "link_ee"),
+               std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "lbr_fri_ros2/triple_buffer.hpp"
+
+namespace {
+struct Block {
+  uint64_t sequence{0};
+  std::array<uint64_t, 64> data{};
+};
+} // namespace
+
+TEST(TestTripleBuffer, TestAcquireLatest) {
+  lbr_fri_ros2::TripleBuffer<Block> triple_buffer;
+  EXPECT_FALSE(triple_buffer.acquire());
+
+  for (uint64_t sequence = 1; sequence <= 3; ++sequence) {
+    triple_buffer.back().sequence = sequence;
+    triple_buffer.publish();
+  }
+  ASSERT_TRUE(triple_buffer.acquire());
+  EXPECT_EQ(triple_buffer.front().sequence, 3u);
+
+  // nothing new, front is retained
+  EXPECT_FALSE(triple_buffer.acquire());
+  EXPECT_EQ(triple_buffer.front().sequence, 3u);
+
+  triple_buffer.back().sequence = 4;
+  triple_buffer.publish();
+  ASSERT_TRUE(triple_buffer.acquire());
+  EXPECT_EQ(triple_buffer.front().sequence, 4u);
+}
+
+TEST(TestTripleBuffer, TestConcurrentWriterReader) {
+  constexpr uint64_t BLOCKS = 1000000;
+  lbr_fri_ros2::TripleBuffer<Block> triple_buffer;
+  std::atomic_bool done{false};
+
+  std::thread writer([&]() {
+    for (uint64_t sequence = 1; sequence <= BLOCKS; ++sequence) {
+      Block &block = triple_buffer.back();
+      block.sequence = sequence;
+      block.data.fill(sequence);
+      triple_buffer.publish();
+    }
+    done = true;
+  });
+
+  // the reader always sees complete blocks, in order
+  uint64_t last_sequence = 0, acquired = 0, torn = 0, reordered = 0;
+  while (last_sequence < BLOCKS) {
+    if (!triple_buffer.acquire()) {
+      if (done && !triple_buffer.acquire()) {
+        break;
+      }
+      continue;
+    }
+    const Block &block = triple_buffer.front();
+    for (const auto &value : block.data) {
+      torn += value != block.sequence;
+    }
+    reordered += block.sequence <= last_sequence;
+    last_sequence = block.sequence;
+    ++acquired;
+  }
+  writer.join();
+
+  EXPECT_EQ(torn, 0u);
+  EXPECT_EQ(reordered, 0u);
+  EXPECT_GT(acquired, 0u);
+  EXPECT_EQ(last_sequence, BLOCKS);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
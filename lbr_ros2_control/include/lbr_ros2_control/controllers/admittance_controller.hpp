@@ -1,28 +1,226 @@
 #ifndef LBR_ROS2_CONTROL__ADMITTANCE_CONTROLLER_HPP_
 #define LBR_ROS2_CONTROL__ADMITTANCE_CONTROLLER_HPP_
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "controller_interface/chainable_controller_interface.hpp"
 #include "controller_interface/controller_interface.hpp"
+#include "eigen3/Eigen/Cholesky"
+#include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/Geometry"
+#include "geometry_msgs/msg/pose.hpp"
+#include "hardware_interface/handle.hpp"
 #include "hardware_interface/loaned_command_interface.hpp"
+#include "hardware_interface/loaned_state_interface.hpp"
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
 #include "rclcpp/rclcpp.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "realtime_tools/realtime_buffer.h"
 
 #include "friLBRState.h"
+#include "lbr_fri_idl/msg/lbr_joint_position_command.hpp"
+#include "lbr_ros2_control/controllers/command_age_monitor.hpp"
 #include "lbr_ros2_control/system_interface_type_values.hpp"
 
 namespace lbr_ros2_control {
+struct AdmittanceParameters {
+  using cart_array_t = std::array<double, 6>;
+  cart_array_t mass{10., 10., 10., 1., 1., 1.};          // [kg], [kgm^2]
+  cart_array_t damping{100., 100., 100., 10., 10., 10.}; // [Ns/m], [Nms/rad]
+  cart_array_t stiffness{0., 0., 0., 0., 0., 0.};        // [N/m], [Nm/rad]
+  cart_array_t threshold{2., 2., 2., 0.5, 0.5, 0.5};     // deadband [N], [Nm]
+  double max_linear_velocity{0.1};                       // [m/s]
+  double max_angular_velocity{0.5};                      // [rad/s]
+};
+
+/**
+ * @brief Cartesian admittance M xdd + D xd + K x = f, per axis, with the force-torque f
+ * deadbanded by a threshold. The displacement x is integrated from the twist, i.e. small angles.
+ * Does not allocate.
+ */
 class Admittance {
+public:
+  using cart_vector_t = Eigen::Matrix<double, 6, 1>;
+
+  Admittance(const AdmittanceParameters &parameters = {});
+
+  /**
+   * @brief Reset to rest at zero displacement.
+   *
+   */
+  void reset();
+
+  /**
+   * @brief Integrate with semi-implicit Euler.
+   *
+   * @param[in] f_ext The external force-torque.
+   * @param[in] dt The time step.
+   * @return const cart_vector_t& The twist, limited to the maximum linear and angular velocity.
+   */
+  const cart_vector_t &update(const cart_vector_t &f_ext, const double &dt);
 
-}
+  inline const cart_vector_t &get_twist() const { return twist_; }
+  inline const cart_vector_t &get_displacement() const { return displacement_; }
 
-class AdmittanceController : public controller_interface::ControllerInterface {
+protected:
+  cart_vector_t mass_, damping_, stiffness_, threshold_;
+  double max_linear_velocity_, max_angular_velocity_;
+  cart_vector_t f_, twist_, displacement_;
+};
+
+/**
+ * @brief Admittance of the chain tip, with the parameters, interfaces and state shared by the
+ * admittance controllers. Reads the estimated_ft_sensor, expressed in the chain tip, and the
+ * kinematics of the chain tip with respect to the chain root, see
+ * lbr_ros2_control::SystemInterface, and commands the joint positions.
+ *
+ * The estimated_ft_frame/index is expected to select the chain tip.
+ */
+class ChainTipAdmittance {
+public:
   static constexpr uint8_t CARTESIAN_DOF = 6;
+  static constexpr uint8_t N = KUKA::FRI::LBRState::NUMBER_OF_JOINTS;
+  using cart_vector_t = Admittance::cart_vector_t;
+  using jnt_vector_t = Eigen::Matrix<double, N, 1>;
+  using jacobian_t = Eigen::Matrix<double, CARTESIAN_DOF, N>;
+  using joint_names_t = std::array<std::string, N>;
+
+  ChainTipAdmittance();
+
+  /**
+   * @brief Declare mass, damping, stiffness, threshold, max_linear_velocity,
+   * max_angular_velocity, max_joint_velocity and pinv_damping. Call in on_init().
+   *
+   */
+  void declare_parameters(const std::shared_ptr<rclcpp_lifecycle::LifecycleNode> &node);
+
+  /**
+   * @brief Read the parameters. Call in on_configure().
+   *
+   * @return false if a parameter is invalid.
+   */
+  bool configure(const std::shared_ptr<rclcpp_lifecycle::LifecycleNode> &node);
+
+  controller_interface::InterfaceConfiguration command_interface_configuration() const;
+
+  controller_interface::InterfaceConfiguration state_interface_configuration() const;
+
+  /**
+   * @brief Reference the controller's interfaces, ordered as configured. Call in on_activate().
+   *
+   * @return false if interfaces are missing.
+   */
+  bool
+  reference_interfaces(std::vector<hardware_interface::LoanedCommandInterface> &command_interfaces,
+                       std::vector<hardware_interface::LoanedStateInterface> &state_interfaces,
+                       const rclcpp::Logger &logger);
+
+  /**
+   * @brief Release the references. Call in on_deactivate().
+   *
+   */
+  void clear_interfaces();
+
+  /**
+   * @brief Real-time safe. Read the joint positions, force-torque and kinematics.
+   *
+   * @return false if not finite, e.g. estimation or kinematics disabled.
+   */
+  bool read_state();
+
+  /**
+   * @brief Real-time safe. Reset the admittance to rest.
+   *
+   */
+  void reset();
+
+  /**
+   * @brief Real-time safe. Step the admittance with the external force-torque.
+   *
+   * @param[in] dt The time step.
+   * @return const cart_vector_t& The twist, in the chain root, where the Jacobian is expressed.
+   */
+  const cart_vector_t &update(const double &dt);
+
+  /**
+   * @brief Real-time safe. Limit the joint velocities to max_joint_velocity, preserving the
+   * direction.
+   *
+   */
+  void limit_joint_velocity(jnt_vector_t &dq) const;
+
+  /**
+   * @brief Real-time safe.
+   *
+   */
+  void write_joint_position_command(const jnt_vector_t &q_command);
+
+  inline const joint_names_t &get_joint_names() const { return joint_names_; }
+  inline const AdmittanceParameters &get_parameters() const { return parameters_; }
+  inline const double &get_max_joint_velocity() const { return max_joint_velocity_; }
+  inline const double &get_pinv_damping() const { return pinv_damping_; }
+  inline const jnt_vector_t &get_joint_position() const { return q_; }
+  inline const Eigen::Vector3d &get_position() const { return position_; }
+  inline const Eigen::Quaterniond &get_orientation() const { return orientation_; }
+  inline const Eigen::Matrix3d &get_rotation() const { return rotation_; }
+  inline const jacobian_t &get_jacobian() const { return jacobian_; }
+
+protected:
+  bool parse_cart_array_(const std::shared_ptr<rclcpp_lifecycle::LifecycleNode> &node,
+                         const std::string &name, AdmittanceParameters::cart_array_t &cart_array);
+
+  joint_names_t joint_names_ = {"A1", "A2", "A3", "A4", "A5", "A6", "A7"};
+
+  std::vector<std::reference_wrapper<hardware_interface::LoanedCommandInterface>>
+      joint_position_command_interfaces_;
+  std::vector<std::reference_wrapper<hardware_interface::LoanedStateInterface>>
+      joint_position_state_interfaces_, estimated_ft_sensor_state_interfaces_,
+      position_state_interfaces_, orientation_state_interfaces_, jacobian_state_interfaces_;
+
+  // parameters
+  AdmittanceParameters parameters_;
+  double max_joint_velocity_;
+  double pinv_damping_;
+
+  // admittance and state, the orientation normalized
+  Admittance admittance_;
+  jnt_vector_t q_;
+  cart_vector_t f_ext_, f_ext_root_;
+  jacobian_t jacobian_;
+  Eigen::Vector3d position_;
+  Eigen::Quaterniond orientation_;
+  Eigen::Matrix3d rotation_;
+};
+
+/**
+ * @brief Admittance controller on the chain tip, see lbr_ros2_control::ChainTipAdmittance. The
+ * admittance twist is mapped to joint velocities via the damped least-squares inverse of the
+ * Jacobian and integrated into a joint position offset, which is added to the nominal joint
+ * position.
+ *
+ * Chainable. Exports reference interfaces for the nominal joint position, <name>/A1/position ...,
+ * and the nominal chain tip pose in the chain root, <name>/pose/position.x ...
+ * <name>/pose/orientation.w, e.g. for a joint_trajectory_controller to command within the same
+ * update. NaN references are unset. Joint references take precedence over the pose reference,
+ * which is tracked via the Jacobian. The nominal joint position is held while unset. If not
+ * chained, the references are taken from command/joint_position and command/pose, the latest
+ * received replacing the other. The commanded joint position moves at most at max_joint_velocity.
+ */
+class AdmittanceController : public controller_interface::ChainableControllerInterface {
+  static constexpr uint8_t CARTESIAN_DOF = ChainTipAdmittance::CARTESIAN_DOF;
+  static constexpr uint8_t N = ChainTipAdmittance::N;
+  static constexpr uint8_t POSE_REFERENCES = 7; // position.x ... orientation.w
+  static constexpr char REFERENCE_POSE_PREFIX[] = "pose";
+  using cart_vector_t = ChainTipAdmittance::cart_vector_t;
+  using jnt_vector_t = ChainTipAdmittance::jnt_vector_t;
 
 public:
   AdmittanceController();
@@ -33,8 +231,10 @@ public:
 
   controller_interface::CallbackReturn on_init() override;
 
-  controller_interface::return_type update(const rclcpp::Time &time,
-                                           const rclcpp::Duration &period) override;
+  controller_interface::return_type update_reference_from_subscribers() override;
+
+  controller_interface::return_type
+  update_and_write_commands(const rclcpp::Time &time, const rclcpp::Duration &period) override;
 
   controller_interface::CallbackReturn
   on_configure(const rclcpp_lifecycle::State &previous_state) override;
@@ -46,18 +246,30 @@ public:
   on_deactivate(const rclcpp_lifecycle::State &previous_state) override;
 
 protected:
-  bool reference_command_interfaces_();
-  bool reference_state_interfaces_();
-  void clear_command_interfaces_();
-  void clear_state_interfaces_();
+  std::vector<hardware_interface::CommandInterface> on_export_reference_interfaces() override;
 
-  std::array<std::string, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> joint_names_ = {
-      "A1", "A2", "A3", "A4", "A5", "A6", "A7"};
+  bool on_set_chained_mode(bool chained_mode) override;
 
-  std::vector<std::reference_wrapper<hardware_interface::LoanedCommandInterface>>
-      joint_position_command_interfaces_;
-  std::vector<std::reference_wrapper<hardware_interface::LoanedStateInterface>>
-      estimated_ft_sensor_state_interface_;
+  void clear_reference_interfaces_();
+
+  bool read_nominal_twist_(const double &dt);
+
+  // references from subscribers, if not chained
+  realtime_tools::RealtimeBuffer<StampedCommand<lbr_fri_idl::msg::LBRJointPositionCommand>>
+      rt_joint_position_reference_;
+  realtime_tools::RealtimeBuffer<StampedCommand<geometry_msgs::msg::Pose>> rt_pose_reference_;
+  int64_t last_joint_position_reference_stamp_ns_, last_pose_reference_stamp_ns_;
+  rclcpp::Subscription<lbr_fri_idl::msg::LBRJointPositionCommand>::SharedPtr
+      joint_position_reference_subscription_ptr_;
+  rclcpp::Subscription<geometry_msgs::msg::Pose>::SharedPtr pose_reference_subscription_ptr_;
+
+  // admittance and state
+  ChainTipAdmittance chain_tip_admittance_;
+  bool initialized_;
+  jnt_vector_t q_nominal_, q_offset_, q_command_, dq_;
+  cart_vector_t nominal_twist_;
+  Eigen::Matrix<double, CARTESIAN_DOF, CARTESIAN_DOF> jjt_;
+  Eigen::LDLT<Eigen::Matrix<double, CARTESIAN_DOF, CARTESIAN_DOF>> jjt_ldlt_;
 };
 } // namespace lbr_ros2_control
 #endif // LBR_ROS2_CONTROL__ADMITTANCE_CONTROLLER_HPP_
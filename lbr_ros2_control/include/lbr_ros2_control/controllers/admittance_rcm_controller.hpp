@@ -0,0 +1,146 @@
+#ifndef LBR_ROS2_CONTROL__ADMITTANCE_RCM_CONTROLLER_HPP_
+#define LBR_ROS2_CONTROL__ADMITTANCE_RCM_CONTROLLER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "eigen3/Eigen/Cholesky"
+#include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/Geometry"
+#include "hardware_interface/loaned_command_interface.hpp"
+#include "hardware_interface/loaned_state_interface.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "friLBRState.h"
+#include "lbr_ros2_control/controllers/admittance_controller.hpp"
+#include "lbr_ros2_control/system_interface_type_values.hpp"
+
+namespace lbr_ros2_control {
+/**
+ * @brief Joint velocities that keep a tool shaft through a remote center of motion (RCM) and
+ * otherwise track a twist, in closed form. The shaft is the chain tip's z-axis. The RCM
+ * constraint, i.e. zero velocity of the shaft point closest to the RCM perpendicular to the
+ * shaft, has priority: dq = A^# b + (J N)^# (twist - J A^# b), with the 2 x N constraint Jacobian
+ * A, the drift correction b, and the null-space projector N = I - A^# A. ^# denotes the damped
+ * least-squares inverse.
+ *
+ * Fixed-size, so that solve() runs in constant time without allocation.
+ */
+class RCMSolver {
+public:
+  static constexpr uint8_t CARTESIAN_DOF = 6;
+  static constexpr uint8_t N = KUKA::FRI::LBRState::NUMBER_OF_JOINTS;
+  using cart_vector_t = Eigen::Matrix<double, CARTESIAN_DOF, 1>;
+  using jnt_vector_t = Eigen::Matrix<double, N, 1>;
+  using jacobian_t = Eigen::Matrix<double, CARTESIAN_DOF, N>;
+
+  /**
+   * @brief Construct a new RCMSolver.
+   *
+   * @param[in] rcm_gain Drift correction towards the RCM [1/s].
+   * @param[in] pinv_damping Damping of the damped least-squares inverses.
+   */
+  RCMSolver(const double &rcm_gain = 10., const double &pinv_damping = 0.05);
+
+  /**
+   * @brief Place the RCM on the shaft.
+   *
+   * @param[in] position The chain tip position.
+   * @param[in] rotation The chain tip orientation.
+   * @param[in] distance Distance of the RCM from the chain tip along the shaft.
+   */
+  void set_rcm(const Eigen::Vector3d &position, const Eigen::Matrix3d &rotation,
+               const double &distance);
+
+  /**
+   * @brief Solve for the joint velocities.
+   *
+   * @param[in] position The chain tip position.
+   * @param[in] rotation The chain tip orientation.
+   * @param[in] jacobian The chain tip Jacobian, reference point chain tip, in the chain root.
+   * @param[in] twist The desired chain tip twist, in the chain root.
+   * @return const jnt_vector_t& The joint velocities.
+   */
+  const jnt_vector_t &solve(const Eigen::Vector3d &position, const Eigen::Matrix3d &rotation,
+                            const jacobian_t &jacobian, const cart_vector_t &twist);
+
+  inline const Eigen::Vector3d &get_rcm() const { return rcm_; }
+
+  /**
+   * @brief Distance of the shaft from the RCM, as of the last solve().
+   *
+   */
+  inline double get_rcm_error() const { return rcm_error_.norm(); }
+
+protected:
+  double rcm_gain_, pinv_damping_;
+  Eigen::Vector3d rcm_, rcm_error_;
+
+  // constraint, A dq = b
+  Eigen::Matrix<double, 3, N> shaft_jacobian_;
+  Eigen::Matrix<double, 2, N> a_;
+  Eigen::Vector2d b_;
+  Eigen::Matrix2d aat_;
+  Eigen::LDLT<Eigen::Matrix2d> aat_ldlt_;
+  Eigen::Matrix<double, 2, N> a_pinv_t_;
+  Eigen::Matrix<double, N, N> nullspace_projector_;
+
+  // task in the constraint's null-space
+  jacobian_t jn_;
+  Eigen::Matrix<double, CARTESIAN_DOF, CARTESIAN_DOF> jnjnt_;
+  Eigen::LDLT<Eigen::Matrix<double, CARTESIAN_DOF, CARTESIAN_DOF>> jnjnt_ldlt_;
+  cart_vector_t twist_residual_;
+  jnt_vector_t dq_;
+};
+
+/**
+ * @brief Admittance controller on the chain tip, constrained to a remote center of motion (RCM),
+ * e.g. for minimally invasive surgery. As lbr_ros2_control::AdmittanceController, but the
+ * admittance twist is mapped to joint velocities via the RCMSolver. The RCM is placed on the
+ * chain tip's z-axis at rcm_distance on activation.
+ */
+class AdmittanceRCMController : public controller_interface::ControllerInterface {
+  using cart_vector_t = RCMSolver::cart_vector_t;
+  using jnt_vector_t = RCMSolver::jnt_vector_t;
+
+public:
+  AdmittanceRCMController();
+
+  controller_interface::InterfaceConfiguration command_interface_configuration() const override;
+
+  controller_interface::InterfaceConfiguration state_interface_configuration() const override;
+
+  controller_interface::CallbackReturn on_init() override;
+
+  controller_interface::return_type update(const rclcpp::Time &time,
+                                           const rclcpp::Duration &period) override;
+
+  controller_interface::CallbackReturn
+  on_configure(const rclcpp_lifecycle::State &previous_state) override;
+
+  controller_interface::CallbackReturn
+  on_activate(const rclcpp_lifecycle::State &previous_state) override;
+
+  controller_interface::CallbackReturn
+  on_deactivate(const rclcpp_lifecycle::State &previous_state) override;
+
+protected:
+  // parameters
+  double rcm_distance_, rcm_gain_;
+
+  // admittance, RCM and state
+  ChainTipAdmittance chain_tip_admittance_;
+  RCMSolver rcm_solver_;
+  bool initialized_;
+  jnt_vector_t q_command_, dq_;
+};
+} // namespace lbr_ros2_control
+#endif // LBR_ROS2_CONTROL__ADMITTANCE_RCM_CONTROLLER_HPP_
@@ -0,0 +1,111 @@
+#ifndef LBR_ROS2_CONTROL__CARTESIAN_IMPEDANCE_CONTROLLER_HPP_
+#define LBR_ROS2_CONTROL__CARTESIAN_IMPEDANCE_CONTROLLER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "eigen3/Eigen/Cholesky"
+#include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/Geometry"
+#include "geometry_msgs/msg/pose.hpp"
+#include "hardware_interface/loaned_command_interface.hpp"
+#include "hardware_interface/loaned_state_interface.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "realtime_tools/realtime_buffer.h"
+
+#include "friLBRState.h"
+#include "lbr_ros2_control/controllers/command_age_monitor.hpp"
+#include "lbr_ros2_control/system_interface_type_values.hpp"
+
+namespace lbr_ros2_control {
+/**
+ * @brief Cartesian impedance of the chain tip in TORQUE client command mode,
+ * tau = J^T (K e - D J dq) + N (K_n (q_n - q) - D_n dq). The pose error e is taken with respect
+ * to the target pose in the chain root, the pose at activation until one is received on
+ * command/pose. The null-space posture q_n is the joint position at activation.
+ * N = I - J^T J^#^T projects with the damped least-squares inverse J^#, so that the posture does
+ * not disturb the chain tip.
+ *
+ * Reads the chain tip pose and Jacobian from the kinematics state interfaces, see
+ * lbr_ros2_control::SystemInterface, which are evaluated once per cycle. Gravity is compensated by
+ * the robot in TORQUE client command mode, the torques are overlaid.
+ */
+class CartesianImpedanceController : public controller_interface::ControllerInterface {
+  static constexpr uint8_t CARTESIAN_DOF = 6;
+  static constexpr uint8_t N = KUKA::FRI::LBRState::NUMBER_OF_JOINTS;
+  using cart_vector_t = Eigen::Matrix<double, CARTESIAN_DOF, 1>;
+  using jnt_vector_t = Eigen::Matrix<double, N, 1>;
+  using jacobian_t = Eigen::Matrix<double, CARTESIAN_DOF, N>;
+
+public:
+  CartesianImpedanceController();
+
+  controller_interface::InterfaceConfiguration command_interface_configuration() const override;
+
+  controller_interface::InterfaceConfiguration state_interface_configuration() const override;
+
+  controller_interface::CallbackReturn on_init() override;
+
+  controller_interface::return_type update(const rclcpp::Time &time,
+                                           const rclcpp::Duration &period) override;
+
+  controller_interface::CallbackReturn
+  on_configure(const rclcpp_lifecycle::State &previous_state) override;
+
+  controller_interface::CallbackReturn
+  on_activate(const rclcpp_lifecycle::State &previous_state) override;
+
+  controller_interface::CallbackReturn
+  on_deactivate(const rclcpp_lifecycle::State &previous_state) override;
+
+protected:
+  bool reference_command_interfaces_();
+  bool reference_state_interfaces_();
+  void clear_command_interfaces_();
+  void clear_state_interfaces_();
+
+  bool read_state_();
+  bool parse_cart_vector_(const std::string &name, cart_vector_t &cart_vector);
+
+  std::array<std::string, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> joint_names_ = {
+      "A1", "A2", "A3", "A4", "A5", "A6", "A7"};
+
+  std::vector<std::reference_wrapper<hardware_interface::LoanedCommandInterface>>
+      joint_position_command_interfaces_, torque_command_interfaces_;
+  std::vector<std::reference_wrapper<hardware_interface::LoanedStateInterface>>
+      joint_position_state_interfaces_, joint_velocity_state_interfaces_,
+      position_state_interfaces_, orientation_state_interfaces_, jacobian_state_interfaces_;
+
+  // parameters
+  cart_vector_t stiffness_, damping_;
+  double nullspace_stiffness_, nullspace_damping_;
+  double pinv_damping_;
+  double max_torque_;
+
+  // target pose, chain root
+  realtime_tools::RealtimeBuffer<StampedCommand<geometry_msgs::msg::Pose>> rt_target_pose_;
+  int64_t last_target_pose_stamp_ns_;
+  rclcpp::Subscription<geometry_msgs::msg::Pose>::SharedPtr target_pose_subscription_ptr_;
+
+  // state and impedance
+  bool initialized_;
+  jnt_vector_t q_, dq_, q_nullspace_, tau_;
+  jacobian_t jacobian_;
+  Eigen::Vector3d position_, target_position_;
+  Eigen::Quaterniond orientation_, target_orientation_;
+  cart_vector_t error_, twist_, wrench_;
+  Eigen::Matrix<double, CARTESIAN_DOF, CARTESIAN_DOF> jjt_;
+  Eigen::LDLT<Eigen::Matrix<double, CARTESIAN_DOF, CARTESIAN_DOF>> jjt_ldlt_;
+  Eigen::Matrix<double, CARTESIAN_DOF, N> jacobian_pinv_t_;
+  Eigen::Matrix<double, N, N> nullspace_projector_;
+};
+} // namespace lbr_ros2_control
+#endif // LBR_ROS2_CONTROL__CARTESIAN_IMPEDANCE_CONTROLLER_HPP_
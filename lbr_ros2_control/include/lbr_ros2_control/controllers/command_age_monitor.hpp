@@ -0,0 +1,115 @@
+#ifndef LBR_ROS2_CONTROL__COMMAND_AGE_MONITOR_HPP_
+#define LBR_ROS2_CONTROL__COMMAND_AGE_MONITOR_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "diagnostic_msgs/msg/diagnostic_array.hpp"
+#include "diagnostic_msgs/msg/diagnostic_status.hpp"
+#include "diagnostic_msgs/msg/key_value.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp/strategies/message_pool_memory_strategy.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+
+namespace lbr_ros2_control {
+/**
+ * @brief Command with the time it was sent, system clock. Stored by value in the controllers'
+ * realtime_tools::RealtimeBuffer. The command messages are fixed size, so that neither writing
+ * nor reading the buffer allocates or frees, unlike storing a SharedPtr.
+ *
+ * @tparam MessageT Command message type.
+ */
+template <class MessageT> struct StampedCommand {
+  MessageT msg;
+  int64_t stamp_ns{0}; // 0 if no command was received
+};
+
+/**
+ * @brief Preallocated messages for the command subscriptions, instead of one allocation per
+ * received message. Messages are returned to the pool after the callback, which copies them into
+ * a StampedCommand.
+ *
+ * @tparam MessageT Command message type, has to be fixed size.
+ */
+template <class MessageT>
+using command_message_pool_t =
+    rclcpp::strategies::message_pool_memory_strategy::MessagePoolMemoryStrategy<MessageT, 4>;
+
+/**
+ * @brief Measures the sender-to-hardware latency of commands and rejects stale commands, for the
+ * LBR command controllers. Commands are stamped with the middleware's source time stamp, see
+ * rclcpp::MessageInfo, so sender and controller_manager clocks need to be synchronized across
+ * machines. Latency statistics are published as diagnostics on /diagnostics, from a timer on
+ * the controller's node.
+ *
+ * Stale commands, i.e. older than max_command_age, are either held, or, for torque and wrench
+ * overlays, decayed to zero with decay_time_constant. Joint positions are always held.
+ */
+class CommandAgeMonitor {
+public:
+  enum class StaleBehavior { HOLD, DECAY };
+
+  CommandAgeMonitor();
+
+  /**
+   * @brief Declare max_command_age, stale_command_behavior, decay_time_constant and
+   * diagnostics_period. Call in on_init().
+   *
+   */
+  void declare_parameters(const std::shared_ptr<rclcpp_lifecycle::LifecycleNode> &node);
+
+  /**
+   * @brief Read the parameters and start the diagnostics timer. Call in on_configure().
+   *
+   * @return false if a parameter is invalid.
+   */
+  bool configure(const std::shared_ptr<rclcpp_lifecycle::LifecycleNode> &node);
+
+  /**
+   * @brief Non real-time. Stamp of a received command, the source time stamp if the middleware
+   * provides one, else the reception time.
+   *
+   */
+  static int64_t stamp(const rclcpp::MessageInfo &message_info);
+
+  /**
+   * @brief Real-time safe. Check the age of the command that is about to be applied. Each
+   * command enters the latency statistics once, when first applied.
+   *
+   * @param[in] stamp_ns The command's stamp, see stamp().
+   * @param[in] is_new Whether the command is applied for the first time.
+   * @return true if the command is fresh, always true if max_command_age is disabled.
+   */
+  bool is_fresh(const int64_t &stamp_ns, const bool &is_new);
+
+  /**
+   * @brief Factor by which to scale torque and wrench overlays per update while stale, 1 if
+   * stale commands are held.
+   *
+   */
+  double decay_factor(const double &dt) const;
+
+protected:
+  void publish_diagnostics_();
+
+  double max_command_age_;
+  StaleBehavior stale_behavior_;
+  double decay_time_constant_;
+
+  // written by update(), read and reset by the diagnostics timer
+  std::atomic<uint64_t> commands_, stale_updates_;
+  std::atomic<int64_t> latency_sum_ns_, latency_max_ns_;
+
+  std::string name_;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_publisher_ptr_;
+  rclcpp::TimerBase::SharedPtr diagnostics_timer_ptr_;
+  rclcpp::Clock::SharedPtr clock_ptr_;
+};
+} // namespace lbr_ros2_control
+#endif // LBR_ROS2_CONTROL__COMMAND_AGE_MONITOR_HPP_
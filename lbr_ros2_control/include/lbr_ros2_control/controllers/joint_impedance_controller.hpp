@@ -0,0 +1,130 @@
+#ifndef LBR_ROS2_CONTROL__JOINT_IMPEDANCE_CONTROLLER_HPP_
+#define LBR_ROS2_CONTROL__JOINT_IMPEDANCE_CONTROLLER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "hardware_interface/loaned_command_interface.hpp"
+#include "hardware_interface/loaned_state_interface.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "kdl/chain.hpp"
+#include "kdl/chaindynparam.hpp"
+#include "kdl/jntarray.hpp"
+#include "kdl/tree.hpp"
+#include "kdl_parser/kdl_parser.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "realtime_tools/realtime_buffer.h"
+#include "std_msgs/msg/string.hpp"
+
+#include "friLBRState.h"
+#include "lbr_fri_idl/msg/lbr_joint_position_command.hpp"
+#include "lbr_ros2_control/controllers/command_age_monitor.hpp"
+
+namespace lbr_ros2_control {
+/**
+ * @brief Joint impedance in TORQUE client command mode, tau = K (q_d - q) - D dq + g(q) + c(q, dq).
+ * The setpoint q_d is the joint position at activation until one is received on
+ * command/joint_position.
+ *
+ * Stiffness and damping can be changed at runtime, the gains are ramped to the new values within
+ * gain_ramp_time. Gravity g and Coriolis c are optionally computed with KDL from the robot
+ * description, the robot_description parameter or, if empty, the latched robot_description topic,
+ * which is awaited for robot_description_timeout at configuration. Gravity is compensated by the
+ * robot in TORQUE client command mode, so gravity_compensation is meant for robots, e.g.
+ * simulated, that do not.
+ */
+class JointImpedanceController : public controller_interface::ControllerInterface {
+  static constexpr uint8_t N = KUKA::FRI::LBRState::NUMBER_OF_JOINTS;
+  using jnt_array_t = std::array<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS>;
+
+  struct Gains {
+    jnt_array_t stiffness, damping;
+    uint64_t revision{0};
+  };
+
+public:
+  JointImpedanceController();
+
+  controller_interface::InterfaceConfiguration command_interface_configuration() const override;
+
+  controller_interface::InterfaceConfiguration state_interface_configuration() const override;
+
+  controller_interface::CallbackReturn on_init() override;
+
+  controller_interface::return_type update(const rclcpp::Time &time,
+                                           const rclcpp::Duration &period) override;
+
+  controller_interface::CallbackReturn
+  on_configure(const rclcpp_lifecycle::State &previous_state) override;
+
+  controller_interface::CallbackReturn
+  on_activate(const rclcpp_lifecycle::State &previous_state) override;
+
+  controller_interface::CallbackReturn
+  on_deactivate(const rclcpp_lifecycle::State &previous_state) override;
+
+protected:
+  bool reference_command_interfaces_();
+  bool reference_state_interfaces_();
+  void clear_command_interfaces_();
+  void clear_state_interfaces_();
+
+  bool read_state_();
+  bool configure_dynamics_();
+  rcl_interfaces::msg::SetParametersResult
+  on_set_gains_(const std::vector<rclcpp::Parameter> &parameters);
+  void ramp_gains_(const double &dt);
+
+  std::array<std::string, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> joint_names_ = {
+      "A1", "A2", "A3", "A4", "A5", "A6", "A7"};
+
+  std::vector<std::reference_wrapper<hardware_interface::LoanedCommandInterface>>
+      joint_position_command_interfaces_, torque_command_interfaces_;
+  std::vector<std::reference_wrapper<hardware_interface::LoanedStateInterface>>
+      joint_position_state_interfaces_, joint_velocity_state_interfaces_;
+
+  // parameters
+  double gain_ramp_time_;
+  double max_torque_;
+  bool gravity_compensation_, coriolis_compensation_;
+
+  // gains, target set from the parameter callback
+  Gains target_gains_nrt_;
+  std::mutex target_gains_nrt_mutex_;
+  realtime_tools::RealtimeBuffer<Gains> rt_target_gains_;
+  rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr on_set_gains_handle_ptr_;
+  Gains gains_, ramp_start_gains_;
+  double ramp_progress_;
+
+  // joint position setpoint
+  realtime_tools::RealtimeBuffer<StampedCommand<lbr_fri_idl::msg::LBRJointPositionCommand>>
+      rt_setpoint_;
+  int64_t last_setpoint_stamp_ns_;
+  rclcpp::Subscription<lbr_fri_idl::msg::LBRJointPositionCommand>::SharedPtr
+      setpoint_subscription_ptr_;
+
+  // dynamics model from the robot description
+  std::string robot_description_;
+  std::mutex robot_description_mutex_;
+  std::condition_variable robot_description_cv_;
+  rclcpp::Subscription<std_msgs::msg::String>::SharedPtr robot_description_subscription_ptr_;
+  std::unique_ptr<KDL::ChainDynParam> chain_dyn_param_ptr_;
+  KDL::JntArray q_kdl_, dq_kdl_, gravity_kdl_, coriolis_kdl_;
+
+  // state and impedance
+  bool initialized_;
+  jnt_array_t q_, dq_, q_setpoint_;
+};
+} // namespace lbr_ros2_control
+#endif // LBR_ROS2_CONTROL__JOINT_IMPEDANCE_CONTROLLER_HPP_
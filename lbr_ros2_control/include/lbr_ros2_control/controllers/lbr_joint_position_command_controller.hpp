@@ -15,6 +15,7 @@
 #include "friLBRState.h"
 
 #include "lbr_fri_idl/msg/lbr_joint_position_command.hpp"
+#include "lbr_ros2_control/controllers/command_age_monitor.hpp"
 
 namespace lbr_ros2_control {
 class LBRJointPositionCommandController : public controller_interface::ControllerInterface {
@@ -43,10 +44,13 @@ protected:
   std::array<std::string, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> joint_names_ = {
       "A1", "A2", "A3", "A4", "A5", "A6", "A7"};
 
-  realtime_tools::RealtimeBuffer<lbr_fri_idl::msg::LBRJointPositionCommand::SharedPtr>
+  realtime_tools::RealtimeBuffer<StampedCommand<lbr_fri_idl::msg::LBRJointPositionCommand>>
       rt_lbr_joint_position_command_ptr_;
   rclcpp::Subscription<lbr_fri_idl::msg::LBRJointPositionCommand>::SharedPtr
       lbr_joint_position_command_subscription_ptr_;
+
+  CommandAgeMonitor command_age_monitor_;
+  int64_t last_stamp_ns_;
 };
 } // namespace lbr_ros2_control
 #endif // LBR_ROS2_CONTROL__LBR_JOINT_POSITION_COMMAND_CONTROLLER_HPP_
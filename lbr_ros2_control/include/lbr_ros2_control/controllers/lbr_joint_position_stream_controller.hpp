@@ -0,0 +1,124 @@
+#ifndef LBR_ROS2_CONTROL__LBR_JOINT_POSITION_STREAM_CONTROLLER_HPP_
+#define LBR_ROS2_CONTROL__LBR_JOINT_POSITION_STREAM_CONTROLLER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "controller_interface/controller_interface.hpp"
+#include "hardware_interface/loaned_command_interface.hpp"
+#include "hardware_interface/loaned_state_interface.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "trajectory_msgs/msg/joint_trajectory.hpp"
+
+#include "friLBRState.h"
+
+#include "lbr_fri_ros2/spsc_ring.hpp"
+
+namespace lbr_ros2_control {
+/**
+ * @brief Executes streamed chunks of future joint position setpoints against the controller
+ * clock. Each trajectory_msgs::msg::JointTrajectory on command/joint_position_stream carries
+ * setpoints at header.stamp + time_from_start, e.g. the next 50 ms, so that senders can batch
+ * setpoints and tolerate gaps shorter than a chunk. Setpoints are queued in a preallocated
+ * lbr_fri_ros2::SPSCRing and linearly interpolated in update().
+ *
+ * Setpoints must be strictly increasing in time across chunks, setpoints at or before the last
+ * queued one are dropped. Once the controller clock passes the last queued setpoint, the stream
+ * is drained and the last setpoint is held. It restarts from the current command with the next
+ * future setpoint, setpoints already due are dropped. A drained stream is an underrun if the next
+ * setpoints arrive already due, i.e. the sender fell behind, and finished otherwise. Setpoints
+ * that are not finite are dropped. Commanded joint velocities are limited to max_joint_velocity.
+ *
+ * Unstamped chunks are stamped on reception with the node clock. The time passed to update(),
+ * i.e. the controller_manager's, must be the same clock, e.g. the ROS time, as are the stamps.
+ *
+ * The ring_capacity is allocated once on init, where the subscription is created.
+ */
+class LBRJointPositionStreamController : public controller_interface::ControllerInterface {
+protected:
+  static constexpr uint8_t N = KUKA::FRI::LBRState::NUMBER_OF_JOINTS;
+  using jnt_array_t = std::array<double, N>;
+
+  struct Setpoint {
+    int64_t time_ns;
+    jnt_array_t joint_position;
+  };
+
+public:
+  LBRJointPositionStreamController();
+
+  controller_interface::InterfaceConfiguration command_interface_configuration() const override;
+
+  controller_interface::InterfaceConfiguration state_interface_configuration() const override;
+
+  controller_interface::CallbackReturn on_init() override;
+
+  controller_interface::return_type update(const rclcpp::Time &time,
+                                           const rclcpp::Duration &period) override;
+
+  controller_interface::CallbackReturn
+  on_configure(const rclcpp_lifecycle::State &previous_state) override;
+
+  controller_interface::CallbackReturn
+  on_activate(const rclcpp_lifecycle::State &previous_state) override;
+
+  controller_interface::CallbackReturn
+  on_deactivate(const rclcpp_lifecycle::State &previous_state) override;
+
+protected:
+  bool reference_command_interfaces_();
+  bool reference_state_interfaces_();
+  void clear_command_interfaces_();
+  void clear_state_interfaces_();
+
+  /**
+   * @brief Non real-time. Queue the setpoints of a chunk and report underruns.
+   *
+   */
+  void queue_setpoints_(const trajectory_msgs::msg::JointTrajectory &joint_trajectory);
+
+  /**
+   * @brief Real-time. Advance the stream to time and interpolate the target joint position.
+   * Starts from the current command, i.e. q_command_, and holds q_target_ while not streaming.
+   *
+   */
+  void advance_(const int64_t &time_ns);
+
+  std::array<std::string, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> joint_names_ = {
+      "A1", "A2", "A3", "A4", "A5", "A6", "A7"};
+
+  std::vector<std::reference_wrapper<hardware_interface::LoanedCommandInterface>>
+      joint_position_command_interfaces_;
+  std::vector<std::reference_wrapper<hardware_interface::LoanedStateInterface>>
+      joint_position_state_interfaces_;
+
+  // parameters
+  double max_joint_velocity_;
+
+  // subscription thread
+  rclcpp::Subscription<trajectory_msgs::msg::JointTrajectory>::SharedPtr
+      joint_trajectory_subscription_ptr_;
+  int64_t last_queued_time_ns_;
+  uint64_t reported_underruns_, reported_late_setpoints_;
+
+  // shared
+  lbr_fri_ros2::SPSCRing<Setpoint> setpoint_ring_;
+  std::atomic<uint64_t> underruns_, late_setpoints_;
+
+  // update thread
+  bool initialized_, streaming_, drained_;
+  Setpoint previous_, next_, setpoint_;
+  jnt_array_t q_target_, q_command_;
+};
+} // namespace lbr_ros2_control
+#endif // LBR_ROS2_CONTROL__LBR_JOINT_POSITION_STREAM_CONTROLLER_HPP_
@@ -2,14 +2,20 @@
 #define LBR_ROS2_CONTROL__LBR_STATE_BROADCASTER_HPP_
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <limits>
-#include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "controller_interface/controller_interface.hpp"
+#include "hardware_interface/loaned_state_interface.hpp"
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "realtime_tools/realtime_publisher.h"
@@ -19,12 +25,25 @@
 #include "friLBRState.h"
 
 #include "lbr_fri_idl/msg/lbr_state.hpp"
+#include "lbr_fri_ros2/spsc_ring.hpp"
 #include "lbr_ros2_control/system_interface_type_values.hpp"
 
 namespace lbr_ros2_control {
+/**
+ * @brief Publishes the LBRState on ``state``. By default, the latest state is published through a
+ * realtime_tools::RealtimePublisher, which skips samples whenever its thread lags behind. In
+ * lossless mode, every sample is queued in a preallocated lbr_fri_ros2::SPSCRing instead, and a
+ * publisher thread drains the ring in batches of batch_size samples. Decimated topics
+ * additionally publish every n-th sample for low-rate consumers, e.g. visualization.
+ *
+ * With loaned_messages, the state is written into middleware-owned memory via
+ * borrow_loaned_message and published without a copy, directly from update() or the publisher
+ * thread. Falls back to the above if the middleware cannot loan.
+ */
 class LBRStateBroadcaster : public controller_interface::ControllerInterface {
 public:
-  LBRStateBroadcaster() = default;
+  LBRStateBroadcaster();
+  ~LBRStateBroadcaster();
 
   controller_interface::InterfaceConfiguration command_interface_configuration() const override;
 
@@ -45,16 +64,70 @@ public:
   on_deactivate(const rclcpp_lifecycle::State &previous_state) override;
 
 protected:
-  void init_state_interface_map_();
+  template <typename T>
+  using state_interface_field_t = std::pair<const hardware_interface::LoanedStateInterface *, T *>;
+
+  /**
+   * @brief Resolve the state interfaces into typed state message fields, so that update()
+   * copies without lookups. Interfaces that are not exported leave their field at NaN.
+   *
+   */
+  void init_state_interface_fields_();
   void init_state_msg_();
 
+  template <typename T>
+  void bind_state_interface_field_(const std::string &prefix_name,
+                                   const std::string &interface_name, T *field,
+                                   std::vector<state_interface_field_t<T>> &fields);
+
+  bool init_decimated_publishers_();
+
+  /**
+   * @brief Lossless mode only. Drains the state ring every batch_size samples until publishing_
+   * is reset, then flushes the remaining samples.
+   *
+   */
+  void publish_loop_();
+  void drain_state_ring_();
+
+  /**
+   * @brief Publish state on the state topic, via a loaned message if loan_state_.
+   *
+   */
+  void publish_state_(const lbr_fri_idl::msg::LBRState &state);
+
   std::array<std::string, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> joint_names_ = {
       "A1", "A2", "A3", "A4", "A5", "A6", "A7"};
-  std::unordered_map<std::string, std::unordered_map<std::string, double>> state_interface_map_;
+
+  // flat state interface to state_ field tables, resolved on activation
+  std::vector<state_interface_field_t<double>> double_fields_;
+  std::vector<state_interface_field_t<int8_t>> int8_fields_;
+  std::vector<state_interface_field_t<uint32_t>> uint32_fields_;
+  lbr_fri_idl::msg::LBRState state_;
 
   rclcpp::Publisher<lbr_fri_idl::msg::LBRState>::SharedPtr state_publisher_ptr_;
   std::shared_ptr<realtime_tools::RealtimePublisher<lbr_fri_idl::msg::LBRState>>
       rt_state_publisher_ptr_;
+  bool loan_state_;
+
+  // lossless, batched publishing
+  bool lossless_;
+  std::size_t batch_size_;
+  lbr_fri_ros2::SPSCRing<lbr_fri_idl::msg::LBRState> state_ring_;
+  lbr_fri_idl::msg::LBRState batch_state_;
+  std::thread publish_thread_;
+  std::atomic_bool publishing_;
+  std::atomic<std::uint64_t> dropped_samples_;
+
+  // decimated publishing
+  struct DecimatedPublisher {
+    std::uint64_t decimation;
+    rclcpp::Publisher<lbr_fri_idl::msg::LBRState>::SharedPtr publisher_ptr;
+    std::shared_ptr<realtime_tools::RealtimePublisher<lbr_fri_idl::msg::LBRState>>
+        rt_publisher_ptr;
+  };
+  std::vector<DecimatedPublisher> decimated_publishers_;
+  std::uint64_t sample_count_;
 };
 } // namespace lbr_ros2_control
 #endif // LBR_ROS2_CONTROL__LBR_STATE_BROADCASTER_HPP_
@@ -17,6 +17,7 @@
 #include "friLBRState.h"
 
 #include "lbr_fri_idl/msg/lbr_torque_command.hpp"
+#include "lbr_ros2_control/controllers/command_age_monitor.hpp"
 
 namespace lbr_ros2_control {
 class LBRTorqueCommandController : public controller_interface::ControllerInterface {
@@ -51,10 +52,13 @@ protected:
   std::vector<std::reference_wrapper<hardware_interface::LoanedCommandInterface>>
       joint_position_command_interfaces_, torque_command_interfaces_;
 
-  realtime_tools::RealtimeBuffer<lbr_fri_idl::msg::LBRTorqueCommand::SharedPtr>
+  realtime_tools::RealtimeBuffer<StampedCommand<lbr_fri_idl::msg::LBRTorqueCommand>>
       rt_lbr_torque_command_ptr_;
   rclcpp::Subscription<lbr_fri_idl::msg::LBRTorqueCommand>::SharedPtr
       lbr_torque_command_subscription_ptr_;
+
+  CommandAgeMonitor command_age_monitor_;
+  int64_t last_stamp_ns_;
 };
 } // namespace lbr_ros2_control
 #endif // LBR_ROS2_CONTROL__LBR_TORQUE_COMMAND_CONTROLLER_HPP_
@@ -17,6 +17,7 @@
 #include "friLBRState.h"
 
 #include "lbr_fri_idl/msg/lbr_wrench_command.hpp"
+#include "lbr_ros2_control/controllers/command_age_monitor.hpp"
 #include "lbr_ros2_control/system_interface_type_values.hpp"
 
 namespace lbr_ros2_control {
@@ -54,10 +55,13 @@ protected:
   std::vector<std::reference_wrapper<hardware_interface::LoanedCommandInterface>>
       joint_position_command_interfaces_, wrench_command_interfaces_;
 
-  realtime_tools::RealtimeBuffer<lbr_fri_idl::msg::LBRWrenchCommand::SharedPtr>
+  realtime_tools::RealtimeBuffer<StampedCommand<lbr_fri_idl::msg::LBRWrenchCommand>>
       rt_lbr_wrench_command_ptr_;
   rclcpp::Subscription<lbr_fri_idl::msg::LBRWrenchCommand>::SharedPtr
       lbr_wrench_command_subscription_ptr_;
+
+  CommandAgeMonitor command_age_monitor_;
+  int64_t last_stamp_ns_;
 };
 } // namespace lbr_ros2_control
 #endif // LBR_ROS2_CONTROL__LBR_WRENCH_COMMAND_CONTROLLER_HPP_
@@ -0,0 +1,98 @@
+#ifndef LBR_ROS2_CONTROL__MOCK_SYSTEM_INTERFACE_HPP_
+#define LBR_ROS2_CONTROL__MOCK_SYSTEM_INTERFACE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lbr_fri_ros2/cycle_sync.hpp"
+#include "lbr_fri_ros2/triple_buffer.hpp"
+#include "lbr_ros2_control/system_interface.hpp"
+
+namespace lbr_ros2_control {
+struct MockSystemInterfaceParameters {
+  double sample_time{0.005};
+  uint32_t session_transition_cycles{10};
+  uint32_t ipo_lag_cycles{2};
+  std::array<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> initial_joint_position{0., 0., 0., 0.,
+                                                                                   0., 0., 0.};
+  std::array<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> external_torque{0., 0., 0., 0.,
+                                                                            0., 0., 0.};
+  bool free_running{false};
+};
+
+/**
+ * @brief Emulates the robot side of the FRI in place of the UDP connection, so that all LBR
+ * specific interfaces and controllers can be run without a robot. The emulated robot steps
+ * through the session states up to COMMANDING_ACTIVE, interpolates commanded joint positions
+ * with a fixed lag of the IPO joint position and reports an injectable external torque.
+ *
+ * Torques follow the FRI, i.e. the measured torque is the model torque plus the external torque.
+ * The emulated robot is rigid and gravity compensated, its model torque is the commanded torque,
+ * and the reported external torque is the injected constant.
+ *
+ * If free running, the emulation is stepped in lockstep with the lbr_ros2_control_node, see
+ * lbr_fri_ros2::CycleSync, and runs as fast as read, update and write permit. The emulated time
+ * stamps are then the controllers' clock.
+ */
+class MockSystemInterface : public SystemInterface {
+protected:
+  static constexpr char LOGGER_NAME[] = "lbr_ros2_control::MockSystemInterface";
+
+public:
+  MockSystemInterface() = default;
+  ~MockSystemInterface();
+
+  controller_interface::CallbackReturn
+  on_init(const hardware_interface::HardwareInfo &info) override;
+  controller_interface::CallbackReturn
+  on_activate(const rclcpp_lifecycle::State &previous_state) override;
+  controller_interface::CallbackReturn
+  on_deactivate(const rclcpp_lifecycle::State &previous_state) override;
+
+protected:
+  bool parse_mock_parameters_();
+  bool parse_joint_array_(const std::string &name,
+                          std::array<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> &joint_array);
+
+  // emulated robot side
+  bool state_initialized_() override;
+  const lbr_fri_ros2::StateBlock &get_state_block_() override;
+  void buffer_command_target_(const lbr_fri_idl::msg::LBRCommand &command) override;
+  bool get_client_command_mode_(KUKA::FRI::EClientCommandMode &client_command_mode) const override;
+
+  void reset_();
+  void run_();
+  void step_();
+  void publish_state_block_();
+
+  // joint motion and torques, given the IPO joint position, commanded and external torque
+  virtual void reset_joints_();
+  virtual void emulate_joints_();
+
+  MockSystemInterfaceParameters mock_parameters_;
+
+  std::thread run_thread_;
+  std::atomic_bool running_{false};
+  std::atomic_bool state_initialized_flag_{false};
+
+  // emulated robot
+  uint64_t cycle_{0};
+  KUKA::FRI::ESessionState session_state_{KUKA::FRI::ESessionState::IDLE};
+  lbr_fri_idl::msg::LBRState state_;
+  lbr_fri_idl::msg::LBRCommand command_;
+  std::vector<lbr_fri_idl::msg::LBRState::_ipo_joint_position_type> ipo_lag_;
+
+  // exchange with the ros2_control thread
+  lbr_fri_ros2::TripleBuffer<lbr_fri_ros2::StateBlock> state_blocks_;
+  lbr_fri_ros2::TripleBuffer<lbr_fri_idl::msg::LBRCommand> commands_;
+};
+} // namespace lbr_ros2_control
+#endif // LBR_ROS2_CONTROL__MOCK_SYSTEM_INTERFACE_HPP_
@@ -0,0 +1,44 @@
+#ifndef LBR_ROS2_CONTROL__SIM_SYSTEM_INTERFACE_HPP_
+#define LBR_ROS2_CONTROL__SIM_SYSTEM_INTERFACE_HPP_
+
+#include <memory>
+#include <string>
+
+#include "lbr_fri_ros2/dynamics_simulator.hpp"
+#include "lbr_ros2_control/mock_system_interface.hpp"
+
+namespace lbr_ros2_control {
+/**
+ * @brief Emulates the FRI like the MockSystemInterface, but moves the joints with an in-process
+ * rigid-body simulation of the robot under its joint impedance controller, see
+ * lbr_fri_ros2::DynamicsSimulator. Link inertias are taken from the robot description. Commanded
+ * torques and wrenches are overlaid. The external torque is reported as by the FRI, i.e. the
+ * measured minus the model torque, and settles to the injected external torque, the opposite of
+ * which acts on the simulated robot.
+ *
+ * Headless, i.e. no rendering and no physics engine, for closed-loop controller tests and
+ * benchmarks, e.g. free running in CI.
+ */
+class SimSystemInterface : public MockSystemInterface {
+protected:
+  static constexpr char LOGGER_NAME[] = "lbr_ros2_control::SimSystemInterface";
+
+public:
+  SimSystemInterface() = default;
+  ~SimSystemInterface();
+
+  controller_interface::CallbackReturn
+  on_init(const hardware_interface::HardwareInfo &info) override;
+
+protected:
+  bool parse_sim_parameters_(lbr_fri_ros2::DynamicsSimulatorParameters &sim_parameters);
+
+  void reset_joints_() override;
+  void emulate_joints_() override;
+
+  std::unique_ptr<lbr_fri_ros2::DynamicsSimulator> simulator_ptr_;
+  lbr_fri_idl::msg::LBRCommand::_wrench_type wrench_overlay_;
+  lbr_fri_idl::msg::LBRState::_external_torque_type acting_torque_;
+};
+} // namespace lbr_ros2_control
+#endif // LBR_ROS2_CONTROL__SIM_SYSTEM_INTERFACE_HPP_
@@ -2,14 +2,20 @@
 #define LBR_ROS2_CONTROL__SYSTEM_INTERFACE_HPP_
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstring>
 #include <memory>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <thread>
 #include <vector>
 
 #include "controller_interface/controller_interface.hpp"
+#include "eigen3/Eigen/Core"
 #include "hardware_interface/system_interface.hpp"
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
 #include "rclcpp/rclcpp.hpp"
@@ -27,6 +33,9 @@
 #include "lbr_fri_ros2/formatting.hpp"
 #include "lbr_fri_ros2/ft_estimator.hpp"
 #include "lbr_fri_ros2/interfaces/state.hpp"
+#include "lbr_fri_ros2/kinematics_cache.hpp"
+#include "lbr_fri_ros2/payload_identifier.hpp"
+#include "lbr_fri_ros2/torque_bias_map.hpp"
 #include "lbr_ros2_control/system_interface_type_values.hpp"
 
 namespace lbr_ros2_control {
@@ -43,6 +52,7 @@ struct SystemInterfaceParameters {
   const char *remote_host{nullptr};
   int32_t rt_prio{80};
   bool open_loop{true};
+  bool cycle_sync{false};
   double pid_p{0.0};
   double pid_i{0.0};
   double pid_d{0.0};
@@ -52,6 +62,8 @@ struct SystemInterfaceParameters {
   std::string command_guard_variant{"default"};
   double external_torque_cutoff_frequency{10.0};
   double measured_torque_cutoff_frequency{10.0};
+  double command_blend_time{0.2};
+  double activation_timeout{0.0};
 };
 
 struct EstimatedFTSensorParameters {
@@ -64,6 +76,15 @@ struct EstimatedFTSensorParameters {
   double torque_x_th{0.5};
   double torque_y_th{0.5};
   double torque_z_th{0.5};
+  bool enabled{true};
+  uint32_t decimation{1};
+  bool identify_payload{false};
+  uint32_t payload_identification_samples{2000};
+  std::string payload_file{"none"};
+  bool calibrate_torque_bias{false};
+  std::string torque_bias_map_file{"none"};
+  std::vector<uint32_t> torque_bias_joints{1, 3};
+  double torque_bias_resolution{0.1};
 };
 
 class SystemInterface : public hardware_interface::SystemInterface {
@@ -77,10 +98,17 @@ protected:
   static constexpr uint8_t LBR_FRI_STATE_INTERFACE_SIZE = 6;
 #endif
   static constexpr uint8_t LBR_FRI_COMMAND_INTERFACE_SIZE = 2;
-  static constexpr uint8_t LBR_FRI_SENSORS = 2;
+  static constexpr uint8_t LBR_FRI_SENSORS = 3;
   static constexpr uint8_t AUXILIARY_SENSOR_SIZE = 12;
-  static constexpr uint8_t ESTIMATED_FT_SENSOR_SIZE = 6;
-  static constexpr uint8_t GPIO_SIZE = 1;
+  static constexpr uint8_t ESTIMATED_FT_SENSOR_SIZE = 9;
+  static constexpr uint8_t ESTIMATED_FT_FRAME_SENSOR_SIZE = 6;
+  static constexpr uint8_t POSE_SIZE = 7;
+  static constexpr uint8_t TWIST_SIZE = 6;
+  static constexpr uint8_t JACOBIAN_SIZE =
+      lbr_fri_ros2::FTEstimator::CARTESIAN_DOF * KUKA::FRI::LBRState::NUMBER_OF_JOINTS;
+  static constexpr uint8_t KINEMATICS_SENSOR_SIZE = POSE_SIZE + TWIST_SIZE + JACOBIAN_SIZE;
+  static constexpr uint8_t GPIO_SIZE = 2;
+  static constexpr std::chrono::milliseconds ACTIVATION_PROGRESS_PERIOD{1000};
 
 public:
   SystemInterface() = default;
@@ -93,7 +121,10 @@ public:
 
   hardware_interface::return_type prepare_command_mode_switch(
       const std::vector<std::string> &start_interfaces,
-      const std::vector<std::string> &stop_interfaces) override; // not supported in FRI
+      const std::vector<std::string> &stop_interfaces) override;
+  hardware_interface::return_type perform_command_mode_switch(
+      const std::vector<std::string> &start_interfaces,
+      const std::vector<std::string> &stop_interfaces) override;
 
   controller_interface::CallbackReturn
   on_activate(const rclcpp_lifecycle::State &previous_state) override;
@@ -116,8 +147,20 @@ protected:
   bool verify_sensors_();
   bool verify_auxiliary_sensor_();
   bool verify_estimated_ft_sensor_();
+  bool verify_estimated_ft_frame_sensors_();
+  bool verify_kinematics_sensor_();
   bool verify_gpios_();
 
+  // activation, awaits the robot with an optional timeout, 0 waits indefinitely
+  double activation_elapsed_(const std::chrono::steady_clock::time_point &start) const;
+  bool activation_continues_(const std::chrono::steady_clock::time_point &start) const;
+
+  // state and command exchange with the robot, overridden for emulation, see MockSystemInterface
+  virtual bool state_initialized_();
+  virtual const lbr_fri_ros2::StateBlock &get_state_block_();
+  virtual void buffer_command_target_(const lbr_fri_idl::msg::LBRCommand &command);
+  virtual bool get_client_command_mode_(KUKA::FRI::EClientCommandMode &client_command_mode) const;
+
   // monitor end of commanding active
   bool exit_commanding_active_(const KUKA::FRI::ESessionState &previous_session_state,
                                const KUKA::FRI::ESessionState &session_state);
@@ -130,22 +173,11 @@ protected:
   std::shared_ptr<lbr_fri_ros2::AsyncClient> async_client_ptr_;
   std::unique_ptr<lbr_fri_ros2::App> app_ptr_;
 
-  // exposed state interfaces (ideally these are taken from async_client_ptr_ but
-  // ros2_control ReadOnlyHandle does not allow for const pointers, refer
+  // exposed state interfaces, a copy of the latest state block published by the FRI thread.
+  // Handles require fixed addresses, so the block is copied rather than referenced (ros2_control
+  // ReadOnlyHandle does not allow for const pointers either, refer
   // https://github.com/ros-controls/ros2_control/issues/1196)
-  lbr_fri_idl::msg::LBRState hw_lbr_state_;
-
-  // exposed state interfaces that require casting
-  double hw_session_state_;
-  double hw_connection_quality_;
-  double hw_safety_state_;
-  double hw_operation_mode_;
-  double hw_drive_state_;
-  double hw_client_command_mode_;
-  double hw_overlay_type_;
-  double hw_control_mode_;
-  double hw_time_stamp_sec_;
-  double hw_time_stamp_nano_sec_;
+  lbr_fri_ros2::StateBlock hw_state_;
 
   // additional velocity state interface
   lbr_fri_idl::msg::LBRState::_measured_joint_position_type last_hw_measured_joint_position_;
@@ -159,12 +191,70 @@ protected:
   void update_last_hw_states_();
   void compute_hw_velocity_();
 
+  // shared forward kinematics and Jacobian, keyed by the state block sequence
+  std::shared_ptr<lbr_fri_ros2::KinematicsCache> kinematics_cache_ptr_;
+
+  // additional kinematics state interfaces, chain tip pose and twist with respect to chain root,
+  // row-major chain tip Jacobian
+  bool kinematics_enabled_{true};
+  std::array<double, POSE_SIZE> hw_pose_;
+  std::array<double, TWIST_SIZE> hw_twist_;
+  std::array<double, JACOBIAN_SIZE> hw_jacobian_;
+  void compute_hw_kinematics_();
+
   // additional force-torque state interface
   lbr_fri_ros2::FTEstimator::cart_array_t hw_ft_;
+  double hw_ft_sigma_min_;
+  double hw_ft_manipulability_;
+  double hw_ft_damping_factor_;
   std::unique_ptr<lbr_fri_ros2::FTEstimator> ft_estimator_ptr_;
 
+  // additional force-torque state interfaces per estimation frame, sensors after the
+  // estimated_ft_sensor, and runtime selection of the frame the estimated_ft_sensor reports in
+  std::vector<lbr_fri_ros2::FTEstimator::cart_array_t> hw_frame_ft_;
+  std::vector<std::size_t> ft_frame_indices_;
+  double hw_ft_frame_;
+  double hw_ft_frame_command_;
+  std::size_t ft_active_frame_{0};
+  bool setup_ft_frames_();
+  void update_ft_active_frame_();
+
+  // decimate force-torque estimation to every n-th state sample
+  uint32_t ft_decimation_counter_{0};
+  uint64_t ft_sequence_{0};
+  bool ft_sequence_valid_{false};
+  bool ft_estimation_due_();
+
+  // payload identification from standstill samples
+  static constexpr double STANDSTILL_VELOCITY_TH = 1.e-3;
+  std::unique_ptr<lbr_fri_ros2::PayloadIdentifier> payload_identifier_ptr_;
+  std::size_t payload_identification_poses_{0}; // distinct poses at the last identification
+  uint64_t payload_sequence_{0};
+  bool payload_sequence_valid_{false};
+  bool standstill_() const;
+  void identify_payload_();
+
+  // configuration-dependent external torque bias, calibrated while moving freely
+  std::shared_ptr<lbr_fri_ros2::TorqueBiasMap> torque_bias_map_ptr_;
+  bool setup_torque_bias_map_();
+  void save_torque_bias_map_();
+
   // exposed command interfaces
   lbr_fri_idl::msg::LBRCommand hw_lbr_command_;
+
+  // command switching, the FRI client command mode is fixed per session, so controllers may only
+  // claim the command interfaces of the mode the robot reports
+  bool verify_start_interfaces_(const std::vector<std::string> &start_interfaces) const;
+
+  // bumpless switching, crossfade from the last applied command to the newly started controller's
+  // command. Requested from the switching thread, started in write()
+  std::atomic_bool blend_requested_{false};
+  bool blending_{false};
+  double blend_elapsed_{0.};
+  lbr_fri_idl::msg::LBRCommand blend_start_command_;
+  lbr_fri_idl::msg::LBRCommand hw_lbr_applied_command_;
+  void start_blend_();
+  void blend_command_(const double &dt);
 };
 } // namespace lbr_ros2_control
 #endif // LBR_ROS2_CONTROL__SYSTEM_INTERFACE_HPP_
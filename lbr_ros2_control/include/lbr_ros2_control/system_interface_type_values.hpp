@@ -34,9 +34,35 @@ constexpr char HW_IF_TORQUE_X[] = "torque.x";
 constexpr char HW_IF_TORQUE_Y[] = "torque.y";
 constexpr char HW_IF_TORQUE_Z[] = "torque.z";
 
+// additional estimated force-torque confidence state interfaces
+constexpr char HW_IF_SIGMA_MIN[] = "sigma_min";
+constexpr char HW_IF_MANIPULABILITY[] = "manipulability";
+constexpr char HW_IF_DAMPING_FACTOR[] = "damping_factor";
+
+// additional kinematics state interfaces, chain tip pose, twist and Jacobian
+constexpr char HW_IF_POSITION_X[] = "position.x";
+constexpr char HW_IF_POSITION_Y[] = "position.y";
+constexpr char HW_IF_POSITION_Z[] = "position.z";
+constexpr char HW_IF_ORIENTATION_X[] = "orientation.x";
+constexpr char HW_IF_ORIENTATION_Y[] = "orientation.y";
+constexpr char HW_IF_ORIENTATION_Z[] = "orientation.z";
+constexpr char HW_IF_ORIENTATION_W[] = "orientation.w";
+constexpr char HW_IF_LINEAR_X[] = "linear.x";
+constexpr char HW_IF_LINEAR_Y[] = "linear.y";
+constexpr char HW_IF_LINEAR_Z[] = "linear.z";
+constexpr char HW_IF_ANGULAR_X[] = "angular.x";
+constexpr char HW_IF_ANGULAR_Y[] = "angular.y";
+constexpr char HW_IF_ANGULAR_Z[] = "angular.z";
+constexpr char HW_IF_JACOBIAN_PREFIX[] = "jacobian"; // jacobian_<row>_<column>
+
 // additional LBR command interfaces, reference KUKA::FRI::LBRCommand
 constexpr char HW_IF_WRENCH_PREFIX[] = "wrench";
 constexpr char HW_IF_AUXILIARY_PREFIX[] = "auxiliary_sensor";
 constexpr char HW_IF_ESTIMATED_FT_PREFIX[] = "estimated_ft_sensor";
+constexpr char HW_IF_KINEMATICS_PREFIX[] = "kinematics";
+
+// additional estimated force-torque frames, selected via HW_IF_ESTIMATED_FT_FRAME_PREFIX
+constexpr char HW_IF_ESTIMATED_FT_FRAME_PREFIX[] = "estimated_ft_frame";
+constexpr char HW_IF_INDEX[] = "index";
 } // namespace lbr_ros2_control
 #endif // LBR_ROS2_CONTROL__SYSTEM_INTERFACE_TYPE_VALUES_HPP_
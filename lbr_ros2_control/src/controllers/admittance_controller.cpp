@@ -1,77 +1,483 @@
 #include "lbr_ros2_control/controllers/admittance_controller.hpp"
 
 namespace lbr_ros2_control {
-AdmittanceController::AdmittanceController() {}
+Admittance::Admittance(const AdmittanceParameters &parameters)
+    : mass_(Eigen::Map<const cart_vector_t>(parameters.mass.data())),
+      damping_(Eigen::Map<const cart_vector_t>(parameters.damping.data())),
+      stiffness_(Eigen::Map<const cart_vector_t>(parameters.stiffness.data())),
+      threshold_(Eigen::Map<const cart_vector_t>(parameters.threshold.data())),
+      max_linear_velocity_(parameters.max_linear_velocity),
+      max_angular_velocity_(parameters.max_angular_velocity) {
+  if ((mass_.array() <= 0.).any() || (damping_.array() < 0.).any() ||
+      (stiffness_.array() < 0.).any() || (threshold_.array() < 0.).any()) {
+    throw std::runtime_error(
+        "Expected positive mass and non-negative damping, stiffness and threshold.");
+  }
+  if (max_linear_velocity_ <= 0. || max_angular_velocity_ <= 0.) {
+    throw std::runtime_error("Expected positive maximum linear and angular velocity.");
+  }
+  reset();
+}
+
+void Admittance::reset() {
+  f_.setZero();
+  twist_.setZero();
+  displacement_.setZero();
+}
+
+const Admittance::cart_vector_t &Admittance::update(const cart_vector_t &f_ext,
+                                                     const double &dt) {
+  // deadband, continuous at the threshold
+  f_ = f_ext.cwiseSign().cwiseProduct((f_ext.cwiseAbs() - threshold_).cwiseMax(0.));
+
+  // semi-implicit Euler, damping implicit
+  twist_ = (mass_.cwiseProduct(twist_) + dt * (f_ - stiffness_.cwiseProduct(displacement_)))
+               .cwiseQuotient(mass_ + dt * damping_);
+
+  // limit velocities, preserving the direction
+  const double linear_velocity = twist_.head<3>().norm();
+  if (linear_velocity > max_linear_velocity_) {
+    twist_.head<3>() *= max_linear_velocity_ / linear_velocity;
+  }
+  const double angular_velocity = twist_.tail<3>().norm();
+  if (angular_velocity > max_angular_velocity_) {
+    twist_.tail<3>() *= max_angular_velocity_ / angular_velocity;
+  }
+  displacement_ += dt * twist_;
+  return twist_;
+}
+
+ChainTipAdmittance::ChainTipAdmittance() : max_joint_velocity_(0.5), pinv_damping_(0.05) {}
+
+void ChainTipAdmittance::declare_parameters(
+    const std::shared_ptr<rclcpp_lifecycle::LifecycleNode> &node) {
+  node->declare_parameter<std::vector<double>>(
+      "mass", std::vector<double>(parameters_.mass.begin(), parameters_.mass.end()));
+  node->declare_parameter<std::vector<double>>(
+      "damping", std::vector<double>(parameters_.damping.begin(), parameters_.damping.end()));
+  node->declare_parameter<std::vector<double>>(
+      "stiffness",
+      std::vector<double>(parameters_.stiffness.begin(), parameters_.stiffness.end()));
+  node->declare_parameter<std::vector<double>>(
+      "threshold",
+      std::vector<double>(parameters_.threshold.begin(), parameters_.threshold.end()));
+  node->declare_parameter<double>("max_linear_velocity", parameters_.max_linear_velocity);
+  node->declare_parameter<double>("max_angular_velocity", parameters_.max_angular_velocity);
+  node->declare_parameter<double>("max_joint_velocity", max_joint_velocity_);
+  node->declare_parameter<double>("pinv_damping", pinv_damping_);
+}
+
+bool ChainTipAdmittance::configure(const std::shared_ptr<rclcpp_lifecycle::LifecycleNode> &node) {
+  if (!parse_cart_array_(node, "mass", parameters_.mass) ||
+      !parse_cart_array_(node, "damping", parameters_.damping) ||
+      !parse_cart_array_(node, "stiffness", parameters_.stiffness) ||
+      !parse_cart_array_(node, "threshold", parameters_.threshold)) {
+    return false;
+  }
+  parameters_.max_linear_velocity = node->get_parameter("max_linear_velocity").as_double();
+  parameters_.max_angular_velocity = node->get_parameter("max_angular_velocity").as_double();
+  max_joint_velocity_ = node->get_parameter("max_joint_velocity").as_double();
+  pinv_damping_ = node->get_parameter("pinv_damping").as_double();
+  if (max_joint_velocity_ <= 0. || pinv_damping_ < 0.) {
+    RCLCPP_ERROR(node->get_logger(),
+                 "Expected positive max_joint_velocity and non-negative pinv_damping.");
+    return false;
+  }
+  try {
+    admittance_ = Admittance(parameters_);
+  } catch (const std::exception &e) {
+    RCLCPP_ERROR(node->get_logger(), "Failed to configure admittance with: %s", e.what());
+    return false;
+  }
+  return true;
+}
+
+controller_interface::InterfaceConfiguration
+ChainTipAdmittance::command_interface_configuration() const {
+  controller_interface::InterfaceConfiguration interface_configuration;
+  interface_configuration.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto &joint_name : joint_names_) {
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return interface_configuration;
+}
 
 controller_interface::InterfaceConfiguration
-AdmittanceController::command_interface_configuration() {
-  // reference joint position command interface
+ChainTipAdmittance::state_interface_configuration() const {
+  controller_interface::InterfaceConfiguration interface_configuration;
+  interface_configuration.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto &joint_name : joint_names_) {
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  for (const auto &ft : {HW_IF_FORCE_X, HW_IF_FORCE_Y, HW_IF_FORCE_Z, HW_IF_TORQUE_X,
+                         HW_IF_TORQUE_Y, HW_IF_TORQUE_Z}) {
+    interface_configuration.names.push_back(std::string(HW_IF_ESTIMATED_FT_PREFIX) + "/" + ft);
+  }
+  for (const auto &pose : {HW_IF_POSITION_X, HW_IF_POSITION_Y, HW_IF_POSITION_Z,
+                           HW_IF_ORIENTATION_X, HW_IF_ORIENTATION_Y, HW_IF_ORIENTATION_Z,
+                           HW_IF_ORIENTATION_W}) {
+    interface_configuration.names.push_back(std::string(HW_IF_KINEMATICS_PREFIX) + "/" + pose);
+  }
+  for (std::size_t row = 0; row < CARTESIAN_DOF; ++row) {
+    for (std::size_t col = 0; col < N; ++col) {
+      interface_configuration.names.push_back(std::string(HW_IF_KINEMATICS_PREFIX) + "/" +
+                                              HW_IF_JACOBIAN_PREFIX + "_" + std::to_string(row) +
+                                              "_" + std::to_string(col));
+    }
+  }
+  return interface_configuration;
 }
 
-controller_interface::InterfaceConfiguration AdmittanceController::state_interface_configuration() {
-  // retrieve estimated ft state interface
+bool ChainTipAdmittance::reference_interfaces(
+    std::vector<hardware_interface::LoanedCommandInterface> &command_interfaces,
+    std::vector<hardware_interface::LoanedStateInterface> &state_interfaces,
+    const rclcpp::Logger &logger) {
+  for (auto &command_interface : command_interfaces) {
+    if (command_interface.get_interface_name() == hardware_interface::HW_IF_POSITION) {
+      joint_position_command_interfaces_.emplace_back(std::ref(command_interface));
+    }
+  }
+  if (joint_position_command_interfaces_.size() != N) {
+    RCLCPP_ERROR(logger,
+                 "Number of joint position command interfaces '%ld' does not match the number of "
+                 "joints in the robot '%d'.",
+                 joint_position_command_interfaces_.size(), N);
+    return false;
+  }
+  // state interfaces are ordered as in state_interface_configuration
+  for (auto &state_interface : state_interfaces) {
+    if (state_interface.get_prefix_name() == HW_IF_ESTIMATED_FT_PREFIX) {
+      estimated_ft_sensor_state_interfaces_.emplace_back(std::ref(state_interface));
+    } else if (state_interface.get_prefix_name() == HW_IF_KINEMATICS_PREFIX) {
+      const auto &interface_name = state_interface.get_interface_name();
+      if (interface_name.rfind(HW_IF_JACOBIAN_PREFIX, 0) == 0) {
+        jacobian_state_interfaces_.emplace_back(std::ref(state_interface));
+      } else if (interface_name.rfind("position", 0) == 0) {
+        position_state_interfaces_.emplace_back(std::ref(state_interface));
+      } else {
+        orientation_state_interfaces_.emplace_back(std::ref(state_interface));
+      }
+    } else if (state_interface.get_interface_name() == hardware_interface::HW_IF_POSITION) {
+      joint_position_state_interfaces_.emplace_back(std::ref(state_interface));
+    }
+  }
+  if (joint_position_state_interfaces_.size() != N ||
+      estimated_ft_sensor_state_interfaces_.size() != CARTESIAN_DOF ||
+      position_state_interfaces_.size() != 3 || orientation_state_interfaces_.size() != 4 ||
+      jacobian_state_interfaces_.size() != CARTESIAN_DOF * N) {
+    RCLCPP_ERROR(logger,
+                 "Expected %d joint position, %d estimated_ft_sensor, 3 position, 4 orientation "
+                 "and %d jacobian state interfaces, got %ld, %ld, %ld, %ld and %ld.",
+                 N, CARTESIAN_DOF, CARTESIAN_DOF * N, joint_position_state_interfaces_.size(),
+                 estimated_ft_sensor_state_interfaces_.size(), position_state_interfaces_.size(),
+                 orientation_state_interfaces_.size(), jacobian_state_interfaces_.size());
+    return false;
+  }
+  return true;
 }
 
-controller_interface::CallbackReturn AdmittanceController::on_init() {}
+void ChainTipAdmittance::clear_interfaces() {
+  joint_position_command_interfaces_.clear();
+  joint_position_state_interfaces_.clear();
+  estimated_ft_sensor_state_interfaces_.clear();
+  position_state_interfaces_.clear();
+  orientation_state_interfaces_.clear();
+  jacobian_state_interfaces_.clear();
+}
 
-controller_interface::return_type AdmittanceController::update(const rclcpp::Time &time,
-                                                               const rclcpp::Duration &period) {
-  // compute admittance
-  // add warning for high force-torques and refer to load data calibration
+bool ChainTipAdmittance::read_state() {
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    q_[idx] = joint_position_state_interfaces_[idx].get().get_value();
+  }
+  for (std::size_t idx = 0; idx < CARTESIAN_DOF; ++idx) {
+    f_ext_[idx] = estimated_ft_sensor_state_interfaces_[idx].get().get_value();
+  }
+  for (std::size_t idx = 0; idx < 3; ++idx) {
+    position_[idx] = position_state_interfaces_[idx].get().get_value();
+  }
+  orientation_ = Eigen::Quaterniond(orientation_state_interfaces_[3].get().get_value(),
+                                    orientation_state_interfaces_[0].get().get_value(),
+                                    orientation_state_interfaces_[1].get().get_value(),
+                                    orientation_state_interfaces_[2].get().get_value());
+  for (std::size_t row = 0; row < CARTESIAN_DOF; ++row) {
+    for (std::size_t col = 0; col < N; ++col) {
+      jacobian_(row, col) = jacobian_state_interfaces_[row * N + col].get().get_value();
+    }
+  }
+  if (!q_.allFinite() || !f_ext_.allFinite() || !position_.allFinite() ||
+      !orientation_.coeffs().allFinite() || orientation_.norm() == 0. || !jacobian_.allFinite()) {
+    return false;
+  }
+  orientation_.normalize();
+  rotation_ = orientation_.toRotationMatrix();
+  return true;
 }
 
-controller_interface::CallbackReturn
-AdmittanceController::on_configure(const rclcpp_lifecycle::State &previous_state) {
+void ChainTipAdmittance::reset() { admittance_.reset(); }
+
+const ChainTipAdmittance::cart_vector_t &ChainTipAdmittance::update(const double &dt) {
+  // force-torque from the chain tip into the chain root, where the Jacobian is expressed
+  f_ext_root_.head<3>().noalias() = rotation_ * f_ext_.head<3>();
+  f_ext_root_.tail<3>().noalias() = rotation_ * f_ext_.tail<3>();
+  return admittance_.update(f_ext_root_, dt);
+}
+
+void ChainTipAdmittance::limit_joint_velocity(jnt_vector_t &dq) const {
+  const double max_abs_dq = dq.cwiseAbs().maxCoeff();
+  if (max_abs_dq > max_joint_velocity_) {
+    dq *= max_joint_velocity_ / max_abs_dq;
+  }
+}
+
+void ChainTipAdmittance::write_joint_position_command(const jnt_vector_t &q_command) {
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    joint_position_command_interfaces_[idx].get().set_value(q_command[idx]);
+  }
+}
+
+bool ChainTipAdmittance::parse_cart_array_(
+    const std::shared_ptr<rclcpp_lifecycle::LifecycleNode> &node, const std::string &name,
+    AdmittanceParameters::cart_array_t &cart_array) {
+  const auto values = node->get_parameter(name).as_double_array();
+  if (values.size() != cart_array.size()) {
+    RCLCPP_ERROR(node->get_logger(), "Expected %ld values for '%s', got %ld.", cart_array.size(),
+                 name.c_str(), values.size());
+    return false;
+  }
+  std::copy(values.begin(), values.end(), cart_array.begin());
+  return true;
+}
+
+AdmittanceController::AdmittanceController()
+    : last_joint_position_reference_stamp_ns_(0), last_pose_reference_stamp_ns_(0),
+      joint_position_reference_subscription_ptr_(nullptr),
+      pose_reference_subscription_ptr_(nullptr), initialized_(false) {}
+
+controller_interface::InterfaceConfiguration
+AdmittanceController::command_interface_configuration() const {
+  return chain_tip_admittance_.command_interface_configuration();
+}
+
+controller_interface::InterfaceConfiguration
+AdmittanceController::state_interface_configuration() const {
+  return chain_tip_admittance_.state_interface_configuration();
+}
+
+controller_interface::CallbackReturn AdmittanceController::on_init() {
+  try {
+    chain_tip_admittance_.declare_parameters(this->get_node());
+    joint_position_reference_subscription_ptr_ =
+        this->get_node()->create_subscription<lbr_fri_idl::msg::LBRJointPositionCommand>(
+            "command/joint_position", 1,
+            [this](const lbr_fri_idl::msg::LBRJointPositionCommand::SharedPtr msg,
+                   const rclcpp::MessageInfo &message_info) {
+              rt_joint_position_reference_.writeFromNonRT(
+                  {*msg, CommandAgeMonitor::stamp(message_info)});
+            },
+            rclcpp::SubscriptionOptions(),
+            std::make_shared<command_message_pool_t<lbr_fri_idl::msg::LBRJointPositionCommand>>());
+    pose_reference_subscription_ptr_ =
+        this->get_node()->create_subscription<geometry_msgs::msg::Pose>(
+            "command/pose", 1,
+            [this](const geometry_msgs::msg::Pose::SharedPtr msg,
+                   const rclcpp::MessageInfo &message_info) {
+              rt_pose_reference_.writeFromNonRT({*msg, CommandAgeMonitor::stamp(message_info)});
+            },
+            rclcpp::SubscriptionOptions(),
+            std::make_shared<command_message_pool_t<geometry_msgs::msg::Pose>>());
+  } catch (const std::exception &e) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Failed to initialize admittance controller with: %s.", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
+controller_interface::return_type AdmittanceController::update_reference_from_subscribers() {
+  // the latest received reference replaces the other, by stamp if both are new
+  const auto joint_position_reference = rt_joint_position_reference_.readFromRT();
+  const auto pose_reference = rt_pose_reference_.readFromRT();
+  const bool new_joint_position_reference =
+      joint_position_reference->stamp_ns != last_joint_position_reference_stamp_ns_;
+  const bool new_pose_reference = pose_reference->stamp_ns != last_pose_reference_stamp_ns_;
+  if (new_joint_position_reference &&
+      (!new_pose_reference || joint_position_reference->stamp_ns >= pose_reference->stamp_ns)) {
+    clear_reference_interfaces_();
+    std::copy(joint_position_reference->msg.joint_position.begin(),
+              joint_position_reference->msg.joint_position.end(), reference_interfaces_.begin());
+  } else if (new_pose_reference) {
+    clear_reference_interfaces_();
+    reference_interfaces_[N + 0] = pose_reference->msg.position.x;
+    reference_interfaces_[N + 1] = pose_reference->msg.position.y;
+    reference_interfaces_[N + 2] = pose_reference->msg.position.z;
+    reference_interfaces_[N + 3] = pose_reference->msg.orientation.x;
+    reference_interfaces_[N + 4] = pose_reference->msg.orientation.y;
+    reference_interfaces_[N + 5] = pose_reference->msg.orientation.z;
+    reference_interfaces_[N + 6] = pose_reference->msg.orientation.w;
+  }
+  last_joint_position_reference_stamp_ns_ = joint_position_reference->stamp_ns;
+  last_pose_reference_stamp_ns_ = pose_reference->stamp_ns;
+  return controller_interface::return_type::OK;
+}
+
+controller_interface::return_type
+AdmittanceController::update_and_write_commands(const rclcpp::Time & /*time*/,
+                                                const rclcpp::Duration &period) {
+  if (!chain_tip_admittance_.read_state()) {
+    // e.g. estimation or kinematics disabled, hold the last command
+    if (initialized_) {
+      chain_tip_admittance_.write_joint_position_command(q_command_);
+    }
+    return controller_interface::return_type::OK;
+  }
+  const auto &q = chain_tip_admittance_.get_joint_position();
+  const auto &jacobian = chain_tip_admittance_.get_jacobian();
+  if (!initialized_) {
+    q_nominal_ = q;
+    q_offset_.setZero();
+    q_command_ = q;
+    chain_tip_admittance_.reset();
+    initialized_ = true;
+  }
+  const double dt = period.seconds();
+  if (dt > 0.) {
+    const double max_dq = chain_tip_admittance_.get_max_joint_velocity() * dt;
+
+    // damped least-squares, J^# = J^T (J J^T + lambda^2 I)^-1
+    const double pinv_damping = chain_tip_admittance_.get_pinv_damping();
+    jjt_.noalias() = jacobian * jacobian.transpose();
+    jjt_.diagonal().array() += pinv_damping * pinv_damping;
+    jjt_ldlt_.compute(jjt_);
+
+    // nominal joint position, from the joint reference, else the pose reference
+    if (std::all_of(reference_interfaces_.begin(), reference_interfaces_.begin() + N,
+                    [](const double &reference) { return std::isfinite(reference); })) {
+      for (std::size_t idx = 0; idx < N; ++idx) {
+        q_nominal_[idx] += std::max(
+            -max_dq, std::min(reference_interfaces_[idx] - q_nominal_[idx], max_dq));
+      }
+    } else if (read_nominal_twist_(dt)) {
+      dq_.noalias() = jacobian.transpose() * jjt_ldlt_.solve(nominal_twist_);
+      chain_tip_admittance_.limit_joint_velocity(dq_);
+      q_nominal_ += dt * dq_;
+    }
+
+    // admittance twist in the chain root
+    const cart_vector_t &twist = chain_tip_admittance_.update(dt);
+    dq_.noalias() = jacobian.transpose() * jjt_ldlt_.solve(twist);
+    chain_tip_admittance_.limit_joint_velocity(dq_);
+    q_offset_ += dt * dq_;
+
+    // limit the combined step, the offset absorbs the excess
+    dq_ = (q_nominal_ + q_offset_ - q_command_) / dt;
+    chain_tip_admittance_.limit_joint_velocity(dq_);
+    q_command_ += dt * dq_;
+    q_offset_ = q_command_ - q_nominal_;
+  }
+  chain_tip_admittance_.write_joint_position_command(q_command_);
+  return controller_interface::return_type::OK;
+}
+
 controller_interface::CallbackReturn
-AdmittanceController::on_activate(const rclcpp_lifecycle::State &previous_state) {
-  if (!reference_command_interfaces_()) {
+AdmittanceController::on_configure(const rclcpp_lifecycle::State & /*previous_state*/) {
+  if (!chain_tip_admittance_.configure(this->get_node())) {
     return controller_interface::CallbackReturn::ERROR;
   }
-  if (!reference_state_interfaces_()) {
+  // exported after configuration
+  reference_interfaces_.resize(N + POSE_REFERENCES);
+  clear_reference_interfaces_();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn
+AdmittanceController::on_activate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  if (!chain_tip_admittance_.reference_interfaces(command_interfaces_, state_interfaces_,
+                                                  this->get_node()->get_logger())) {
     return controller_interface::CallbackReturn::ERROR;
   }
+  // start from the measured joint position on the first valid state, ignore earlier references
+  clear_reference_interfaces_();
+  last_joint_position_reference_stamp_ns_ = rt_joint_position_reference_.readFromNonRT()->stamp_ns;
+  last_pose_reference_stamp_ns_ = rt_pose_reference_.readFromNonRT()->stamp_ns;
+  initialized_ = false;
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
 controller_interface::CallbackReturn
-AdmittanceController::on_deactivate(const rclcpp_lifecycle::State &previous_state) {
-  clear_command_interfaces_();
-  clear_state_interfaces_();
+AdmittanceController::on_deactivate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  chain_tip_admittance_.clear_interfaces();
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
-bool AdmittanceController::reference_command_interfaces_() {
-  for (auto &command_interface : command_interfaces_) {
-    if (command_interface.get_interface_name() == hardware_interface::HW_IF_POSITION) {
-      joint_position_command_interfaces_.emplace_back(std::ref(command_interface));
-    }
+std::vector<hardware_interface::CommandInterface>
+AdmittanceController::on_export_reference_interfaces() {
+  std::vector<hardware_interface::CommandInterface> reference_interfaces;
+  const auto &joint_names = chain_tip_admittance_.get_joint_names();
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    reference_interfaces.emplace_back(this->get_node()->get_name(),
+                                      joint_names[idx] + "/" + hardware_interface::HW_IF_POSITION,
+                                      &reference_interfaces_[idx]);
   }
-  if (joint_position_command_interfaces_.size() != KUKA::FRI::LBRState::NUMBER_OF_JOINTS) {
-    RCLCPP_ERROR(
-        this->get_node()->get_logger(),
-        "Number of joint position command interfaces '%ld' does not match the number of joints "
-        "in the robot '%d'.",
-        joint_position_command_interfaces_.size(), KUKA::FRI::LBRState::NUMBER_OF_JOINTS);
-    return false;
+  std::size_t idx = N;
+  for (const auto &pose : {HW_IF_POSITION_X, HW_IF_POSITION_Y, HW_IF_POSITION_Z,
+                           HW_IF_ORIENTATION_X, HW_IF_ORIENTATION_Y, HW_IF_ORIENTATION_Z,
+                           HW_IF_ORIENTATION_W}) {
+    reference_interfaces.emplace_back(this->get_node()->get_name(),
+                                      std::string(REFERENCE_POSE_PREFIX) + "/" + pose,
+                                      &reference_interfaces_[idx++]);
   }
+  return reference_interfaces;
 }
 
-bool AdmittanceController::reference_state_interfaces_() {
-  for (auto &state_interface : state_interfaces_) {
-    if (state_interface.get_interface_name() == HW_IF_ESTIMATED_FT_PREFIX) {
-      estimated_ft_sensor_state_interface_.emplace_back(std::ref(state_interface));
-    }
-  }
+bool AdmittanceController::on_set_chained_mode(bool /*chained_mode*/) {
+  // hold the nominal joint position until the new source writes
+  clear_reference_interfaces_();
+  return true;
 }
 
-void AdmittanceController::clear_command_interfaces_() {
-  joint_position_command_interfaces_.clear();
+void AdmittanceController::clear_reference_interfaces_() {
+  std::fill(reference_interfaces_.begin(), reference_interfaces_.end(),
+            std::numeric_limits<double>::quiet_NaN());
 }
 
-void AdmittanceController::clear_state_interfaces_() {
-  estimated_ft_sensor_state_interface_.clear();
+bool AdmittanceController::read_nominal_twist_(const double &dt) {
+  const Eigen::Map<const Eigen::Vector3d> position_reference(&reference_interfaces_[N]);
+  Eigen::Quaterniond orientation_reference(
+      reference_interfaces_[N + 6], reference_interfaces_[N + 3], reference_interfaces_[N + 4],
+      reference_interfaces_[N + 5]);
+  if (!position_reference.allFinite() || !orientation_reference.coeffs().allFinite() ||
+      orientation_reference.norm() == 0.) {
+    return false;
+  }
+  orientation_reference.normalize();
+
+  // pose error of the nominal joint position, linearized about the measured joint position
+  Eigen::Quaterniond orientation = chain_tip_admittance_.get_orientation();
+  if (orientation_reference.coeffs().dot(orientation.coeffs()) < 0.) {
+    orientation.coeffs() *= -1.;
+  }
+  const Eigen::AngleAxisd orientation_error(orientation_reference * orientation.inverse());
+  nominal_twist_.head<3>() = position_reference - chain_tip_admittance_.get_position();
+  nominal_twist_.tail<3>() = orientation_error.angle() * orientation_error.axis();
+  nominal_twist_.noalias() += chain_tip_admittance_.get_jacobian() *
+                              (chain_tip_admittance_.get_joint_position() - q_nominal_);
+
+  // reach the reference within one update, at limited velocities
+  nominal_twist_ /= dt;
+  const auto &parameters = chain_tip_admittance_.get_parameters();
+  const double linear_velocity = nominal_twist_.head<3>().norm();
+  if (linear_velocity > parameters.max_linear_velocity) {
+    nominal_twist_.head<3>() *= parameters.max_linear_velocity / linear_velocity;
+  }
+  const double angular_velocity = nominal_twist_.tail<3>().norm();
+  if (angular_velocity > parameters.max_angular_velocity) {
+    nominal_twist_.tail<3>() *= parameters.max_angular_velocity / angular_velocity;
+  }
+  return true;
 }
 } // namespace lbr_ros2_control
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(lbr_ros2_control::AdmittanceController,
+                       controller_interface::ChainableControllerInterface)
@@ -0,0 +1,156 @@
+#include "lbr_ros2_control/controllers/admittance_rcm_controller.hpp"
+
+namespace lbr_ros2_control {
+RCMSolver::RCMSolver(const double &rcm_gain, const double &pinv_damping)
+    : rcm_gain_(rcm_gain), pinv_damping_(pinv_damping) {
+  if (rcm_gain_ < 0. || pinv_damping_ <= 0.) {
+    throw std::runtime_error("Expected non-negative RCM gain and positive pinv damping.");
+  }
+  rcm_.setZero();
+  rcm_error_.setZero();
+  dq_.setZero();
+}
+
+void RCMSolver::set_rcm(const Eigen::Vector3d &position, const Eigen::Matrix3d &rotation,
+                        const double &distance) {
+  rcm_ = position + distance * rotation.col(2);
+  rcm_error_.setZero();
+}
+
+const RCMSolver::jnt_vector_t &RCMSolver::solve(const Eigen::Vector3d &position,
+                                                const Eigen::Matrix3d &rotation,
+                                                const jacobian_t &jacobian,
+                                                const cart_vector_t &twist) {
+  // shaft point closest to the RCM, c = p + alpha z
+  const Eigen::Vector3d shaft = rotation.col(2);
+  const double alpha = shaft.dot(rcm_ - position);
+  rcm_error_ = rcm_ - position - alpha * shaft;
+
+  // velocity of the shaft point, v_c = v + w x (alpha z)
+  shaft_jacobian_ = jacobian.topRows<3>();
+  for (std::size_t col = 0; col < N; ++col) {
+    shaft_jacobian_.col(col) -= alpha * shaft.cross(jacobian.block<3, 1>(3, col));
+  }
+
+  // constraint perpendicular to the shaft, A dq = b, with drift correction
+  a_.row(0).noalias() = rotation.col(0).transpose() * shaft_jacobian_;
+  a_.row(1).noalias() = rotation.col(1).transpose() * shaft_jacobian_;
+  b_ << rcm_gain_ * rotation.col(0).dot(rcm_error_), rcm_gain_ * rotation.col(1).dot(rcm_error_);
+  aat_.noalias() = a_ * a_.transpose();
+
+  // exact null-space, N = I - A^+ A, so that the twist does not leak into the constraint
+  aat_ldlt_.compute(aat_);
+  a_pinv_t_ = aat_ldlt_.solve(a_);
+  nullspace_projector_.setIdentity();
+  nullspace_projector_.noalias() -= a_pinv_t_.transpose() * a_;
+
+  // constraint, damped
+  aat_.diagonal().array() += pinv_damping_ * pinv_damping_;
+  aat_ldlt_.compute(aat_);
+  a_pinv_t_ = aat_ldlt_.solve(a_);
+  dq_.noalias() = a_pinv_t_.transpose() * b_;
+
+  // twist in the constraint's null-space
+  jn_.noalias() = jacobian * nullspace_projector_;
+  twist_residual_ = twist;
+  twist_residual_.noalias() -= jacobian * dq_;
+  jnjnt_.noalias() = jn_ * jn_.transpose();
+  jnjnt_.diagonal().array() += pinv_damping_ * pinv_damping_;
+  jnjnt_ldlt_.compute(jnjnt_);
+  dq_.noalias() += jn_.transpose() * jnjnt_ldlt_.solve(twist_residual_);
+  return dq_;
+}
+
+AdmittanceRCMController::AdmittanceRCMController()
+    : rcm_distance_(0.2), rcm_gain_(10.), initialized_(false) {}
+
+controller_interface::InterfaceConfiguration
+AdmittanceRCMController::command_interface_configuration() const {
+  return chain_tip_admittance_.command_interface_configuration();
+}
+
+controller_interface::InterfaceConfiguration
+AdmittanceRCMController::state_interface_configuration() const {
+  return chain_tip_admittance_.state_interface_configuration();
+}
+
+controller_interface::CallbackReturn AdmittanceRCMController::on_init() {
+  try {
+    chain_tip_admittance_.declare_parameters(this->get_node());
+    this->get_node()->declare_parameter<double>("rcm_distance", rcm_distance_);
+    this->get_node()->declare_parameter<double>("rcm_gain", rcm_gain_);
+  } catch (const std::exception &e) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Failed to initialize admittance RCM controller with: %s.", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type AdmittanceRCMController::update(const rclcpp::Time & /*time*/,
+                                                                  const rclcpp::Duration &period) {
+  if (!chain_tip_admittance_.read_state()) {
+    // e.g. estimation or kinematics disabled, hold the last command
+    if (initialized_) {
+      chain_tip_admittance_.write_joint_position_command(q_command_);
+    }
+    return controller_interface::return_type::OK;
+  }
+  const auto &position = chain_tip_admittance_.get_position();
+  const auto &rotation = chain_tip_admittance_.get_rotation();
+  if (!initialized_) {
+    q_command_ = chain_tip_admittance_.get_joint_position();
+    chain_tip_admittance_.reset();
+    rcm_solver_.set_rcm(position, rotation, rcm_distance_);
+    initialized_ = true;
+  }
+  const double dt = period.seconds();
+  if (dt > 0.) {
+    const cart_vector_t &twist = chain_tip_admittance_.update(dt);
+    dq_ = rcm_solver_.solve(position, rotation, chain_tip_admittance_.get_jacobian(), twist);
+    chain_tip_admittance_.limit_joint_velocity(dq_);
+    q_command_ += dt * dq_;
+  }
+  chain_tip_admittance_.write_joint_position_command(q_command_);
+  return controller_interface::return_type::OK;
+}
+
+controller_interface::CallbackReturn
+AdmittanceRCMController::on_configure(const rclcpp_lifecycle::State & /*previous_state*/) {
+  if (!chain_tip_admittance_.configure(this->get_node())) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  rcm_distance_ = this->get_node()->get_parameter("rcm_distance").as_double();
+  rcm_gain_ = this->get_node()->get_parameter("rcm_gain").as_double();
+  try {
+    rcm_solver_ = RCMSolver(rcm_gain_, chain_tip_admittance_.get_pinv_damping());
+  } catch (const std::exception &e) {
+    RCLCPP_ERROR(this->get_node()->get_logger(), "Failed to configure RCM solver with: %s",
+                 e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn
+AdmittanceRCMController::on_activate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  if (!chain_tip_admittance_.reference_interfaces(command_interfaces_, state_interfaces_,
+                                                  this->get_node()->get_logger())) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  // place the RCM on the first valid state
+  initialized_ = false;
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn
+AdmittanceRCMController::on_deactivate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  chain_tip_admittance_.clear_interfaces();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+} // namespace lbr_ros2_control
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(lbr_ros2_control::AdmittanceRCMController,
+                       controller_interface::ControllerInterface)
@@ -0,0 +1,282 @@
+#include "lbr_ros2_control/controllers/cartesian_impedance_controller.hpp"
+
+namespace lbr_ros2_control {
+CartesianImpedanceController::CartesianImpedanceController()
+    : nullspace_stiffness_(10.), nullspace_damping_(3.), pinv_damping_(0.05), max_torque_(20.),
+      last_target_pose_stamp_ns_(0), target_pose_subscription_ptr_(nullptr),
+      initialized_(false) {
+  stiffness_ << 500., 500., 500., 50., 50., 50.;
+  damping_ << 50., 50., 50., 5., 5., 5.;
+}
+
+controller_interface::InterfaceConfiguration
+CartesianImpedanceController::command_interface_configuration() const {
+  controller_interface::InterfaceConfiguration interface_configuration;
+  interface_configuration.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto &joint_name : joint_names_) {
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_POSITION);
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_EFFORT);
+  }
+  return interface_configuration;
+}
+
+controller_interface::InterfaceConfiguration
+CartesianImpedanceController::state_interface_configuration() const {
+  controller_interface::InterfaceConfiguration interface_configuration;
+  interface_configuration.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto &joint_name : joint_names_) {
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_POSITION);
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_VELOCITY);
+  }
+  for (const auto &pose : {HW_IF_POSITION_X, HW_IF_POSITION_Y, HW_IF_POSITION_Z,
+                           HW_IF_ORIENTATION_X, HW_IF_ORIENTATION_Y, HW_IF_ORIENTATION_Z,
+                           HW_IF_ORIENTATION_W}) {
+    interface_configuration.names.push_back(std::string(HW_IF_KINEMATICS_PREFIX) + "/" + pose);
+  }
+  for (std::size_t row = 0; row < CARTESIAN_DOF; ++row) {
+    for (std::size_t col = 0; col < N; ++col) {
+      interface_configuration.names.push_back(std::string(HW_IF_KINEMATICS_PREFIX) + "/" +
+                                              HW_IF_JACOBIAN_PREFIX + "_" + std::to_string(row) +
+                                              "_" + std::to_string(col));
+    }
+  }
+  return interface_configuration;
+}
+
+controller_interface::CallbackReturn CartesianImpedanceController::on_init() {
+  try {
+    this->get_node()->declare_parameter<std::vector<double>>(
+        "stiffness", std::vector<double>(stiffness_.data(), stiffness_.data() + CARTESIAN_DOF));
+    this->get_node()->declare_parameter<std::vector<double>>(
+        "damping", std::vector<double>(damping_.data(), damping_.data() + CARTESIAN_DOF));
+    this->get_node()->declare_parameter<double>("nullspace_stiffness", nullspace_stiffness_);
+    this->get_node()->declare_parameter<double>("nullspace_damping", nullspace_damping_);
+    this->get_node()->declare_parameter<double>("pinv_damping", pinv_damping_);
+    this->get_node()->declare_parameter<double>("max_torque", max_torque_);
+    target_pose_subscription_ptr_ = this->get_node()->create_subscription<geometry_msgs::msg::Pose>(
+        "command/pose", 1,
+        [this](const geometry_msgs::msg::Pose::SharedPtr msg,
+               const rclcpp::MessageInfo &message_info) {
+          rt_target_pose_.writeFromNonRT({*msg, CommandAgeMonitor::stamp(message_info)});
+        },
+        rclcpp::SubscriptionOptions(),
+        std::make_shared<command_message_pool_t<geometry_msgs::msg::Pose>>());
+  } catch (const std::exception &e) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Failed to initialize Cartesian impedance controller with: %s.", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type
+CartesianImpedanceController::update(const rclcpp::Time & /*time*/,
+                                     const rclcpp::Duration & /*period*/) {
+  if (!read_state_()) {
+    // e.g. kinematics disabled, no torque overlay, hold the last joint position
+    for (std::size_t idx = 0; idx < N; ++idx) {
+      torque_command_interfaces_[idx].get().set_value(0.);
+      if (initialized_) {
+        joint_position_command_interfaces_[idx].get().set_value(q_[idx]);
+      }
+    }
+    return controller_interface::return_type::OK;
+  }
+  const auto target_pose = rt_target_pose_.readFromRT();
+  if (!initialized_) {
+    // start at rest, ignore targets received before activation
+    target_position_ = position_;
+    target_orientation_ = orientation_;
+    q_nullspace_ = q_;
+    last_target_pose_stamp_ns_ = target_pose->stamp_ns;
+    initialized_ = true;
+  }
+  if (target_pose->stamp_ns != last_target_pose_stamp_ns_) {
+    const Eigen::Quaterniond target_orientation(
+        target_pose->msg.orientation.w, target_pose->msg.orientation.x,
+        target_pose->msg.orientation.y, target_pose->msg.orientation.z);
+    if (target_orientation.coeffs().allFinite() && target_orientation.norm() > 0.) {
+      target_position_ << target_pose->msg.position.x, target_pose->msg.position.y,
+          target_pose->msg.position.z;
+      target_orientation_ = target_orientation.normalized();
+    }
+    last_target_pose_stamp_ns_ = target_pose->stamp_ns;
+  }
+
+  // pose error in the chain root, shortest rotation
+  error_.head<3>() = target_position_ - position_;
+  if (target_orientation_.coeffs().dot(orientation_.coeffs()) < 0.) {
+    orientation_.coeffs() *= -1.;
+  }
+  const Eigen::AngleAxisd orientation_error(target_orientation_ * orientation_.inverse());
+  error_.tail<3>() = orientation_error.angle() * orientation_error.axis();
+
+  // impedance, tau = J^T (K e - D J dq)
+  twist_.noalias() = jacobian_ * dq_;
+  wrench_ = stiffness_.cwiseProduct(error_) - damping_.cwiseProduct(twist_);
+  tau_.noalias() = jacobian_.transpose() * wrench_;
+
+  // null-space posture, N = I - J^T J^#^T with J^#^T = (J J^T + lambda^2 I)^-1 J
+  jjt_.noalias() = jacobian_ * jacobian_.transpose();
+  jjt_.diagonal().array() += pinv_damping_ * pinv_damping_;
+  jjt_ldlt_.compute(jjt_);
+  jacobian_pinv_t_ = jjt_ldlt_.solve(jacobian_);
+  nullspace_projector_.setIdentity();
+  nullspace_projector_.noalias() -= jacobian_.transpose() * jacobian_pinv_t_;
+  tau_.noalias() += nullspace_projector_ *
+                    (nullspace_stiffness_ * (q_nullspace_ - q_) - nullspace_damping_ * dq_);
+
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    joint_position_command_interfaces_[idx].get().set_value(q_[idx]);
+    torque_command_interfaces_[idx].get().set_value(
+        std::max(-max_torque_, std::min(tau_[idx], max_torque_)));
+  }
+  return controller_interface::return_type::OK;
+}
+
+controller_interface::CallbackReturn
+CartesianImpedanceController::on_configure(const rclcpp_lifecycle::State & /*previous_state*/) {
+  if (!parse_cart_vector_("stiffness", stiffness_) || !parse_cart_vector_("damping", damping_)) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  nullspace_stiffness_ = this->get_node()->get_parameter("nullspace_stiffness").as_double();
+  nullspace_damping_ = this->get_node()->get_parameter("nullspace_damping").as_double();
+  pinv_damping_ = this->get_node()->get_parameter("pinv_damping").as_double();
+  max_torque_ = this->get_node()->get_parameter("max_torque").as_double();
+  if ((stiffness_.array() < 0.).any() || (damping_.array() < 0.).any() ||
+      nullspace_stiffness_ < 0. || nullspace_damping_ < 0. || pinv_damping_ <= 0. ||
+      max_torque_ <= 0.) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Expected non-negative stiffness and damping, and positive pinv_damping and "
+                 "max_torque.");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn
+CartesianImpedanceController::on_activate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  if (!reference_command_interfaces_()) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (!reference_state_interfaces_()) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  // target the pose on the first valid state
+  initialized_ = false;
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn
+CartesianImpedanceController::on_deactivate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  for (auto &torque_command_interface : torque_command_interfaces_) {
+    torque_command_interface.get().set_value(0.);
+  }
+  clear_command_interfaces_();
+  clear_state_interfaces_();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+bool CartesianImpedanceController::reference_command_interfaces_() {
+  for (auto &command_interface : command_interfaces_) {
+    if (command_interface.get_interface_name() == hardware_interface::HW_IF_POSITION) {
+      joint_position_command_interfaces_.emplace_back(std::ref(command_interface));
+    }
+    if (command_interface.get_interface_name() == hardware_interface::HW_IF_EFFORT) {
+      torque_command_interfaces_.emplace_back(std::ref(command_interface));
+    }
+  }
+  if (joint_position_command_interfaces_.size() != N || torque_command_interfaces_.size() != N) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Expected %d joint position and %d torque command interfaces, got %ld and %ld.",
+                 N, N, joint_position_command_interfaces_.size(),
+                 torque_command_interfaces_.size());
+    return false;
+  }
+  return true;
+}
+
+bool CartesianImpedanceController::reference_state_interfaces_() {
+  // state interfaces are ordered as in state_interface_configuration
+  for (auto &state_interface : state_interfaces_) {
+    if (state_interface.get_prefix_name() == HW_IF_KINEMATICS_PREFIX) {
+      const auto &interface_name = state_interface.get_interface_name();
+      if (interface_name.rfind(HW_IF_JACOBIAN_PREFIX, 0) == 0) {
+        jacobian_state_interfaces_.emplace_back(std::ref(state_interface));
+      } else if (interface_name.rfind("position", 0) == 0) {
+        position_state_interfaces_.emplace_back(std::ref(state_interface));
+      } else {
+        orientation_state_interfaces_.emplace_back(std::ref(state_interface));
+      }
+    } else if (state_interface.get_interface_name() == hardware_interface::HW_IF_POSITION) {
+      joint_position_state_interfaces_.emplace_back(std::ref(state_interface));
+    } else if (state_interface.get_interface_name() == hardware_interface::HW_IF_VELOCITY) {
+      joint_velocity_state_interfaces_.emplace_back(std::ref(state_interface));
+    }
+  }
+  if (joint_position_state_interfaces_.size() != N ||
+      joint_velocity_state_interfaces_.size() != N || position_state_interfaces_.size() != 3 ||
+      orientation_state_interfaces_.size() != 4 ||
+      jacobian_state_interfaces_.size() != CARTESIAN_DOF * N) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Expected %d joint position, %d joint velocity, 3 position, 4 orientation and %d "
+                 "jacobian state interfaces, got %ld, %ld, %ld, %ld and %ld.",
+                 N, N, CARTESIAN_DOF * N, joint_position_state_interfaces_.size(),
+                 joint_velocity_state_interfaces_.size(), position_state_interfaces_.size(),
+                 orientation_state_interfaces_.size(), jacobian_state_interfaces_.size());
+    return false;
+  }
+  return true;
+}
+
+void CartesianImpedanceController::clear_command_interfaces_() {
+  joint_position_command_interfaces_.clear();
+  torque_command_interfaces_.clear();
+}
+
+void CartesianImpedanceController::clear_state_interfaces_() {
+  joint_position_state_interfaces_.clear();
+  joint_velocity_state_interfaces_.clear();
+  position_state_interfaces_.clear();
+  orientation_state_interfaces_.clear();
+  jacobian_state_interfaces_.clear();
+}
+
+bool CartesianImpedanceController::read_state_() {
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    q_[idx] = joint_position_state_interfaces_[idx].get().get_value();
+    dq_[idx] = joint_velocity_state_interfaces_[idx].get().get_value();
+  }
+  for (std::size_t idx = 0; idx < 3; ++idx) {
+    position_[idx] = position_state_interfaces_[idx].get().get_value();
+  }
+  orientation_ = Eigen::Quaterniond(orientation_state_interfaces_[3].get().get_value(),
+                                    orientation_state_interfaces_[0].get().get_value(),
+                                    orientation_state_interfaces_[1].get().get_value(),
+                                    orientation_state_interfaces_[2].get().get_value());
+  for (std::size_t row = 0; row < CARTESIAN_DOF; ++row) {
+    for (std::size_t col = 0; col < N; ++col) {
+      jacobian_(row, col) = jacobian_state_interfaces_[row * N + col].get().get_value();
+    }
+  }
+  return q_.allFinite() && dq_.allFinite() && position_.allFinite() &&
+         orientation_.coeffs().allFinite() && jacobian_.allFinite();
+}
+
+bool CartesianImpedanceController::parse_cart_vector_(const std::string &name,
+                                                      cart_vector_t &cart_vector) {
+  const auto values = this->get_node()->get_parameter(name).as_double_array();
+  if (values.size() != CARTESIAN_DOF) {
+    RCLCPP_ERROR(this->get_node()->get_logger(), "Expected %d values for '%s', got %ld.",
+                 CARTESIAN_DOF, name.c_str(), values.size());
+    return false;
+  }
+  cart_vector = Eigen::Map<const cart_vector_t>(values.data());
+  return true;
+}
+} // namespace lbr_ros2_control
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(lbr_ros2_control::CartesianImpedanceController,
+                       controller_interface::ControllerInterface)
@@ -0,0 +1,128 @@
+#include "lbr_ros2_control/controllers/command_age_monitor.hpp"
+
+namespace lbr_ros2_control {
+CommandAgeMonitor::CommandAgeMonitor()
+    : max_command_age_(0.), stale_behavior_(StaleBehavior::HOLD), decay_time_constant_(0.1),
+      commands_(0), stale_updates_(0), latency_sum_ns_(0), latency_max_ns_(0) {}
+
+void CommandAgeMonitor::declare_parameters(
+    const std::shared_ptr<rclcpp_lifecycle::LifecycleNode> &node) {
+  node->declare_parameter<double>("max_command_age", max_command_age_);
+  node->declare_parameter<std::string>("stale_command_behavior", "hold");
+  node->declare_parameter<double>("decay_time_constant", decay_time_constant_);
+  node->declare_parameter<double>("diagnostics_period", 1.);
+}
+
+bool CommandAgeMonitor::configure(const std::shared_ptr<rclcpp_lifecycle::LifecycleNode> &node) {
+  max_command_age_ = node->get_parameter("max_command_age").as_double();
+  const auto stale_behavior = node->get_parameter("stale_command_behavior").as_string();
+  if (stale_behavior == "hold") {
+    stale_behavior_ = StaleBehavior::HOLD;
+  } else if (stale_behavior == "decay") {
+    stale_behavior_ = StaleBehavior::DECAY;
+  } else {
+    RCLCPP_ERROR(node->get_logger(),
+                 "Unknown stale_command_behavior '%s', expected 'hold' or 'decay'.",
+                 stale_behavior.c_str());
+    return false;
+  }
+  decay_time_constant_ = node->get_parameter("decay_time_constant").as_double();
+  if (decay_time_constant_ <= 0.) {
+    RCLCPP_ERROR(node->get_logger(), "Expected decay_time_constant > 0, got %f.",
+                 decay_time_constant_);
+    return false;
+  }
+  const double diagnostics_period = node->get_parameter("diagnostics_period").as_double();
+  if (diagnostics_period <= 0.) {
+    RCLCPP_ERROR(node->get_logger(), "Expected diagnostics_period > 0, got %f.",
+                 diagnostics_period);
+    return false;
+  }
+
+  name_ = node->get_fully_qualified_name();
+  clock_ptr_ = node->get_clock();
+  diagnostics_publisher_ptr_ =
+      node->create_publisher<diagnostic_msgs::msg::DiagnosticArray>("/diagnostics", 1);
+  diagnostics_timer_ptr_ = node->create_wall_timer(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::duration<double>(diagnostics_period)),
+      [this]() { publish_diagnostics_(); });
+  return true;
+}
+
+int64_t CommandAgeMonitor::stamp(const rclcpp::MessageInfo &message_info) {
+  const auto &rmw_message_info = message_info.get_rmw_message_info();
+  if (rmw_message_info.source_timestamp > 0) {
+    return rmw_message_info.source_timestamp;
+  }
+  if (rmw_message_info.received_timestamp > 0) {
+    return rmw_message_info.received_timestamp;
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+bool CommandAgeMonitor::is_fresh(const int64_t &stamp_ns, const bool &is_new) {
+  const int64_t age_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count() -
+                         stamp_ns;
+  if (is_new) {
+    ++commands_;
+    latency_sum_ns_ += age_ns;
+    int64_t latency_max_ns = latency_max_ns_.load();
+    while (age_ns > latency_max_ns &&
+           !latency_max_ns_.compare_exchange_weak(latency_max_ns, age_ns)) {
+    }
+  }
+  if (max_command_age_ <= 0. || age_ns <= static_cast<int64_t>(max_command_age_ * 1.e9)) {
+    return true;
+  }
+  ++stale_updates_;
+  return false;
+}
+
+double CommandAgeMonitor::decay_factor(const double &dt) const {
+  if (stale_behavior_ == StaleBehavior::HOLD) {
+    return 1.;
+  }
+  return std::exp(-dt / decay_time_constant_);
+}
+
+void CommandAgeMonitor::publish_diagnostics_() {
+  const uint64_t commands = commands_.exchange(0);
+  const uint64_t stale_updates = stale_updates_.exchange(0);
+  const int64_t latency_sum_ns = latency_sum_ns_.exchange(0);
+  const int64_t latency_max_ns = latency_max_ns_.exchange(0);
+
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.name = name_;
+  status.hardware_id = "lbr";
+  if (stale_updates > 0) {
+    status.level = diagnostic_msgs::msg::DiagnosticStatus::WARN;
+    status.message = "Stale commands.";
+  } else {
+    status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+    status.message = commands > 0 ? "Commands fresh." : "No commands.";
+  }
+  diagnostic_msgs::msg::KeyValue key_value;
+  key_value.key = "commands";
+  key_value.value = std::to_string(commands);
+  status.values.push_back(key_value);
+  key_value.key = "mean latency [ms]";
+  key_value.value = std::to_string(commands > 0 ? 1.e-6 * latency_sum_ns / commands : 0.);
+  status.values.push_back(key_value);
+  key_value.key = "max latency [ms]";
+  key_value.value = std::to_string(1.e-6 * latency_max_ns);
+  status.values.push_back(key_value);
+  key_value.key = "stale updates";
+  key_value.value = std::to_string(stale_updates);
+  status.values.push_back(key_value);
+
+  diagnostic_msgs::msg::DiagnosticArray diagnostic_array;
+  diagnostic_array.header.stamp = clock_ptr_->now();
+  diagnostic_array.status.push_back(status);
+  diagnostics_publisher_ptr_->publish(diagnostic_array);
+}
+} // namespace lbr_ros2_control
@@ -0,0 +1,364 @@
+#include "lbr_ros2_control/controllers/joint_impedance_controller.hpp"
+
+namespace lbr_ros2_control {
+JointImpedanceController::JointImpedanceController()
+    : gain_ramp_time_(1.), max_torque_(20.), gravity_compensation_(false),
+      coriolis_compensation_(false), on_set_gains_handle_ptr_(nullptr), ramp_progress_(1.),
+      last_setpoint_stamp_ns_(0), setpoint_subscription_ptr_(nullptr),
+      robot_description_subscription_ptr_(nullptr), chain_dyn_param_ptr_(nullptr),
+      initialized_(false) {
+  target_gains_nrt_.stiffness = {200., 200., 200., 200., 100., 50., 20.};
+  target_gains_nrt_.damping = {20., 20., 20., 20., 10., 5., 2.};
+}
+
+controller_interface::InterfaceConfiguration
+JointImpedanceController::command_interface_configuration() const {
+  controller_interface::InterfaceConfiguration interface_configuration;
+  interface_configuration.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto &joint_name : joint_names_) {
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_POSITION);
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_EFFORT);
+  }
+  return interface_configuration;
+}
+
+controller_interface::InterfaceConfiguration
+JointImpedanceController::state_interface_configuration() const {
+  controller_interface::InterfaceConfiguration interface_configuration;
+  interface_configuration.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto &joint_name : joint_names_) {
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_POSITION);
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_VELOCITY);
+  }
+  return interface_configuration;
+}
+
+controller_interface::CallbackReturn JointImpedanceController::on_init() {
+  try {
+    this->get_node()->declare_parameter<std::vector<double>>(
+        "stiffness", std::vector<double>(target_gains_nrt_.stiffness.begin(),
+                                         target_gains_nrt_.stiffness.end()));
+    this->get_node()->declare_parameter<std::vector<double>>(
+        "damping",
+        std::vector<double>(target_gains_nrt_.damping.begin(), target_gains_nrt_.damping.end()));
+    this->get_node()->declare_parameter<double>("gain_ramp_time", gain_ramp_time_);
+    this->get_node()->declare_parameter<double>("max_torque", max_torque_);
+    this->get_node()->declare_parameter<bool>("gravity_compensation", gravity_compensation_);
+    this->get_node()->declare_parameter<bool>("coriolis_compensation", coriolis_compensation_);
+    this->get_node()->declare_parameter<std::vector<double>>("gravity", {0., 0., -9.81});
+    this->get_node()->declare_parameter<std::string>("chain_root", "link_0");
+    this->get_node()->declare_parameter<std::string>("chain_tip", "link_ee");
+    this->get_node()->declare_parameter<std::string>("robot_description", "");
+    this->get_node()->declare_parameter<double>("robot_description_timeout", 5.);
+    on_set_gains_handle_ptr_ = this->get_node()->add_on_set_parameters_callback(
+        [this](const std::vector<rclcpp::Parameter> &parameters) {
+          return on_set_gains_(parameters);
+        });
+    setpoint_subscription_ptr_ =
+        this->get_node()->create_subscription<lbr_fri_idl::msg::LBRJointPositionCommand>(
+            "command/joint_position", 1,
+            [this](const lbr_fri_idl::msg::LBRJointPositionCommand::SharedPtr msg,
+                   const rclcpp::MessageInfo &message_info) {
+              rt_setpoint_.writeFromNonRT({*msg, CommandAgeMonitor::stamp(message_info)});
+            },
+            rclcpp::SubscriptionOptions(),
+            std::make_shared<command_message_pool_t<lbr_fri_idl::msg::LBRJointPositionCommand>>());
+    // latched by the robot_state_publisher, not necessarily received before configuration
+    robot_description_subscription_ptr_ =
+        this->get_node()->create_subscription<std_msgs::msg::String>(
+            "robot_description", rclcpp::QoS(1).transient_local(),
+            [this](const std_msgs::msg::String::SharedPtr msg) {
+              {
+                std::lock_guard<std::mutex> lock(robot_description_mutex_);
+                robot_description_ = msg->data;
+              }
+              robot_description_cv_.notify_all();
+            });
+  } catch (const std::exception &e) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Failed to initialize joint impedance controller with: %s.", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type
+JointImpedanceController::update(const rclcpp::Time & /*time*/, const rclcpp::Duration &period) {
+  if (!read_state_()) {
+    // no torque overlay, hold the last joint position
+    for (std::size_t idx = 0; idx < N; ++idx) {
+      torque_command_interfaces_[idx].get().set_value(0.);
+      if (initialized_) {
+        joint_position_command_interfaces_[idx].get().set_value(q_[idx]);
+      }
+    }
+    return controller_interface::return_type::OK;
+  }
+  const auto setpoint = rt_setpoint_.readFromRT();
+  if (!initialized_) {
+    // start at rest with the target gains, ignore setpoints received before activation
+    q_setpoint_ = q_;
+    last_setpoint_stamp_ns_ = setpoint->stamp_ns;
+    gains_ = *rt_target_gains_.readFromRT();
+    ramp_progress_ = 1.;
+    initialized_ = true;
+  }
+  if (setpoint->stamp_ns != last_setpoint_stamp_ns_) {
+    if (std::all_of(setpoint->msg.joint_position.begin(), setpoint->msg.joint_position.end(),
+                    [](const double &q) { return std::isfinite(q); })) {
+      std::copy(setpoint->msg.joint_position.begin(), setpoint->msg.joint_position.end(),
+                q_setpoint_.begin());
+    }
+    last_setpoint_stamp_ns_ = setpoint->stamp_ns;
+  }
+  ramp_gains_(period.seconds());
+
+  // gravity and Coriolis, zero if disabled or failed
+  if (chain_dyn_param_ptr_) {
+    for (std::size_t idx = 0; idx < N; ++idx) {
+      q_kdl_(idx) = q_[idx];
+      dq_kdl_(idx) = dq_[idx];
+    }
+    if (!gravity_compensation_ || chain_dyn_param_ptr_->JntToGravity(q_kdl_, gravity_kdl_) < 0) {
+      gravity_kdl_.data.setZero();
+    }
+    if (!coriolis_compensation_ ||
+        chain_dyn_param_ptr_->JntToCoriolis(q_kdl_, dq_kdl_, coriolis_kdl_) < 0) {
+      coriolis_kdl_.data.setZero();
+    }
+  }
+
+  // impedance, tau = K (q_d - q) - D dq + g + c
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    double tau =
+        gains_.stiffness[idx] * (q_setpoint_[idx] - q_[idx]) - gains_.damping[idx] * dq_[idx];
+    if (chain_dyn_param_ptr_) {
+      tau += gravity_kdl_(idx) + coriolis_kdl_(idx);
+    }
+    joint_position_command_interfaces_[idx].get().set_value(q_[idx]);
+    torque_command_interfaces_[idx].get().set_value(
+        std::max(-max_torque_, std::min(tau, max_torque_)));
+  }
+  return controller_interface::return_type::OK;
+}
+
+controller_interface::CallbackReturn
+JointImpedanceController::on_configure(const rclcpp_lifecycle::State & /*previous_state*/) {
+  gain_ramp_time_ = this->get_node()->get_parameter("gain_ramp_time").as_double();
+  max_torque_ = this->get_node()->get_parameter("max_torque").as_double();
+  gravity_compensation_ = this->get_node()->get_parameter("gravity_compensation").as_bool();
+  coriolis_compensation_ = this->get_node()->get_parameter("coriolis_compensation").as_bool();
+  if (gain_ramp_time_ < 0. || max_torque_ <= 0.) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Expected non-negative gain_ramp_time and positive max_torque.");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  const auto result = on_set_gains_(
+      {this->get_node()->get_parameter("stiffness"), this->get_node()->get_parameter("damping")});
+  if (!result.successful) {
+    RCLCPP_ERROR(this->get_node()->get_logger(), "%s", result.reason.c_str());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (!configure_dynamics_()) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn
+JointImpedanceController::on_activate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  if (!reference_command_interfaces_()) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (!reference_state_interfaces_()) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  // hold the joint position on the first valid state
+  initialized_ = false;
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn
+JointImpedanceController::on_deactivate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  for (auto &torque_command_interface : torque_command_interfaces_) {
+    torque_command_interface.get().set_value(0.);
+  }
+  clear_command_interfaces_();
+  clear_state_interfaces_();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+bool JointImpedanceController::reference_command_interfaces_() {
+  for (auto &command_interface : command_interfaces_) {
+    if (command_interface.get_interface_name() == hardware_interface::HW_IF_POSITION) {
+      joint_position_command_interfaces_.emplace_back(std::ref(command_interface));
+    }
+    if (command_interface.get_interface_name() == hardware_interface::HW_IF_EFFORT) {
+      torque_command_interfaces_.emplace_back(std::ref(command_interface));
+    }
+  }
+  if (joint_position_command_interfaces_.size() != N || torque_command_interfaces_.size() != N) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Expected %d joint position and %d torque command interfaces, got %ld and %ld.",
+                 N, N, joint_position_command_interfaces_.size(),
+                 torque_command_interfaces_.size());
+    return false;
+  }
+  return true;
+}
+
+bool JointImpedanceController::reference_state_interfaces_() {
+  for (auto &state_interface : state_interfaces_) {
+    if (state_interface.get_interface_name() == hardware_interface::HW_IF_POSITION) {
+      joint_position_state_interfaces_.emplace_back(std::ref(state_interface));
+    }
+    if (state_interface.get_interface_name() == hardware_interface::HW_IF_VELOCITY) {
+      joint_velocity_state_interfaces_.emplace_back(std::ref(state_interface));
+    }
+  }
+  if (joint_position_state_interfaces_.size() != N ||
+      joint_velocity_state_interfaces_.size() != N) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Expected %d joint position and %d joint velocity state interfaces, got %ld and "
+                 "%ld.",
+                 N, N, joint_position_state_interfaces_.size(),
+                 joint_velocity_state_interfaces_.size());
+    return false;
+  }
+  return true;
+}
+
+void JointImpedanceController::clear_command_interfaces_() {
+  joint_position_command_interfaces_.clear();
+  torque_command_interfaces_.clear();
+}
+
+void JointImpedanceController::clear_state_interfaces_() {
+  joint_position_state_interfaces_.clear();
+  joint_velocity_state_interfaces_.clear();
+}
+
+bool JointImpedanceController::read_state_() {
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    q_[idx] = joint_position_state_interfaces_[idx].get().get_value();
+    dq_[idx] = joint_velocity_state_interfaces_[idx].get().get_value();
+  }
+  return std::all_of(q_.begin(), q_.end(), [](const double &q) { return std::isfinite(q); }) &&
+         std::all_of(dq_.begin(), dq_.end(), [](const double &dq) { return std::isfinite(dq); });
+}
+
+bool JointImpedanceController::configure_dynamics_() {
+  chain_dyn_param_ptr_.reset();
+  if (!gravity_compensation_ && !coriolis_compensation_) {
+    return true;
+  }
+  std::string robot_description =
+      this->get_node()->get_parameter("robot_description").as_string();
+  if (robot_description.empty()) {
+    // wait for the topic, served by the controller_manager's multi-threaded executor
+    const double timeout =
+        this->get_node()->get_parameter("robot_description_timeout").as_double();
+    std::unique_lock<std::mutex> lock(robot_description_mutex_);
+    robot_description_cv_.wait_for(lock, std::chrono::duration<double>(std::max(timeout, 0.)),
+                                   [this]() { return !robot_description_.empty(); });
+    robot_description = robot_description_;
+  }
+  if (robot_description.empty()) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "No robot description set or received on '%s' within %.1f s, required for "
+                 "gravity and Coriolis compensation.",
+                 robot_description_subscription_ptr_->get_topic_name(),
+                 this->get_node()->get_parameter("robot_description_timeout").as_double());
+    return false;
+  }
+  const auto chain_root = this->get_node()->get_parameter("chain_root").as_string();
+  const auto chain_tip = this->get_node()->get_parameter("chain_tip").as_string();
+  const auto gravity = this->get_node()->get_parameter("gravity").as_double_array();
+  if (gravity.size() != 3) {
+    RCLCPP_ERROR(this->get_node()->get_logger(), "Expected 3 values for 'gravity', got %ld.",
+                 gravity.size());
+    return false;
+  }
+  KDL::Tree tree;
+  KDL::Chain chain;
+  if (!kdl_parser::treeFromString(robot_description, tree) ||
+      !tree.getChain(chain_root, chain_tip, chain) || chain.getNrOfJoints() != N) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Failed to extract a chain with %d joints from '%s' to '%s'.", N,
+                 chain_root.c_str(), chain_tip.c_str());
+    return false;
+  }
+  chain_dyn_param_ptr_ = std::make_unique<KDL::ChainDynParam>(
+      chain, KDL::Vector(gravity[0], gravity[1], gravity[2]));
+  q_kdl_.resize(N);
+  dq_kdl_.resize(N);
+  gravity_kdl_.resize(N);
+  coriolis_kdl_.resize(N);
+  RCLCPP_INFO(this->get_node()->get_logger(),
+              "Compensating%s%s from '%s' to '%s'.", gravity_compensation_ ? " gravity" : "",
+              coriolis_compensation_ ? " Coriolis" : "", chain_root.c_str(), chain_tip.c_str());
+  return true;
+}
+
+rcl_interfaces::msg::SetParametersResult
+JointImpedanceController::on_set_gains_(const std::vector<rclcpp::Parameter> &parameters) {
+  rcl_interfaces::msg::SetParametersResult result;
+  result.successful = true;
+  std::lock_guard<std::mutex> lock(target_gains_nrt_mutex_);
+  Gains target_gains = target_gains_nrt_;
+  bool gains_changed = false;
+  for (const auto &parameter : parameters) {
+    if (parameter.get_name() != "stiffness" && parameter.get_name() != "damping") {
+      continue;
+    }
+    const auto values = parameter.as_double_array();
+    if (values.size() != N ||
+        std::any_of(values.begin(), values.end(),
+                    [](const double &value) { return !std::isfinite(value) || value < 0.; })) {
+      result.successful = false;
+      result.reason = "Expected " + std::to_string(N) + " non-negative values for '" +
+                      parameter.get_name() + "'.";
+      return result;
+    }
+    auto &gains = parameter.get_name() == "stiffness" ? target_gains.stiffness
+                                                      : target_gains.damping;
+    std::copy(values.begin(), values.end(), gains.begin());
+    gains_changed = true;
+  }
+  if (gains_changed) {
+    ++target_gains.revision;
+    target_gains_nrt_ = target_gains;
+    rt_target_gains_.writeFromNonRT(target_gains_nrt_);
+  }
+  return result;
+}
+
+void JointImpedanceController::ramp_gains_(const double &dt) {
+  const auto target_gains = rt_target_gains_.readFromRT();
+  if (target_gains->revision != gains_.revision) {
+    // (re)start the ramp from the current gains
+    ramp_start_gains_ = gains_;
+    gains_.revision = target_gains->revision;
+    ramp_progress_ = 0.;
+  }
+  if (ramp_progress_ >= 1.) {
+    return;
+  }
+  ramp_progress_ =
+      gain_ramp_time_ > 0. ? std::min(ramp_progress_ + std::max(dt, 0.) / gain_ramp_time_, 1.) : 1.;
+  // smoothstep, no steps in the gains' rate of change
+  const double alpha = ramp_progress_ * ramp_progress_ * (3. - 2. * ramp_progress_);
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    gains_.stiffness[idx] =
+        ramp_start_gains_.stiffness[idx] +
+        alpha * (target_gains->stiffness[idx] - ramp_start_gains_.stiffness[idx]);
+    gains_.damping[idx] = ramp_start_gains_.damping[idx] +
+                          alpha * (target_gains->damping[idx] - ramp_start_gains_.damping[idx]);
+  }
+}
+} // namespace lbr_ros2_control
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(lbr_ros2_control::JointImpedanceController,
+                       controller_interface::ControllerInterface)
@@ -2,8 +2,7 @@
 
 namespace lbr_ros2_control {
 LBRJointPositionCommandController::LBRJointPositionCommandController()
-    : rt_lbr_joint_position_command_ptr_(nullptr),
-      lbr_joint_position_command_subscription_ptr_(nullptr) {}
+    : lbr_joint_position_command_subscription_ptr_(nullptr), last_stamp_ns_(0) {}
 
 controller_interface::InterfaceConfiguration
 LBRJointPositionCommandController::command_interface_configuration() const {
@@ -26,9 +25,14 @@ controller_interface::CallbackReturn LBRJointPositionCommandController::on_init(
     lbr_joint_position_command_subscription_ptr_ =
         this->get_node()->create_subscription<lbr_fri_idl::msg::LBRJointPositionCommand>(
             "command/joint_position", 1,
-            [this](const lbr_fri_idl::msg::LBRJointPositionCommand::SharedPtr msg) {
-              rt_lbr_joint_position_command_ptr_.writeFromNonRT(msg);
-            });
+            [this](const lbr_fri_idl::msg::LBRJointPositionCommand::SharedPtr msg,
+                   const rclcpp::MessageInfo &message_info) {
+              rt_lbr_joint_position_command_ptr_.writeFromNonRT(
+                  {*msg, CommandAgeMonitor::stamp(message_info)});
+            },
+            rclcpp::SubscriptionOptions(),
+            std::make_shared<command_message_pool_t<lbr_fri_idl::msg::LBRJointPositionCommand>>());
+    command_age_monitor_.declare_parameters(this->get_node());
   } catch (const std::exception &e) {
     RCLCPP_ERROR(this->get_node()->get_logger(),
                  "Failed to initialize LBR position command controller with: %s.", e.what());
@@ -42,23 +46,33 @@ controller_interface::return_type
 LBRJointPositionCommandController::update(const rclcpp::Time & /*time*/,
                                           const rclcpp::Duration & /*period*/) {
   auto lbr_joint_position_command = rt_lbr_joint_position_command_ptr_.readFromRT();
-  if (!lbr_joint_position_command || !(*lbr_joint_position_command)) {
+  if (!lbr_joint_position_command || lbr_joint_position_command->stamp_ns == 0) {
     return controller_interface::return_type::OK;
   }
+  const bool is_new = lbr_joint_position_command->stamp_ns != last_stamp_ns_;
+  last_stamp_ns_ = lbr_joint_position_command->stamp_ns;
+  if (!command_age_monitor_.is_fresh(lbr_joint_position_command->stamp_ns, is_new)) {
+    return controller_interface::return_type::OK; // hold
+  }
   std::for_each(command_interfaces_.begin(), command_interfaces_.end(),
                 [lbr_joint_position_command, idx = 0](auto &command_interface) mutable {
-                  command_interface.set_value((*lbr_joint_position_command)->joint_position[idx++]);
+                  command_interface.set_value(
+                      lbr_joint_position_command->msg.joint_position[idx++]);
                 });
   return controller_interface::return_type::OK;
 }
 
 controller_interface::CallbackReturn LBRJointPositionCommandController::on_configure(
     const rclcpp_lifecycle::State & /*previous_state*/) {
+  if (!command_age_monitor_.configure(this->get_node())) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
 controller_interface::CallbackReturn
 LBRJointPositionCommandController::on_activate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  last_stamp_ns_ = 0;
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
@@ -0,0 +1,277 @@
+#include "lbr_ros2_control/controllers/lbr_joint_position_stream_controller.hpp"
+
+namespace lbr_ros2_control {
+LBRJointPositionStreamController::LBRJointPositionStreamController()
+    : max_joint_velocity_(1.0), joint_trajectory_subscription_ptr_(nullptr),
+      last_queued_time_ns_(std::numeric_limits<int64_t>::min()), reported_underruns_(0),
+      reported_late_setpoints_(0), underruns_(0), late_setpoints_(0), initialized_(false),
+      streaming_(false), drained_(false) {}
+
+controller_interface::InterfaceConfiguration
+LBRJointPositionStreamController::command_interface_configuration() const {
+  controller_interface::InterfaceConfiguration interface_configuration;
+  interface_configuration.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto &joint_name : joint_names_) {
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return interface_configuration;
+}
+
+controller_interface::InterfaceConfiguration
+LBRJointPositionStreamController::state_interface_configuration() const {
+  controller_interface::InterfaceConfiguration interface_configuration;
+  interface_configuration.type = controller_interface::interface_configuration_type::INDIVIDUAL;
+  for (const auto &joint_name : joint_names_) {
+    interface_configuration.names.push_back(joint_name + "/" + hardware_interface::HW_IF_POSITION);
+  }
+  return interface_configuration;
+}
+
+controller_interface::CallbackReturn LBRJointPositionStreamController::on_init() {
+  try {
+    this->get_node()->declare_parameter<int>("ring_capacity", 1000);
+    this->get_node()->declare_parameter<double>("max_joint_velocity", max_joint_velocity_);
+    const auto ring_capacity = this->get_node()->get_parameter("ring_capacity").as_int();
+    if (ring_capacity < 2) {
+      RCLCPP_ERROR(this->get_node()->get_logger(), "Expected ring_capacity >= 2.");
+      return controller_interface::CallbackReturn::ERROR;
+    }
+
+    // preallocate before the subscription produces
+    setpoint_ring_.reset(static_cast<std::size_t>(ring_capacity));
+    joint_trajectory_subscription_ptr_ =
+        this->get_node()->create_subscription<trajectory_msgs::msg::JointTrajectory>(
+            "command/joint_position_stream", rclcpp::QoS(10).reliable(),
+            [this](const trajectory_msgs::msg::JointTrajectory::SharedPtr msg) {
+              queue_setpoints_(*msg);
+            });
+  } catch (const std::exception &e) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Failed to initialize LBR joint position stream controller with: %s.", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::return_type
+LBRJointPositionStreamController::update(const rclcpp::Time &time,
+                                         const rclcpp::Duration &period) {
+  if (!initialized_) {
+    // start from the measured joint position
+    for (std::size_t idx = 0; idx < N; ++idx) {
+      q_command_[idx] = joint_position_state_interfaces_[idx].get().get_value();
+    }
+    if (std::any_of(q_command_.begin(), q_command_.end(),
+                    [](const double &q) { return !std::isfinite(q); })) {
+      return controller_interface::return_type::OK;
+    }
+    q_target_ = q_command_;
+    streaming_ = false;
+    drained_ = false;
+    initialized_ = true;
+  }
+  advance_(time.nanoseconds());
+
+  // limit joint velocities, e.g. when restarting from the current command
+  const double max_dq = max_joint_velocity_ * std::max(period.seconds(), 0.);
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    q_command_[idx] += std::max(-max_dq, std::min(q_target_[idx] - q_command_[idx], max_dq));
+    joint_position_command_interfaces_[idx].get().set_value(q_command_[idx]);
+  }
+  return controller_interface::return_type::OK;
+}
+
+controller_interface::CallbackReturn LBRJointPositionStreamController::on_configure(
+    const rclcpp_lifecycle::State & /*previous_state*/) {
+  max_joint_velocity_ = this->get_node()->get_parameter("max_joint_velocity").as_double();
+  if (max_joint_velocity_ <= 0.) {
+    RCLCPP_ERROR(this->get_node()->get_logger(), "Expected positive max_joint_velocity.");
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn LBRJointPositionStreamController::on_activate(
+    const rclcpp_lifecycle::State & /*previous_state*/) {
+  if (!reference_command_interfaces_()) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  if (!reference_state_interfaces_()) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  initialized_ = false;
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn LBRJointPositionStreamController::on_deactivate(
+    const rclcpp_lifecycle::State & /*previous_state*/) {
+  clear_command_interfaces_();
+  clear_state_interfaces_();
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+bool LBRJointPositionStreamController::reference_command_interfaces_() {
+  for (auto &command_interface : command_interfaces_) {
+    if (command_interface.get_interface_name() == hardware_interface::HW_IF_POSITION) {
+      joint_position_command_interfaces_.emplace_back(std::ref(command_interface));
+    }
+  }
+  if (joint_position_command_interfaces_.size() != N) {
+    RCLCPP_ERROR(
+        this->get_node()->get_logger(),
+        "Number of joint position command interfaces '%ld' does not match the number of joints "
+        "in the robot '%d'.",
+        joint_position_command_interfaces_.size(), N);
+    return false;
+  }
+  return true;
+}
+
+bool LBRJointPositionStreamController::reference_state_interfaces_() {
+  for (auto &state_interface : state_interfaces_) {
+    if (state_interface.get_interface_name() == hardware_interface::HW_IF_POSITION) {
+      joint_position_state_interfaces_.emplace_back(std::ref(state_interface));
+    }
+  }
+  if (joint_position_state_interfaces_.size() != N) {
+    RCLCPP_ERROR(
+        this->get_node()->get_logger(),
+        "Number of joint position state interfaces '%ld' does not match the number of joints "
+        "in the robot '%d'.",
+        joint_position_state_interfaces_.size(), N);
+    return false;
+  }
+  return true;
+}
+
+void LBRJointPositionStreamController::clear_command_interfaces_() {
+  joint_position_command_interfaces_.clear();
+}
+
+void LBRJointPositionStreamController::clear_state_interfaces_() {
+  joint_position_state_interfaces_.clear();
+}
+
+void LBRJointPositionStreamController::queue_setpoints_(
+    const trajectory_msgs::msg::JointTrajectory &joint_trajectory) {
+  // map the message's joint order, defaults to A1 to A7
+  std::array<std::size_t, N> joint_indices;
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    joint_indices[idx] = idx;
+  }
+  if (!joint_trajectory.joint_names.empty()) {
+    for (std::size_t idx = 0; idx < N; ++idx) {
+      const auto joint_name = std::find(joint_trajectory.joint_names.begin(),
+                                        joint_trajectory.joint_names.end(), joint_names_[idx]);
+      if (joint_name == joint_trajectory.joint_names.end()) {
+        RCLCPP_WARN(this->get_node()->get_logger(), "Joint '%s' missing, chunk dropped.",
+                    joint_names_[idx].c_str());
+        return;
+      }
+      joint_indices[idx] = std::distance(joint_trajectory.joint_names.begin(), joint_name);
+    }
+  }
+
+  // setpoints relative to the stamp, or to the reception if unstamped, on the node clock, which
+  // has to be the clock update() runs against
+  const rclcpp::Time stamp = rclcpp::Time(joint_trajectory.header.stamp).nanoseconds() == 0
+                                 ? this->get_node()->now()
+                                 : rclcpp::Time(joint_trajectory.header.stamp);
+  std::size_t dropped = 0, overflown = 0;
+  Setpoint setpoint;
+  for (const auto &point : joint_trajectory.points) {
+    if (point.positions.size() != joint_trajectory.joint_names.size() &&
+        !(joint_trajectory.joint_names.empty() && point.positions.size() == N)) {
+      ++dropped;
+      continue;
+    }
+    setpoint.time_ns = stamp.nanoseconds() + rclcpp::Duration(point.time_from_start).nanoseconds();
+    if (setpoint.time_ns <= last_queued_time_ns_) {
+      ++dropped;
+      continue;
+    }
+    for (std::size_t idx = 0; idx < N; ++idx) {
+      setpoint.joint_position[idx] = point.positions[joint_indices[idx]];
+    }
+    if (std::any_of(setpoint.joint_position.begin(), setpoint.joint_position.end(),
+                    [](const double &q) { return !std::isfinite(q); })) {
+      ++dropped;
+      continue;
+    }
+    if (!setpoint_ring_.push(setpoint)) {
+      ++overflown;
+      continue;
+    }
+    last_queued_time_ns_ = setpoint.time_ns;
+  }
+  if (dropped > 0) {
+    RCLCPP_WARN(this->get_node()->get_logger(),
+                "Dropped %ld setpoints, malformed, not finite or not after the last queued "
+                "setpoint.",
+                dropped);
+  }
+  if (overflown > 0) {
+    RCLCPP_WARN(this->get_node()->get_logger(),
+                "Setpoint ring full, dropped %ld setpoints. Consider increasing ring_capacity.",
+                overflown);
+  }
+
+  // report the update thread's underruns
+  const uint64_t underruns = underruns_;
+  const uint64_t late_setpoints = late_setpoints_;
+  if (underruns != reported_underruns_ || late_setpoints != reported_late_setpoints_) {
+    RCLCPP_WARN(this->get_node()->get_logger(),
+                "Stream underruns: %lu, setpoints received too late: %lu, in total.", underruns,
+                late_setpoints);
+    reported_underruns_ = underruns;
+    reported_late_setpoints_ = late_setpoints;
+  }
+}
+
+void LBRJointPositionStreamController::advance_(const int64_t &time_ns) {
+  // consume setpoints that are due
+  while ((!streaming_ || next_.time_ns <= time_ns) && setpoint_ring_.pop(setpoint_)) {
+    if (streaming_) {
+      previous_ = next_;
+      next_ = setpoint_;
+      continue;
+    }
+    if (setpoint_.time_ns <= time_ns) {
+      ++late_setpoints_;
+      if (drained_) {
+        // the stream continues behind the clock, the sender fell behind
+        ++underruns_;
+        drained_ = false;
+      }
+      continue;
+    }
+    // (re)start from the current command
+    previous_.time_ns = time_ns;
+    previous_.joint_position = q_command_;
+    next_ = setpoint_;
+    streaming_ = true;
+    drained_ = false;
+  }
+  if (!streaming_) {
+    return; // hold q_target_
+  }
+  if (next_.time_ns <= time_ns) {
+    // drained, hold the last setpoint, finished unless late setpoints follow
+    q_target_ = next_.joint_position;
+    streaming_ = false;
+    drained_ = true;
+    return;
+  }
+  const double alpha = static_cast<double>(time_ns - previous_.time_ns) /
+                       static_cast<double>(next_.time_ns - previous_.time_ns);
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    q_target_[idx] = previous_.joint_position[idx] +
+                     alpha * (next_.joint_position[idx] - previous_.joint_position[idx]);
+  }
+}
+} // namespace lbr_ros2_control
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(lbr_ros2_control::LBRJointPositionStreamController,
+                       controller_interface::ControllerInterface)
@@ -1,6 +1,17 @@
 #include "lbr_ros2_control/controllers/lbr_state_broadcaster.hpp"
 
 namespace lbr_ros2_control {
+LBRStateBroadcaster::LBRStateBroadcaster()
+    : loan_state_(false), lossless_(false), batch_size_(1), publishing_(false), dropped_samples_(0),
+      sample_count_(0) {}
+
+LBRStateBroadcaster::~LBRStateBroadcaster() {
+  publishing_ = false;
+  if (publish_thread_.joinable()) {
+    publish_thread_.join();
+  }
+}
+
 controller_interface::InterfaceConfiguration
 LBRStateBroadcaster::command_interface_configuration() const {
   return controller_interface::InterfaceConfiguration{
@@ -15,12 +26,14 @@ LBRStateBroadcaster::state_interface_configuration() const {
 
 controller_interface::CallbackReturn LBRStateBroadcaster::on_init() {
   try {
-    state_publisher_ptr_ =
-        this->get_node()->create_publisher<lbr_fri_idl::msg::LBRState>("state", 1);
-
-    rt_state_publisher_ptr_ =
-        std::make_shared<realtime_tools::RealtimePublisher<lbr_fri_idl::msg::LBRState>>(
-            state_publisher_ptr_);
+    this->get_node()->declare_parameter<bool>("loaned_messages", false);
+    this->get_node()->declare_parameter<bool>("lossless", false);
+    this->get_node()->declare_parameter<int>("batch_size", 10);
+    this->get_node()->declare_parameter<int>("ring_capacity", 1000);
+    this->get_node()->declare_parameter<std::vector<std::string>>("decimated_topics",
+                                                                  std::vector<std::string>{});
+    this->get_node()->declare_parameter<std::vector<int64_t>>("decimations",
+                                                              std::vector<int64_t>{});
     if (joint_names_.size() != KUKA::FRI::LBRState::NUMBER_OF_JOINTS) {
       RCLCPP_ERROR(
           this->get_node()->get_logger(),
@@ -39,120 +52,274 @@ controller_interface::CallbackReturn LBRStateBroadcaster::on_init() {
 
 controller_interface::return_type LBRStateBroadcaster::update(const rclcpp::Time & /*time*/,
                                                               const rclcpp::Duration & /*period*/) {
-  for (const auto &state_interface : state_interfaces_) {
-    state_interface_map_[state_interface.get_prefix_name()][state_interface.get_interface_name()] =
-        state_interface.get_value();
+  // straight copy through the tables resolved on activation
+  for (const auto &field : double_fields_) {
+    *field.second = field.first->get_value();
+  }
+  for (const auto &field : int8_fields_) {
+    *field.second = static_cast<int8_t>(field.first->get_value());
+  }
+  for (const auto &field : uint32_fields_) {
+    *field.second = static_cast<uint32_t>(field.first->get_value());
   }
   // check any for nan
-  if (std::isnan(state_interface_map_[joint_names_[0]][hardware_interface::HW_IF_POSITION])) {
+  if (std::isnan(state_.measured_joint_position[0])) {
     return controller_interface::return_type::OK;
   }
-  if (rt_state_publisher_ptr_->trylock()) {
-    // FRI related states
-    rt_state_publisher_ptr_->msg_.client_command_mode = static_cast<int8_t>(
-        state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_CLIENT_COMMAND_MODE]);
-    rt_state_publisher_ptr_->msg_.connection_quality =
-        static_cast<int8_t>(state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_CONNECTION_QUALITY]);
-    rt_state_publisher_ptr_->msg_.control_mode =
-        static_cast<int8_t>(state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_CONTROL_MODE]);
-    rt_state_publisher_ptr_->msg_.drive_state =
-        static_cast<int8_t>(state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_DRIVE_STATE]);
-    rt_state_publisher_ptr_->msg_.operation_mode =
-        static_cast<int8_t>(state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_OPERATION_MODE]);
-    rt_state_publisher_ptr_->msg_.overlay_type =
-        static_cast<int8_t>(state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_OVERLAY_TYPE]);
-    rt_state_publisher_ptr_->msg_.safety_state =
-        static_cast<int8_t>(state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_SAFETY_STATE]);
-    rt_state_publisher_ptr_->msg_.sample_time =
-        state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_SAMPLE_TIME];
-    rt_state_publisher_ptr_->msg_.session_state =
-        static_cast<int8_t>(state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_SESSION_STATE]);
-    rt_state_publisher_ptr_->msg_.time_stamp_nano_sec = static_cast<uint32_t>(
-        state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_TIME_STAMP_NANO_SEC]);
-    rt_state_publisher_ptr_->msg_.time_stamp_sec =
-        static_cast<uint32_t>(state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_TIME_STAMP_SEC]);
-    rt_state_publisher_ptr_->msg_.tracking_performance =
-        state_interface_map_[HW_IF_AUXILIARY_PREFIX][HW_IF_TRACKING_PERFORMANCE];
-
-    // joint related states
-    std::for_each(joint_names_.begin(), joint_names_.end(),
-                  [&, idx = 0](const std::string &joint_name) mutable {
-#if FRI_CLIENT_VERSION_MAJOR == 1
-                    rt_state_publisher_ptr_->msg_.commanded_joint_position[idx] =
-                        state_interface_map_[joint_name][HW_IF_COMMANDED_JOINT_POSITION];
-#endif
-                    rt_state_publisher_ptr_->msg_.commanded_torque[idx] =
-                        state_interface_map_[joint_name][HW_IF_COMMANDED_TORQUE];
-                    rt_state_publisher_ptr_->msg_.external_torque[idx] =
-                        state_interface_map_[joint_name][HW_IF_EXTERNAL_TORQUE];
-                    if (rt_state_publisher_ptr_->msg_.session_state == KUKA::FRI::COMMANDING_WAIT ||
-                        rt_state_publisher_ptr_->msg_.session_state ==
-                            KUKA::FRI::COMMANDING_ACTIVE) {
-                      rt_state_publisher_ptr_->msg_.ipo_joint_position[idx] =
-                          state_interface_map_[joint_name][HW_IF_IPO_JOINT_POSITION];
-                    } else {
-                      rt_state_publisher_ptr_->msg_.ipo_joint_position[idx] =
-                          std::numeric_limits<double>::quiet_NaN();
-                    }
-                    rt_state_publisher_ptr_->msg_.measured_joint_position[idx] =
-                        state_interface_map_[joint_name][hardware_interface::HW_IF_POSITION];
-                    rt_state_publisher_ptr_->msg_.measured_torque[idx] =
-                        state_interface_map_[joint_name][hardware_interface::HW_IF_EFFORT];
-                    ++idx;
-                  });
-
+  if (state_.session_state != KUKA::FRI::COMMANDING_WAIT &&
+      state_.session_state != KUKA::FRI::COMMANDING_ACTIVE) {
+    state_.ipo_joint_position.fill(std::numeric_limits<double>::quiet_NaN());
+  }
+  ++sample_count_;
+  if (lossless_) {
+    if (!state_ring_.push(state_)) {
+      ++dropped_samples_;
+    }
+  } else if (loan_state_) {
+    publish_state_(state_);
+  } else if (rt_state_publisher_ptr_->trylock()) {
+    rt_state_publisher_ptr_->msg_ = state_;
     rt_state_publisher_ptr_->unlockAndPublish();
   }
+  for (auto &decimated_publisher : decimated_publishers_) {
+    if (sample_count_ % decimated_publisher.decimation != 0) {
+      continue;
+    }
+    if (decimated_publisher.rt_publisher_ptr->trylock()) {
+      decimated_publisher.rt_publisher_ptr->msg_ = state_;
+      decimated_publisher.rt_publisher_ptr->unlockAndPublish();
+    }
+  }
 
   return controller_interface::return_type::OK;
 }
 
 controller_interface::CallbackReturn
 LBRStateBroadcaster::on_configure(const rclcpp_lifecycle::State & /*previous_state*/) {
+  try {
+    lossless_ = this->get_node()->get_parameter("lossless").as_bool();
+    const auto batch_size = this->get_node()->get_parameter("batch_size").as_int();
+    const auto ring_capacity = this->get_node()->get_parameter("ring_capacity").as_int();
+    if (batch_size < 1 || ring_capacity < batch_size) {
+      RCLCPP_ERROR(this->get_node()->get_logger(),
+                   "Expected 1 <= batch_size (%ld) <= ring_capacity (%ld).", batch_size,
+                   ring_capacity);
+      return controller_interface::CallbackReturn::ERROR;
+    }
+    batch_size_ = static_cast<std::size_t>(batch_size);
+
+    if (lossless_) {
+      // preallocate, the ring holds every sample until the publisher thread catches up
+      state_ring_.reset(static_cast<std::size_t>(ring_capacity));
+      state_publisher_ptr_ = this->get_node()->create_publisher<lbr_fri_idl::msg::LBRState>(
+          "state", rclcpp::QoS(static_cast<std::size_t>(ring_capacity)).reliable());
+    } else {
+      state_ring_.reset(0);
+      state_publisher_ptr_ =
+          this->get_node()->create_publisher<lbr_fri_idl::msg::LBRState>("state", 1);
+    }
+    rt_state_publisher_ptr_.reset();
+    loan_state_ = false;
+    if (this->get_node()->get_parameter("loaned_messages").as_bool()) {
+      // borrow_loaned_message would allocate otherwise
+      loan_state_ = state_publisher_ptr_->can_loan_messages();
+      if (!loan_state_) {
+        RCLCPP_WARN(this->get_node()->get_logger(),
+                    "Middleware cannot loan messages, falling back to copies.");
+      }
+    }
+    if (!loan_state_ && !lossless_) {
+      rt_state_publisher_ptr_ =
+          std::make_shared<realtime_tools::RealtimePublisher<lbr_fri_idl::msg::LBRState>>(
+              state_publisher_ptr_);
+    }
+    if (!init_decimated_publishers_()) {
+      return controller_interface::CallbackReturn::ERROR;
+    }
+  } catch (const std::exception &e) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Failed to configure LBR state broadcaster with: %s.", e.what());
+    return controller_interface::CallbackReturn::ERROR;
+  }
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
 controller_interface::CallbackReturn
 LBRStateBroadcaster::on_activate(const rclcpp_lifecycle::State & /*previous_state*/) {
-  init_state_interface_map_();
   init_state_msg_();
+  init_state_interface_fields_();
+  sample_count_ = 0;
+  dropped_samples_ = 0;
+  if (lossless_) {
+    publishing_ = true;
+    publish_thread_ = std::thread(&LBRStateBroadcaster::publish_loop_, this);
+  }
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
 controller_interface::CallbackReturn
 LBRStateBroadcaster::on_deactivate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  publishing_ = false;
+  if (publish_thread_.joinable()) {
+    publish_thread_.join();
+  }
+  double_fields_.clear();
+  int8_fields_.clear();
+  uint32_fields_.clear();
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
-void LBRStateBroadcaster::init_state_interface_map_() {
+bool LBRStateBroadcaster::init_decimated_publishers_() {
+  const auto topics = this->get_node()->get_parameter("decimated_topics").as_string_array();
+  const auto decimations = this->get_node()->get_parameter("decimations").as_integer_array();
+  if (topics.size() != decimations.size()) {
+    RCLCPP_ERROR(this->get_node()->get_logger(),
+                 "Number of decimated topics (%ld) does not match the number of decimations (%ld).",
+                 topics.size(), decimations.size());
+    return false;
+  }
+  decimated_publishers_.clear();
+  for (std::size_t idx = 0; idx < topics.size(); ++idx) {
+    if (decimations[idx] < 1) {
+      RCLCPP_ERROR(this->get_node()->get_logger(), "Expected decimation >= 1 for %s, got %ld.",
+                   topics[idx].c_str(), decimations[idx]);
+      return false;
+    }
+    DecimatedPublisher decimated_publisher;
+    decimated_publisher.decimation = static_cast<std::uint64_t>(decimations[idx]);
+    decimated_publisher.publisher_ptr =
+        this->get_node()->create_publisher<lbr_fri_idl::msg::LBRState>(topics[idx], 1);
+    decimated_publisher.rt_publisher_ptr =
+        std::make_shared<realtime_tools::RealtimePublisher<lbr_fri_idl::msg::LBRState>>(
+            decimated_publisher.publisher_ptr);
+    decimated_publishers_.push_back(decimated_publisher);
+  }
+  return true;
+}
+
+void LBRStateBroadcaster::publish_loop_() {
+  // wake up once per batch, fall back to the FRI's 1 kHz if the update rate is unknown
+  const double update_rate =
+      this->get_update_rate() > 0 ? static_cast<double>(this->get_update_rate()) : 1000.;
+  const auto batch_period = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(static_cast<double>(batch_size_) / update_rate));
+  std::uint64_t reported_dropped_samples = 0;
+  auto wakeup = std::chrono::steady_clock::now();
+  while (publishing_) {
+    wakeup += batch_period;
+    std::this_thread::sleep_until(wakeup);
+    drain_state_ring_();
+    const std::uint64_t dropped_samples = dropped_samples_;
+    if (dropped_samples != reported_dropped_samples) {
+      RCLCPP_WARN(this->get_node()->get_logger(),
+                  "State ring full, dropped %lu samples in total. Consider increasing "
+                  "ring_capacity.",
+                  dropped_samples);
+      reported_dropped_samples = dropped_samples;
+    }
+  }
+  drain_state_ring_();
+}
+
+void LBRStateBroadcaster::drain_state_ring_() {
+  while (state_ring_.pop(batch_state_)) {
+    publish_state_(batch_state_);
+  }
+}
+
+void LBRStateBroadcaster::publish_state_(const lbr_fri_idl::msg::LBRState &state) {
+  if (!loan_state_) {
+    state_publisher_ptr_->publish(state);
+    return;
+  }
+  auto loaned_state = state_publisher_ptr_->borrow_loaned_message();
+  loaned_state.get() = state;
+  state_publisher_ptr_->publish(std::move(loaned_state));
+}
+
+void LBRStateBroadcaster::init_state_interface_fields_() {
+  double_fields_.clear();
+  int8_fields_.clear();
+  uint32_fields_.clear();
+
+  // FRI related states
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_CLIENT_COMMAND_MODE,
+                              &state_.client_command_mode, int8_fields_);
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_CONNECTION_QUALITY,
+                              &state_.connection_quality, int8_fields_);
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_CONTROL_MODE, &state_.control_mode,
+                              int8_fields_);
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_DRIVE_STATE, &state_.drive_state,
+                              int8_fields_);
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_OPERATION_MODE,
+                              &state_.operation_mode, int8_fields_);
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_OVERLAY_TYPE, &state_.overlay_type,
+                              int8_fields_);
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_SAFETY_STATE, &state_.safety_state,
+                              int8_fields_);
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_SAMPLE_TIME, &state_.sample_time,
+                              double_fields_);
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_SESSION_STATE, &state_.session_state,
+                              int8_fields_);
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_TIME_STAMP_NANO_SEC,
+                              &state_.time_stamp_nano_sec, uint32_fields_);
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_TIME_STAMP_SEC,
+                              &state_.time_stamp_sec, uint32_fields_);
+  bind_state_interface_field_(HW_IF_AUXILIARY_PREFIX, HW_IF_TRACKING_PERFORMANCE,
+                              &state_.tracking_performance, double_fields_);
+
+  // joint related states
+  for (std::size_t idx = 0; idx < joint_names_.size(); ++idx) {
+#if FRI_CLIENT_VERSION_MAJOR == 1
+    bind_state_interface_field_(joint_names_[idx], HW_IF_COMMANDED_JOINT_POSITION,
+                                &state_.commanded_joint_position[idx], double_fields_);
+#endif
+    bind_state_interface_field_(joint_names_[idx], HW_IF_COMMANDED_TORQUE,
+                                &state_.commanded_torque[idx], double_fields_);
+    bind_state_interface_field_(joint_names_[idx], HW_IF_EXTERNAL_TORQUE,
+                                &state_.external_torque[idx], double_fields_);
+    bind_state_interface_field_(joint_names_[idx], HW_IF_IPO_JOINT_POSITION,
+                                &state_.ipo_joint_position[idx], double_fields_);
+    bind_state_interface_field_(joint_names_[idx], hardware_interface::HW_IF_POSITION,
+                                &state_.measured_joint_position[idx], double_fields_);
+    bind_state_interface_field_(joint_names_[idx], hardware_interface::HW_IF_EFFORT,
+                                &state_.measured_torque[idx], double_fields_);
+  }
+}
+
+template <typename T>
+void LBRStateBroadcaster::bind_state_interface_field_(
+    const std::string &prefix_name, const std::string &interface_name, T *field,
+    std::vector<state_interface_field_t<T>> &fields) {
   for (const auto &state_interface : state_interfaces_) {
-    state_interface_map_[state_interface.get_prefix_name()][state_interface.get_interface_name()] =
-        std::numeric_limits<double>::quiet_NaN();
+    if (state_interface.get_prefix_name() == prefix_name &&
+        state_interface.get_interface_name() == interface_name) {
+      fields.emplace_back(&state_interface, field);
+      return;
+    }
   }
 }
 
 void LBRStateBroadcaster::init_state_msg_() {
-  rt_state_publisher_ptr_->msg_.client_command_mode = std::numeric_limits<int8_t>::quiet_NaN();
+  state_.client_command_mode = std::numeric_limits<int8_t>::quiet_NaN();
 #if FRI_CLIENT_VERSION_MAJOR == 1
-  rt_state_publisher_ptr_->msg_.commanded_joint_position.fill(
-      std::numeric_limits<double>::quiet_NaN());
+  state_.commanded_joint_position.fill(std::numeric_limits<double>::quiet_NaN());
 #endif
-  rt_state_publisher_ptr_->msg_.commanded_torque.fill(std::numeric_limits<double>::quiet_NaN());
-  rt_state_publisher_ptr_->msg_.connection_quality = std::numeric_limits<int8_t>::quiet_NaN();
-  rt_state_publisher_ptr_->msg_.control_mode = std::numeric_limits<int8_t>::quiet_NaN();
-  rt_state_publisher_ptr_->msg_.drive_state = std::numeric_limits<int8_t>::quiet_NaN();
-  rt_state_publisher_ptr_->msg_.external_torque.fill(std::numeric_limits<double>::quiet_NaN());
-  rt_state_publisher_ptr_->msg_.ipo_joint_position.fill(std::numeric_limits<double>::quiet_NaN());
-  rt_state_publisher_ptr_->msg_.measured_joint_position.fill(
-      std::numeric_limits<double>::quiet_NaN());
-  rt_state_publisher_ptr_->msg_.measured_torque.fill(std::numeric_limits<double>::quiet_NaN());
-  rt_state_publisher_ptr_->msg_.overlay_type = std::numeric_limits<int8_t>::quiet_NaN();
-  rt_state_publisher_ptr_->msg_.safety_state = std::numeric_limits<int8_t>::quiet_NaN();
-  rt_state_publisher_ptr_->msg_.sample_time = std::numeric_limits<double>::quiet_NaN();
-  rt_state_publisher_ptr_->msg_.session_state = std::numeric_limits<int8_t>::quiet_NaN();
-  rt_state_publisher_ptr_->msg_.time_stamp_nano_sec = std::numeric_limits<uint32_t>::quiet_NaN();
-  rt_state_publisher_ptr_->msg_.time_stamp_sec = std::numeric_limits<uint32_t>::quiet_NaN();
-  rt_state_publisher_ptr_->msg_.tracking_performance = std::numeric_limits<double>::quiet_NaN();
+  state_.commanded_torque.fill(std::numeric_limits<double>::quiet_NaN());
+  state_.connection_quality = std::numeric_limits<int8_t>::quiet_NaN();
+  state_.control_mode = std::numeric_limits<int8_t>::quiet_NaN();
+  state_.drive_state = std::numeric_limits<int8_t>::quiet_NaN();
+  state_.external_torque.fill(std::numeric_limits<double>::quiet_NaN());
+  state_.ipo_joint_position.fill(std::numeric_limits<double>::quiet_NaN());
+  state_.measured_joint_position.fill(std::numeric_limits<double>::quiet_NaN());
+  state_.measured_torque.fill(std::numeric_limits<double>::quiet_NaN());
+  state_.overlay_type = std::numeric_limits<int8_t>::quiet_NaN();
+  state_.safety_state = std::numeric_limits<int8_t>::quiet_NaN();
+  state_.sample_time = std::numeric_limits<double>::quiet_NaN();
+  state_.session_state = std::numeric_limits<int8_t>::quiet_NaN();
+  state_.time_stamp_nano_sec = std::numeric_limits<uint32_t>::quiet_NaN();
+  state_.time_stamp_sec = std::numeric_limits<uint32_t>::quiet_NaN();
+  state_.tracking_performance = std::numeric_limits<double>::quiet_NaN();
 }
 } // namespace lbr_ros2_control
 
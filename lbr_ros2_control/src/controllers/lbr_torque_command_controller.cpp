@@ -2,7 +2,7 @@
 
 namespace lbr_ros2_control {
 LBRTorqueCommandController::LBRTorqueCommandController()
-    : rt_lbr_torque_command_ptr_(nullptr), lbr_torque_command_subscription_ptr_(nullptr) {}
+    : lbr_torque_command_subscription_ptr_(nullptr), last_stamp_ns_(0) {}
 
 controller_interface::InterfaceConfiguration
 LBRTorqueCommandController::command_interface_configuration() const {
@@ -25,9 +25,15 @@ controller_interface::CallbackReturn LBRTorqueCommandController::on_init() {
   try {
     lbr_torque_command_subscription_ptr_ =
         this->get_node()->create_subscription<lbr_fri_idl::msg::LBRTorqueCommand>(
-            "command/torque", 1, [this](const lbr_fri_idl::msg::LBRTorqueCommand::SharedPtr msg) {
-              rt_lbr_torque_command_ptr_.writeFromNonRT(msg);
-            });
+            "command/torque", 1,
+            [this](const lbr_fri_idl::msg::LBRTorqueCommand::SharedPtr msg,
+                   const rclcpp::MessageInfo &message_info) {
+              rt_lbr_torque_command_ptr_.writeFromNonRT(
+                  {*msg, CommandAgeMonitor::stamp(message_info)});
+            },
+            rclcpp::SubscriptionOptions(),
+            std::make_shared<command_message_pool_t<lbr_fri_idl::msg::LBRTorqueCommand>>());
+    command_age_monitor_.declare_parameters(this->get_node());
   } catch (const std::exception &e) {
     RCLCPP_ERROR(this->get_node()->get_logger(),
                  "Failed to initialize LBR torque command controller with: %s.", e.what());
@@ -39,26 +45,40 @@ controller_interface::CallbackReturn LBRTorqueCommandController::on_init() {
 
 controller_interface::return_type
 LBRTorqueCommandController::update(const rclcpp::Time & /*time*/,
-                                   const rclcpp::Duration & /*period*/) {
+                                   const rclcpp::Duration &period) {
   auto lbr_torque_command = rt_lbr_torque_command_ptr_.readFromRT();
-  if (!lbr_torque_command || !(*lbr_torque_command)) {
+  if (!lbr_torque_command || lbr_torque_command->stamp_ns == 0) {
+    return controller_interface::return_type::OK;
+  }
+  const bool is_new = lbr_torque_command->stamp_ns != last_stamp_ns_;
+  last_stamp_ns_ = lbr_torque_command->stamp_ns;
+  if (!command_age_monitor_.is_fresh(lbr_torque_command->stamp_ns, is_new)) {
+    // hold joint positions, hold or decay the overlay
+    const double decay_factor = command_age_monitor_.decay_factor(period.seconds());
+    for (auto &command_interface : torque_command_interfaces_) {
+      command_interface.get().set_value(decay_factor * command_interface.get().get_value());
+    }
     return controller_interface::return_type::OK;
   }
   for (std::size_t idx = 0; idx < KUKA::FRI::LBRState::NUMBER_OF_JOINTS; ++idx) {
     joint_position_command_interfaces_[idx].get().set_value(
-        (*lbr_torque_command)->joint_position[idx]);
-    torque_command_interfaces_[idx].get().set_value((*lbr_torque_command)->torque[idx]);
+        lbr_torque_command->msg.joint_position[idx]);
+    torque_command_interfaces_[idx].get().set_value(lbr_torque_command->msg.torque[idx]);
   }
   return controller_interface::return_type::OK;
 }
 
 controller_interface::CallbackReturn
 LBRTorqueCommandController::on_configure(const rclcpp_lifecycle::State & /*previous_state*/) {
+  if (!command_age_monitor_.configure(this->get_node())) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
 controller_interface::CallbackReturn
 LBRTorqueCommandController::on_activate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  last_stamp_ns_ = 0;
   if (!reference_command_interfaces_()) {
     return controller_interface::CallbackReturn::ERROR;
   }
@@ -2,7 +2,7 @@
 
 namespace lbr_ros2_control {
 LBRWrenchCommandController::LBRWrenchCommandController()
-    : rt_lbr_wrench_command_ptr_(nullptr), lbr_wrench_command_subscription_ptr_(nullptr) {}
+    : lbr_wrench_command_subscription_ptr_(nullptr), last_stamp_ns_(0) {}
 
 controller_interface::InterfaceConfiguration
 LBRWrenchCommandController::command_interface_configuration() const {
@@ -30,9 +30,15 @@ controller_interface::CallbackReturn LBRWrenchCommandController::on_init() {
   try {
     lbr_wrench_command_subscription_ptr_ =
         this->get_node()->create_subscription<lbr_fri_idl::msg::LBRWrenchCommand>(
-            "command/wrench", 1, [this](const lbr_fri_idl::msg::LBRWrenchCommand::SharedPtr msg) {
-              rt_lbr_wrench_command_ptr_.writeFromNonRT(msg);
-            });
+            "command/wrench", 1,
+            [this](const lbr_fri_idl::msg::LBRWrenchCommand::SharedPtr msg,
+                   const rclcpp::MessageInfo &message_info) {
+              rt_lbr_wrench_command_ptr_.writeFromNonRT(
+                  {*msg, CommandAgeMonitor::stamp(message_info)});
+            },
+            rclcpp::SubscriptionOptions(),
+            std::make_shared<command_message_pool_t<lbr_fri_idl::msg::LBRWrenchCommand>>());
+    command_age_monitor_.declare_parameters(this->get_node());
   } catch (const std::exception &e) {
     RCLCPP_ERROR(this->get_node()->get_logger(),
                  "Failed to initialize LBR wrench command controller with: %s.", e.what());
@@ -44,28 +50,42 @@ controller_interface::CallbackReturn LBRWrenchCommandController::on_init() {
 
 controller_interface::return_type
 LBRWrenchCommandController::update(const rclcpp::Time & /*time*/,
-                                   const rclcpp::Duration & /*period*/) {
+                                   const rclcpp::Duration &period) {
   auto lbr_wrench_command = rt_lbr_wrench_command_ptr_.readFromRT();
-  if (!lbr_wrench_command || !(*lbr_wrench_command)) {
+  if (!lbr_wrench_command || lbr_wrench_command->stamp_ns == 0) {
+    return controller_interface::return_type::OK;
+  }
+  const bool is_new = lbr_wrench_command->stamp_ns != last_stamp_ns_;
+  last_stamp_ns_ = lbr_wrench_command->stamp_ns;
+  if (!command_age_monitor_.is_fresh(lbr_wrench_command->stamp_ns, is_new)) {
+    // hold joint positions, hold or decay the overlay
+    const double decay_factor = command_age_monitor_.decay_factor(period.seconds());
+    for (auto &command_interface : wrench_command_interfaces_) {
+      command_interface.get().set_value(decay_factor * command_interface.get().get_value());
+    }
     return controller_interface::return_type::OK;
   }
   for (std::size_t idx = 0; idx < KUKA::FRI::LBRState::NUMBER_OF_JOINTS; ++idx) {
     joint_position_command_interfaces_[idx].get().set_value(
-        (*lbr_wrench_command)->joint_position[idx]);
+        lbr_wrench_command->msg.joint_position[idx]);
   }
   for (std::size_t idx = 0; idx < CARTESIAN_DOF; ++idx) {
-    wrench_command_interfaces_[idx].get().set_value((*lbr_wrench_command)->wrench[idx]);
+    wrench_command_interfaces_[idx].get().set_value(lbr_wrench_command->msg.wrench[idx]);
   }
   return controller_interface::return_type::OK;
 }
 
 controller_interface::CallbackReturn
 LBRWrenchCommandController::on_configure(const rclcpp_lifecycle::State & /*previous_state*/) {
+  if (!command_age_monitor_.configure(this->get_node())) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
 controller_interface::CallbackReturn
 LBRWrenchCommandController::on_activate(const rclcpp_lifecycle::State & /*previous_state*/) {
+  last_stamp_ns_ = 0;
   if (!reference_command_interfaces_()) {
     return controller_interface::CallbackReturn::ERROR;
   }
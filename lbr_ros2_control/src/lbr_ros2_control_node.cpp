@@ -0,0 +1,102 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "controller_manager/controller_manager.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "realtime_tools/thread_priority.hpp"
+
+#include "lbr_fri_ros2/cycle_sync.hpp"
+#include "lbr_fri_ros2/formatting.hpp"
+
+// Drop-in replacement for the controller_manager's ros2_control_node. If the
+// lbr_ros2_control::SystemInterface enables cycle_sync, each received FRI state triggers read,
+// update and write, and the command goes into the reply of the same FRI cycle. The loop falls
+// back to update_rate otherwise, e.g. before the robot connects. While synchronized, the period
+// follows the state time stamps. The time is the ROS time, unless the states come from a
+// free-running emulation, whose emulated clock may run faster than the wall clock.
+int main(int argc, char **argv) {
+  rclcpp::init(argc, argv);
+
+  std::shared_ptr<rclcpp::Executor> executor =
+      std::make_shared<rclcpp::executors::MultiThreadedExecutor>();
+  auto controller_manager =
+      std::make_shared<controller_manager::ControllerManager>(executor, "controller_manager");
+  const auto logger = controller_manager->get_logger();
+  const int rt_prio = controller_manager->declare_parameter<int>("rt_prio", 50);
+
+  std::thread update_thread([controller_manager, logger, rt_prio]() {
+    if (realtime_tools::has_realtime_kernel()) {
+      if (!realtime_tools::configure_sched_fifo(rt_prio)) {
+        RCLCPP_WARN_STREAM(logger, lbr_fri_ros2::ColorScheme::WARNING
+                                       << "Failed to set FIFO realtime scheduling policy"
+                                       << lbr_fri_ros2::ColorScheme::ENDC);
+      }
+    } else {
+      RCLCPP_INFO(logger, "Realtime kernel recommended but not required");
+    }
+
+    auto &cycle_sync = lbr_fri_ros2::CycleSync::instance();
+    const std::chrono::nanoseconds period(1000000000 / controller_manager->get_update_rate());
+    auto next_iteration_time = std::chrono::steady_clock::now() + period;
+    auto previous_wall_time = std::chrono::steady_clock::now();
+    std::chrono::nanoseconds previous_stamp(0);
+    rclcpp::Time emulated_time;
+    bool synced = false, emulated = false;
+    while (rclcpp::ok()) {
+      // a new FRI state if synchronization is enabled, or the free-running period elapsed
+      bool state = false;
+      if (cycle_sync.is_enabled()) {
+        state = cycle_sync.wait_for_state_until(next_iteration_time);
+      } else {
+        std::this_thread::sleep_until(next_iteration_time);
+      }
+      const auto wall_time = std::chrono::steady_clock::now();
+      std::chrono::nanoseconds measured_period = wall_time - previous_wall_time;
+      previous_wall_time = wall_time;
+      if (state) {
+        const std::chrono::nanoseconds stamp = cycle_sync.get_state_stamp();
+        if (synced && stamp > previous_stamp) {
+          measured_period = stamp - previous_stamp;
+        }
+        previous_stamp = stamp;
+      }
+      if (state != synced) {
+        RCLCPP_INFO_STREAM(logger, (state ? "Update loop synchronized to FRI cycle"
+                                          : "Update loop running at update_rate"));
+        synced = state;
+      }
+
+      // the ROS time, so that controllers may compare it against message stamps. An emulated
+      // clock starts at the ROS time and advances by the periods only
+      rclcpp::Time current_time = controller_manager->now();
+      if (cycle_sync.is_clock_emulated()) {
+        emulated_time = emulated ? emulated_time + rclcpp::Duration(measured_period) : current_time;
+        current_time = emulated_time;
+      }
+      emulated = cycle_sync.is_clock_emulated();
+
+      controller_manager->read(current_time, rclcpp::Duration(measured_period));
+      controller_manager->update(current_time, rclcpp::Duration(measured_period));
+      controller_manager->write(current_time, rclcpp::Duration(measured_period));
+      if (synced) {
+        cycle_sync.notify_command();
+      }
+
+      if (synced) {
+        // fall back to update_rate only once FRI states stop, tolerating jitter
+        next_iteration_time = wall_time + period + period / 2;
+      } else {
+        // free-running fallback, the period does not stretch by the execution time
+        next_iteration_time += period;
+      }
+    }
+  });
+
+  executor->add_node(controller_manager);
+  executor->spin();
+  update_thread.join();
+  rclcpp::shutdown();
+  return 0;
+}
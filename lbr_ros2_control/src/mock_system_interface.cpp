@@ -0,0 +1,285 @@
+#include "lbr_ros2_control/mock_system_interface.hpp"
+
+namespace lbr_ros2_control {
+MockSystemInterface::~MockSystemInterface() {
+  running_ = false;
+  if (run_thread_.joinable()) {
+    run_thread_.join();
+  }
+}
+
+controller_interface::CallbackReturn
+MockSystemInterface::on_init(const hardware_interface::HardwareInfo &system_info) {
+  auto ret = SystemInterface::on_init(system_info);
+  if (ret != controller_interface::CallbackReturn::SUCCESS) {
+    return ret;
+  }
+  if (!parse_mock_parameters_()) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  RCLCPP_INFO_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                     lbr_fri_ros2::ColorScheme::OKBLUE
+                         << "Emulating FRI with sample time " << mock_parameters_.sample_time
+                         << " s" << (mock_parameters_.free_running ? ", free running" : "")
+                         << lbr_fri_ros2::ColorScheme::ENDC);
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn
+MockSystemInterface::on_activate(const rclcpp_lifecycle::State &) {
+  if (running_) {
+    return controller_interface::CallbackReturn::SUCCESS;
+  }
+
+  reset_();
+
+  running_ = true;
+  run_thread_ = std::thread(&MockSystemInterface::run_, this);
+  RCLCPP_INFO_STREAM(rclcpp::get_logger(LOGGER_NAME), lbr_fri_ros2::ColorScheme::OKGREEN
+                                                          << "Emulated robot connected"
+                                                          << lbr_fri_ros2::ColorScheme::ENDC);
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+controller_interface::CallbackReturn
+MockSystemInterface::on_deactivate(const rclcpp_lifecycle::State &) {
+  running_ = false;
+  if (run_thread_.joinable()) {
+    run_thread_.join();
+  }
+  state_initialized_flag_ = false;
+  if (ft_parameters_.calibrate_torque_bias) {
+    save_torque_bias_map_();
+  }
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+bool MockSystemInterface::parse_mock_parameters_() {
+  try {
+    mock_parameters_.sample_time = std::stod(info_.hardware_parameters.at("mock_sample_time"));
+    mock_parameters_.session_transition_cycles =
+        std::stoul(info_.hardware_parameters.at("mock_session_transition_cycles"));
+    mock_parameters_.ipo_lag_cycles =
+        std::stoul(info_.hardware_parameters.at("mock_ipo_lag_cycles"));
+    std::string free_running = info_.hardware_parameters.at("mock_free_running");
+    std::transform(free_running.begin(), free_running.end(), free_running.begin(), ::tolower);
+    mock_parameters_.free_running = free_running == "true";
+  } catch (const std::out_of_range &e) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                        lbr_fri_ros2::ColorScheme::ERROR
+                            << "Failed to parse mock parameters with: " << e.what()
+                            << lbr_fri_ros2::ColorScheme::ENDC);
+    return false;
+  }
+  if (mock_parameters_.sample_time <= 0. || mock_parameters_.session_transition_cycles == 0) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                        lbr_fri_ros2::ColorScheme::ERROR
+                            << "Expected positive mock_sample_time and "
+                               "mock_session_transition_cycles"
+                            << lbr_fri_ros2::ColorScheme::ENDC);
+    return false;
+  }
+  if (!parse_joint_array_("mock_initial_joint_position",
+                          mock_parameters_.initial_joint_position)) {
+    return false;
+  }
+  if (!parse_joint_array_("mock_external_torque", mock_parameters_.external_torque)) {
+    return false;
+  }
+  return true;
+}
+
+bool MockSystemInterface::parse_joint_array_(
+    const std::string &name,
+    std::array<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS> &joint_array) {
+  if (info_.hardware_parameters.find(name) == info_.hardware_parameters.end()) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME), lbr_fri_ros2::ColorScheme::ERROR
+                                                             << "Missing parameter '" << name
+                                                             << "'"
+                                                             << lbr_fri_ros2::ColorScheme::ENDC);
+    return false;
+  }
+  std::string values = info_.hardware_parameters.at(name);
+  std::replace_if(
+      values.begin(), values.end(), [](const char &c) { return c == '[' || c == ']' || c == ','; },
+      ' ');
+  std::istringstream values_stream(values);
+  std::size_t count = 0;
+  double value;
+  while (values_stream >> value) {
+    if (count < joint_array.size()) {
+      joint_array[count] = value;
+    }
+    ++count;
+  }
+  if (count != joint_array.size()) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                        lbr_fri_ros2::ColorScheme::ERROR
+                            << "Expected " << joint_array.size() << " values for '" << name
+                            << "', got " << count << lbr_fri_ros2::ColorScheme::ENDC);
+    return false;
+  }
+  return true;
+}
+
+bool MockSystemInterface::state_initialized_() { return state_initialized_flag_; }
+
+const lbr_fri_ros2::StateBlock &MockSystemInterface::get_state_block_() {
+  state_blocks_.acquire();
+  return state_blocks_.front();
+}
+
+void MockSystemInterface::buffer_command_target_(const lbr_fri_idl::msg::LBRCommand &command) {
+  commands_.back() = command;
+  commands_.publish();
+}
+
+bool MockSystemInterface::get_client_command_mode_(
+    KUKA::FRI::EClientCommandMode &client_command_mode) const {
+  // the emulated robot runs in the configured mode
+  if (!state_initialized_flag_) {
+    return false;
+  }
+  client_command_mode = parameters_.client_command_mode;
+  return true;
+}
+
+void MockSystemInterface::reset_() {
+  // the robot starts at rest, the emulated time continues across activations
+  session_state_ = KUKA::FRI::ESessionState::IDLE;
+  std::copy(mock_parameters_.initial_joint_position.begin(),
+            mock_parameters_.initial_joint_position.end(),
+            state_.measured_joint_position.begin());
+#if FRI_CLIENT_VERSION_MAJOR == 1
+  state_.commanded_joint_position = state_.measured_joint_position;
+#endif
+  state_.ipo_joint_position = state_.measured_joint_position;
+  state_.commanded_torque.fill(0.);
+  state_.measured_torque.fill(0.);
+  state_.external_torque.fill(0.);
+  state_.sample_time = mock_parameters_.sample_time;
+  state_.tracking_performance = 1.;
+  ipo_lag_.assign(mock_parameters_.ipo_lag_cycles + 1, state_.measured_joint_position);
+  command_.joint_position.fill(std::numeric_limits<double>::quiet_NaN());
+  command_.torque.fill(std::numeric_limits<double>::quiet_NaN());
+  command_.wrench.fill(std::numeric_limits<double>::quiet_NaN());
+  reset_joints_();
+}
+
+void MockSystemInterface::run_() {
+  auto &cycle_sync = lbr_fri_ros2::CycleSync::instance();
+  const bool sync = mock_parameters_.free_running || parameters_.cycle_sync;
+  const std::chrono::nanoseconds sample_time(
+      static_cast<int64_t>(mock_parameters_.sample_time * 1.e9));
+  cycle_sync.enable(sync, mock_parameters_.free_running);
+  auto next_cycle_time = std::chrono::steady_clock::now();
+  while (running_ && rclcpp::ok()) {
+    step_();
+    publish_state_block_();
+    if (sync) {
+      cycle_sync.notify_state(std::chrono::seconds(state_.time_stamp_sec) +
+                              std::chrono::nanoseconds(state_.time_stamp_nano_sec));
+      if (mock_parameters_.free_running) {
+        // lockstep, a full sample time before the emulation proceeds on its own
+        cycle_sync.wait_for_command(sample_time);
+      } else if (session_state_ == KUKA::FRI::ESessionState::COMMANDING_ACTIVE) {
+        cycle_sync.wait_for_command(sample_time / 2);
+      }
+    }
+    if (!mock_parameters_.free_running) {
+      next_cycle_time += sample_time;
+      std::this_thread::sleep_until(next_cycle_time);
+    }
+  }
+  cycle_sync.enable(false);
+}
+
+void MockSystemInterface::step_() {
+  ++cycle_;
+
+  // session state transitions, the robot is assumed to start commanding right away
+  if (session_state_ < KUKA::FRI::ESessionState::COMMANDING_ACTIVE &&
+      cycle_ % mock_parameters_.session_transition_cycles == 0) {
+    session_state_ = static_cast<KUKA::FRI::ESessionState>(session_state_ + 1);
+  }
+
+  // latest command, only applied while commanding
+  if (commands_.acquire()) {
+    command_ = commands_.front();
+  }
+  auto &target = ipo_lag_[cycle_ % ipo_lag_.size()];
+  target = ipo_lag_[(cycle_ + ipo_lag_.size() - 1) % ipo_lag_.size()]; // hold previous target
+  if (session_state_ == KUKA::FRI::ESessionState::COMMANDING_ACTIVE) {
+    for (std::size_t i = 0; i < target.size(); ++i) {
+      if (!std::isnan(command_.joint_position[i])) {
+        target[i] = command_.joint_position[i];
+      }
+    }
+  }
+#if FRI_CLIENT_VERSION_MAJOR == 1
+  state_.commanded_joint_position = target;
+#endif
+
+  // the IPO joint position lags the command
+  state_.ipo_joint_position = ipo_lag_[(cycle_ + 1) % ipo_lag_.size()];
+  for (std::size_t i = 0; i < state_.commanded_torque.size(); ++i) {
+    state_.commanded_torque[i] =
+        session_state_ == KUKA::FRI::ESessionState::COMMANDING_ACTIVE &&
+                parameters_.client_command_mode == KUKA::FRI::EClientCommandMode::TORQUE &&
+                !std::isnan(command_.torque[i])
+            ? command_.torque[i]
+            : 0.;
+    state_.external_torque[i] = mock_parameters_.external_torque[i];
+  }
+  emulate_joints_();
+
+  // remaining state
+  state_.session_state = session_state_;
+  state_.connection_quality = KUKA::FRI::EConnectionQuality::EXCELLENT;
+  state_.safety_state = KUKA::FRI::ESafetyState::NORMAL_OPERATION;
+  state_.operation_mode = KUKA::FRI::EOperationMode::TEST_MODE_1;
+  state_.drive_state = KUKA::FRI::EDriveState::ACTIVE;
+  state_.client_command_mode = parameters_.client_command_mode;
+  switch (parameters_.client_command_mode) {
+  case KUKA::FRI::EClientCommandMode::TORQUE:
+    state_.overlay_type = KUKA::FRI::EOverlayType::JOINT;
+    state_.control_mode = KUKA::FRI::EControlMode::JOINT_IMP_CONTROL_MODE;
+    break;
+  case KUKA::FRI::EClientCommandMode::WRENCH:
+    state_.overlay_type = KUKA::FRI::EOverlayType::CARTESIAN;
+    state_.control_mode = KUKA::FRI::EControlMode::CART_IMP_CONTROL_MODE;
+    break;
+  default:
+    state_.overlay_type = KUKA::FRI::EOverlayType::JOINT;
+    state_.control_mode = KUKA::FRI::EControlMode::POSITION_CONTROL_MODE;
+    break;
+  }
+
+  // emulated time, independent of the wall clock
+  const uint64_t time_stamp_nano_sec =
+      static_cast<uint64_t>(std::llround(cycle_ * mock_parameters_.sample_time * 1.e9));
+  state_.time_stamp_sec = time_stamp_nano_sec / 1000000000;
+  state_.time_stamp_nano_sec = time_stamp_nano_sec % 1000000000;
+}
+
+void MockSystemInterface::reset_joints_() {}
+
+void MockSystemInterface::emulate_joints_() {
+  // the measured joint position tracks the IPO joint position perfectly, gravity compensated, the
+  // measured torque is the commanded (model) plus the injected external torque
+  state_.measured_joint_position = state_.ipo_joint_position;
+  for (std::size_t i = 0; i < state_.measured_torque.size(); ++i) {
+    state_.measured_torque[i] = state_.commanded_torque[i] + state_.external_torque[i];
+  }
+}
+
+void MockSystemInterface::publish_state_block_() {
+  state_blocks_.back().assign(state_, cycle_);
+  state_blocks_.publish();
+  state_initialized_flag_ = true;
+}
+} // namespace lbr_ros2_control
+
+#include <pluginlib/class_list_macros.hpp>
+
+PLUGINLIB_EXPORT_CLASS(lbr_ros2_control::MockSystemInterface, hardware_interface::SystemInterface)
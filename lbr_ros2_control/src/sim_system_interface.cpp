@@ -0,0 +1,111 @@
+#include "lbr_ros2_control/sim_system_interface.hpp"
+
+namespace lbr_ros2_control {
+SimSystemInterface::~SimSystemInterface() {
+  // stop the emulation before the simulator is destroyed
+  running_ = false;
+  if (run_thread_.joinable()) {
+    run_thread_.join();
+  }
+}
+
+controller_interface::CallbackReturn
+SimSystemInterface::on_init(const hardware_interface::HardwareInfo &system_info) {
+  auto ret = MockSystemInterface::on_init(system_info);
+  if (ret != controller_interface::CallbackReturn::SUCCESS) {
+    return ret;
+  }
+  lbr_fri_ros2::DynamicsSimulatorParameters sim_parameters;
+  if (!parse_sim_parameters_(sim_parameters)) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  try {
+    // own copy of the chain, the simulator runs in the emulation thread
+    simulator_ptr_ = std::make_unique<lbr_fri_ros2::DynamicsSimulator>(
+        kinematics_cache_ptr_->get_chain(), sim_parameters);
+  } catch (const std::exception &e) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                        lbr_fri_ros2::ColorScheme::ERROR
+                            << "Failed to setup dynamics simulator with: " << e.what()
+                            << lbr_fri_ros2::ColorScheme::ENDC);
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  RCLCPP_INFO_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                     lbr_fri_ros2::ColorScheme::OKBLUE
+                         << "Simulating dynamics from '" << ft_parameters_.chain_root << "' to '"
+                         << ft_parameters_.chain_tip << "' with time step "
+                         << sim_parameters.time_step << " s" << lbr_fri_ros2::ColorScheme::ENDC);
+  return controller_interface::CallbackReturn::SUCCESS;
+}
+
+bool SimSystemInterface::parse_sim_parameters_(
+    lbr_fri_ros2::DynamicsSimulatorParameters &sim_parameters) {
+  try {
+    sim_parameters.time_step = std::stod(info_.hardware_parameters.at("sim_time_step"));
+    for (std::size_t idx = 0; idx < info_.joints.size() && idx < sim_parameters.min_position.size();
+         ++idx) {
+      sim_parameters.min_position[idx] = std::stod(info_.joints[idx].parameters.at("min_position"));
+      sim_parameters.max_position[idx] = std::stod(info_.joints[idx].parameters.at("max_position"));
+    }
+  } catch (const std::out_of_range &e) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                        lbr_fri_ros2::ColorScheme::ERROR
+                            << "Failed to parse sim parameters with: " << e.what()
+                            << lbr_fri_ros2::ColorScheme::ENDC);
+    return false;
+  }
+  if (sim_parameters.time_step <= 0.) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME), lbr_fri_ros2::ColorScheme::ERROR
+                                                             << "Expected positive sim_time_step"
+                                                             << lbr_fri_ros2::ColorScheme::ENDC);
+    return false;
+  }
+  if (!parse_joint_array_("sim_stiffness", sim_parameters.stiffness) ||
+      !parse_joint_array_("sim_damping", sim_parameters.damping) ||
+      !parse_joint_array_("sim_friction", sim_parameters.friction)) {
+    return false;
+  }
+  for (std::size_t i = 0; i < sim_parameters.stiffness.size(); ++i) {
+    if (sim_parameters.stiffness[i] < 0. || sim_parameters.damping[i] < 0. ||
+        sim_parameters.friction[i] < 0.) {
+      RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                          lbr_fri_ros2::ColorScheme::ERROR
+                              << "Expected non-negative sim_stiffness, sim_damping and sim_friction"
+                              << lbr_fri_ros2::ColorScheme::ENDC);
+      return false;
+    }
+  }
+  return true;
+}
+
+void SimSystemInterface::reset_joints_() {
+  simulator_ptr_->reset(state_.measured_joint_position);
+  state_.measured_torque = simulator_ptr_->get_measured_torque();
+  state_.external_torque = simulator_ptr_->get_external_torque();
+}
+
+void SimSystemInterface::emulate_joints_() {
+  wrench_overlay_.fill(0.);
+  if (session_state_ == KUKA::FRI::ESessionState::COMMANDING_ACTIVE &&
+      parameters_.client_command_mode == KUKA::FRI::EClientCommandMode::WRENCH) {
+    for (std::size_t i = 0; i < wrench_overlay_.size(); ++i) {
+      wrench_overlay_[i] = std::isnan(command_.wrench[i]) ? 0. : command_.wrench[i];
+    }
+  }
+
+  // the injected external torque is reported as by the FRI, i.e. measured minus model torque,
+  // hence the opposing torque acts on the robot
+  for (std::size_t i = 0; i < acting_torque_.size(); ++i) {
+    acting_torque_[i] = -state_.external_torque[i];
+  }
+  simulator_ptr_->step(mock_parameters_.sample_time, state_.ipo_joint_position,
+                       state_.commanded_torque, wrench_overlay_, acting_torque_);
+  state_.measured_joint_position = simulator_ptr_->get_joint_position();
+  state_.measured_torque = simulator_ptr_->get_measured_torque();
+  state_.external_torque = simulator_ptr_->get_external_torque();
+}
+} // namespace lbr_ros2_control
+
+#include <pluginlib/class_list_macros.hpp>
+
+PLUGINLIB_EXPORT_CLASS(lbr_ros2_control::SimSystemInterface, hardware_interface::SystemInterface)
@@ -45,7 +45,8 @@ SystemInterface::on_init(const hardware_interface::HardwareInfo &system_info) {
   try {
     async_client_ptr_ = std::make_shared<lbr_fri_ros2::AsyncClient>(
         parameters_.client_command_mode, pid_parameters, command_guard_parameters,
-        parameters_.command_guard_variant, state_interface_parameters, parameters_.open_loop);
+        parameters_.command_guard_variant, state_interface_parameters, parameters_.open_loop,
+        parameters_.cycle_sync);
     app_ptr_ = std::make_unique<lbr_fri_ros2::App>(async_client_ptr_);
   } catch (const std::exception &e) {
     RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
@@ -69,8 +70,56 @@ SystemInterface::on_init(const hardware_interface::HardwareInfo &system_info) {
   ft_parameters_.torque_x_th = std::stod(info_.sensors[1].parameters.at("torque_x_th"));
   ft_parameters_.torque_y_th = std::stod(info_.sensors[1].parameters.at("torque_y_th"));
   ft_parameters_.torque_z_th = std::stod(info_.sensors[1].parameters.at("torque_z_th"));
+  std::string enabled = info_.sensors[1].parameters.at("enabled");
+  std::transform(enabled.begin(), enabled.end(), enabled.begin(), ::tolower);
+  ft_parameters_.enabled = enabled == "true";
+  ft_parameters_.decimation = std::stoul(info_.sensors[1].parameters.at("decimation"));
+  if (ft_parameters_.decimation == 0) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                        lbr_fri_ros2::ColorScheme::ERROR
+                            << "Expected decimation of at least 1 for estimated force-torque."
+                            << lbr_fri_ros2::ColorScheme::ENDC);
+    return controller_interface::CallbackReturn::ERROR;
+  }
+  std::string identify_payload = info_.sensors[1].parameters.at("identify_payload");
+  std::transform(identify_payload.begin(), identify_payload.end(), identify_payload.begin(),
+                 ::tolower);
+  ft_parameters_.identify_payload = identify_payload == "true";
+  ft_parameters_.payload_identification_samples =
+      std::stoul(info_.sensors[1].parameters.at("payload_identification_samples"));
+  ft_parameters_.payload_file = info_.sensors[1].parameters.at("payload_file");
+  std::string calibrate_torque_bias = info_.sensors[1].parameters.at("calibrate_torque_bias");
+  std::transform(calibrate_torque_bias.begin(), calibrate_torque_bias.end(),
+                 calibrate_torque_bias.begin(), ::tolower);
+  ft_parameters_.calibrate_torque_bias = calibrate_torque_bias == "true";
+  ft_parameters_.torque_bias_map_file = info_.sensors[1].parameters.at("torque_bias_map_file");
+  std::string torque_bias_joints = info_.sensors[1].parameters.at("torque_bias_joints");
+  std::replace_if(
+      torque_bias_joints.begin(), torque_bias_joints.end(),
+      [](const char &c) { return c == '[' || c == ']' || c == ','; }, ' ');
+  std::istringstream torque_bias_joints_stream(torque_bias_joints);
+  ft_parameters_.torque_bias_joints.clear();
+  uint32_t torque_bias_joint;
+  while (torque_bias_joints_stream >> torque_bias_joint) {
+    ft_parameters_.torque_bias_joints.push_back(torque_bias_joint);
+  }
+  ft_parameters_.torque_bias_resolution =
+      std::stod(info_.sensors[1].parameters.at("torque_bias_resolution"));
+  if (!ft_parameters_.enabled) {
+    RCLCPP_INFO(rclcpp::get_logger(LOGGER_NAME),
+                "Force-torque estimation disabled. Estimated force-torque state interfaces will "
+                "report NaN.");
+  }
+  // setup kinematics state interfaces, computed for the same chain
+  std::string kinematics_enabled = info_.sensors[2].parameters.at("enabled");
+  std::transform(kinematics_enabled.begin(), kinematics_enabled.end(), kinematics_enabled.begin(),
+                 ::tolower);
+  kinematics_enabled_ = kinematics_enabled == "true";
+
+  kinematics_cache_ptr_ = std::make_shared<lbr_fri_ros2::KinematicsCache>(
+      info_.original_xml, ft_parameters_.chain_root, ft_parameters_.chain_tip);
   ft_estimator_ptr_ = std::make_unique<lbr_fri_ros2::FTEstimator>(
-      info_.original_xml, ft_parameters_.chain_root, ft_parameters_.chain_tip,
+      kinematics_cache_ptr_,
       lbr_fri_ros2::FTEstimator::cart_array_t{
           ft_parameters_.force_x_th,
           ft_parameters_.force_y_th,
@@ -80,6 +129,40 @@ SystemInterface::on_init(const hardware_interface::HardwareInfo &system_info) {
           ft_parameters_.torque_z_th,
       });
 
+  if (!setup_ft_frames_()) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  if (!setup_torque_bias_map_()) {
+    return controller_interface::CallbackReturn::ERROR;
+  }
+
+  // setup payload compensation, either identified at startup or loaded from file
+  if (ft_parameters_.identify_payload) {
+    payload_identifier_ptr_ =
+        std::make_unique<lbr_fri_ros2::PayloadIdentifier>(kinematics_cache_ptr_);
+    payload_identification_poses_ = 0;
+    payload_sequence_valid_ = false;
+    RCLCPP_INFO(rclcpp::get_logger(LOGGER_NAME),
+                "Identifying payload from %u standstill samples. Keep the robot at rest in at "
+                "least two differently oriented poses.",
+                ft_parameters_.payload_identification_samples);
+  } else if (ft_parameters_.payload_file != "none") {
+    lbr_fri_ros2::Payload payload;
+    if (!lbr_fri_ros2::PayloadIdentifier::load(ft_parameters_.payload_file, payload)) {
+      RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                          lbr_fri_ros2::ColorScheme::ERROR
+                              << "Failed to load payload from '" << ft_parameters_.payload_file
+                              << "'" << lbr_fri_ros2::ColorScheme::ENDC);
+      return controller_interface::CallbackReturn::ERROR;
+    }
+    ft_estimator_ptr_->set_payload(payload);
+    RCLCPP_INFO(rclcpp::get_logger(LOGGER_NAME),
+                "Loaded payload with mass %.3f kg and center of mass [%.3f, %.3f, %.3f] m.",
+                payload.mass, payload.center_of_mass[0], payload.center_of_mass[1],
+                payload.center_of_mass[2]);
+  }
+
   if (!verify_number_of_joints_()) {
     return controller_interface::CallbackReturn::ERROR;
   }
@@ -108,24 +191,24 @@ std::vector<hardware_interface::StateInterface> SystemInterface::export_state_in
   // state interfaces of type double
   for (std::size_t i = 0; i < info_.joints.size(); ++i) {
     state_interfaces.emplace_back(info_.joints[i].name, hardware_interface::HW_IF_POSITION,
-                                  &hw_lbr_state_.measured_joint_position[i]);
+                                  &hw_state_.state.measured_joint_position[i]);
 
 #if FRI_CLIENT_VERSION_MAJOR == 1
     state_interfaces.emplace_back(info_.joints[i].name, HW_IF_COMMANDED_JOINT_POSITION,
-                                  &hw_lbr_state_.commanded_joint_position[i]);
+                                  &hw_state_.state.commanded_joint_position[i]);
 #endif
 
     state_interfaces.emplace_back(info_.joints[i].name, hardware_interface::HW_IF_EFFORT,
-                                  &hw_lbr_state_.measured_torque[i]);
+                                  &hw_state_.state.measured_torque[i]);
 
     state_interfaces.emplace_back(info_.joints[i].name, HW_IF_COMMANDED_TORQUE,
-                                  &hw_lbr_state_.commanded_torque[i]);
+                                  &hw_state_.state.commanded_torque[i]);
 
     state_interfaces.emplace_back(info_.joints[i].name, HW_IF_EXTERNAL_TORQUE,
-                                  &hw_lbr_state_.external_torque[i]);
+                                  &hw_state_.state.external_torque[i]);
 
     state_interfaces.emplace_back(info_.joints[i].name, HW_IF_IPO_JOINT_POSITION,
-                                  &hw_lbr_state_.ipo_joint_position[i]);
+                                  &hw_state_.state.ipo_joint_position[i]);
 
     // additional velocity state interface
     state_interfaces.emplace_back(info_.joints[i].name, hardware_interface::HW_IF_VELOCITY,
@@ -134,25 +217,31 @@ std::vector<hardware_interface::StateInterface> SystemInterface::export_state_in
 
   const auto &auxiliary_sensor = info_.sensors[0];
   state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_SAMPLE_TIME,
-                                &hw_lbr_state_.sample_time);
+                                &hw_state_.state.sample_time);
   state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_TRACKING_PERFORMANCE,
-                                &hw_lbr_state_.tracking_performance);
+                                &hw_state_.state.tracking_performance);
 
-  // state interfaces that require cast
-  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_SESSION_STATE, &hw_session_state_);
+  // state interfaces cast on the FRI side
+  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_SESSION_STATE,
+                                &hw_state_.session_state);
   state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_CONNECTION_QUALITY,
-                                &hw_connection_quality_);
-  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_SAFETY_STATE, &hw_safety_state_);
-  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_OPERATION_MODE, &hw_operation_mode_);
-  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_DRIVE_STATE, &hw_drive_state_);
+                                &hw_state_.connection_quality);
+  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_SAFETY_STATE,
+                                &hw_state_.safety_state);
+  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_OPERATION_MODE,
+                                &hw_state_.operation_mode);
+  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_DRIVE_STATE, &hw_state_.drive_state);
   state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_CLIENT_COMMAND_MODE,
-                                &hw_client_command_mode_);
-  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_OVERLAY_TYPE, &hw_overlay_type_);
-  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_CONTROL_MODE, &hw_control_mode_);
+                                &hw_state_.client_command_mode);
+  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_OVERLAY_TYPE,
+                                &hw_state_.overlay_type);
+  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_CONTROL_MODE,
+                                &hw_state_.control_mode);
 
-  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_TIME_STAMP_SEC, &hw_time_stamp_sec_);
+  state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_TIME_STAMP_SEC,
+                                &hw_state_.time_stamp_sec);
   state_interfaces.emplace_back(auxiliary_sensor.name, HW_IF_TIME_STAMP_NANO_SEC,
-                                &hw_time_stamp_nano_sec_);
+                                &hw_state_.time_stamp_nano_sec);
 
   // additional force-torque state interface
   const auto &estimated_ft_sensor = info_.sensors[1];
@@ -162,6 +251,51 @@ std::vector<hardware_interface::StateInterface> SystemInterface::export_state_in
   state_interfaces.emplace_back(estimated_ft_sensor.name, HW_IF_TORQUE_X, &hw_ft_[3]);
   state_interfaces.emplace_back(estimated_ft_sensor.name, HW_IF_TORQUE_Y, &hw_ft_[4]);
   state_interfaces.emplace_back(estimated_ft_sensor.name, HW_IF_TORQUE_Z, &hw_ft_[5]);
+  state_interfaces.emplace_back(estimated_ft_sensor.name, HW_IF_SIGMA_MIN, &hw_ft_sigma_min_);
+  state_interfaces.emplace_back(estimated_ft_sensor.name, HW_IF_MANIPULABILITY,
+                                &hw_ft_manipulability_);
+  state_interfaces.emplace_back(estimated_ft_sensor.name, HW_IF_DAMPING_FACTOR,
+                                &hw_ft_damping_factor_);
+
+  // additional kinematics state interfaces
+  const auto &kinematics_sensor = info_.sensors[2];
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_POSITION_X, &hw_pose_[0]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_POSITION_Y, &hw_pose_[1]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_POSITION_Z, &hw_pose_[2]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_ORIENTATION_X, &hw_pose_[3]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_ORIENTATION_Y, &hw_pose_[4]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_ORIENTATION_Z, &hw_pose_[5]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_ORIENTATION_W, &hw_pose_[6]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_LINEAR_X, &hw_twist_[0]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_LINEAR_Y, &hw_twist_[1]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_LINEAR_Z, &hw_twist_[2]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_ANGULAR_X, &hw_twist_[3]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_ANGULAR_Y, &hw_twist_[4]);
+  state_interfaces.emplace_back(kinematics_sensor.name, HW_IF_ANGULAR_Z, &hw_twist_[5]);
+  for (std::size_t row = 0; row < lbr_fri_ros2::FTEstimator::CARTESIAN_DOF; ++row) {
+    for (std::size_t col = 0; col < KUKA::FRI::LBRState::NUMBER_OF_JOINTS; ++col) {
+      state_interfaces.emplace_back(
+          kinematics_sensor.name,
+          std::string(HW_IF_JACOBIAN_PREFIX) + "_" + std::to_string(row) + "_" +
+              std::to_string(col),
+          &hw_jacobian_[row * KUKA::FRI::LBRState::NUMBER_OF_JOINTS + col]);
+    }
+  }
+
+  // additional force-torque state interfaces per estimation frame
+  for (std::size_t i = LBR_FRI_SENSORS; i < info_.sensors.size(); ++i) {
+    const auto &frame_sensor = info_.sensors[i];
+    auto &hw_frame_ft = hw_frame_ft_[i - LBR_FRI_SENSORS];
+    state_interfaces.emplace_back(frame_sensor.name, HW_IF_FORCE_X, &hw_frame_ft[0]);
+    state_interfaces.emplace_back(frame_sensor.name, HW_IF_FORCE_Y, &hw_frame_ft[1]);
+    state_interfaces.emplace_back(frame_sensor.name, HW_IF_FORCE_Z, &hw_frame_ft[2]);
+    state_interfaces.emplace_back(frame_sensor.name, HW_IF_TORQUE_X, &hw_frame_ft[3]);
+    state_interfaces.emplace_back(frame_sensor.name, HW_IF_TORQUE_Y, &hw_frame_ft[4]);
+    state_interfaces.emplace_back(frame_sensor.name, HW_IF_TORQUE_Z, &hw_frame_ft[5]);
+  }
+
+  // active estimation frame
+  state_interfaces.emplace_back(info_.gpios[1].name, HW_IF_INDEX, &hw_ft_frame_);
 
   return state_interfaces;
 }
@@ -184,12 +318,36 @@ std::vector<hardware_interface::CommandInterface> SystemInterface::export_comman
   command_interfaces.emplace_back(wrench.name, HW_IF_TORQUE_X, &hw_lbr_command_.wrench[3]);
   command_interfaces.emplace_back(wrench.name, HW_IF_TORQUE_Y, &hw_lbr_command_.wrench[4]);
   command_interfaces.emplace_back(wrench.name, HW_IF_TORQUE_Z, &hw_lbr_command_.wrench[5]);
+
+  // active estimation frame
+  command_interfaces.emplace_back(info_.gpios[1].name, HW_IF_INDEX, &hw_ft_frame_command_);
   return command_interfaces;
 }
 
 hardware_interface::return_type
-SystemInterface::prepare_command_mode_switch(const std::vector<std::string> & /*start_interfaces*/,
+SystemInterface::prepare_command_mode_switch(const std::vector<std::string> &start_interfaces,
+                                             const std::vector<std::string> & /*stop_interfaces*/) {
+  if (!verify_start_interfaces_(start_interfaces)) {
+    return hardware_interface::return_type::ERROR;
+  }
+  return hardware_interface::return_type::OK;
+}
+
+hardware_interface::return_type
+SystemInterface::perform_command_mode_switch(const std::vector<std::string> &start_interfaces,
                                              const std::vector<std::string> & /*stop_interfaces*/) {
+  if (parameters_.command_blend_time <= 0.) {
+    return hardware_interface::return_type::OK;
+  }
+
+  // blend whenever a controller starts commanding, the estimation frame selection is excluded
+  const std::string ft_frame_prefix = info_.gpios[1].name + "/";
+  if (std::any_of(start_interfaces.begin(), start_interfaces.end(),
+                  [&ft_frame_prefix](const std::string &interface) {
+                    return interface.rfind(ft_frame_prefix, 0) != 0;
+                  })) {
+    blend_requested_ = true;
+  }
   return hardware_interface::return_type::OK;
 }
 
@@ -204,51 +362,62 @@ controller_interface::CallbackReturn SystemInterface::on_activate(const rclcpp_l
     return controller_interface::CallbackReturn::ERROR;
   }
   app_ptr_->run_async(parameters_.rt_prio);
-  int attempt = 0;
-  while (!async_client_ptr_->get_state_interface()->is_initialized()) {
+
+  // woken by the FRI thread, progress is reported in between
+  const auto start = std::chrono::steady_clock::now();
+  while (!async_client_ptr_->get_state_interface()->wait_for_initialized(
+      ACTIVATION_PROGRESS_PERIOD)) {
     RCLCPP_INFO_STREAM(
         rclcpp::get_logger(LOGGER_NAME),
-        "Awaiting robot heartbeat. Attempt "
-            << ++attempt << ", remote_host '" << lbr_fri_ros2::ColorScheme::OKBLUE
-            << lbr_fri_ros2::ColorScheme::BOLD
+        "Awaiting robot heartbeat for "
+            << activation_elapsed_(start) << " s, remote_host '"
+            << lbr_fri_ros2::ColorScheme::OKBLUE << lbr_fri_ros2::ColorScheme::BOLD
             << (parameters_.remote_host == NULL ? "INADDR_ANY" : parameters_.remote_host)
             << lbr_fri_ros2::ColorScheme::ENDC << "', port_id '"
             << lbr_fri_ros2::ColorScheme::OKBLUE << lbr_fri_ros2::ColorScheme::BOLD
             << parameters_.port_id << "'" << lbr_fri_ros2::ColorScheme::ENDC);
-    if (!rclcpp::ok()) {
+    if (!activation_continues_(start)) {
+      app_ptr_->request_stop();
+      app_ptr_->close_udp_socket();
       return controller_interface::CallbackReturn::ERROR;
     }
-    std::this_thread::sleep_for(std::chrono::seconds(1));
   }
   RCLCPP_INFO_STREAM(rclcpp::get_logger(LOGGER_NAME), lbr_fri_ros2::ColorScheme::OKGREEN
-                                                          << "Robot connected"
+                                                          << "Robot connected after "
+                                                          << activation_elapsed_(start) << " s"
                                                           << lbr_fri_ros2::ColorScheme::ENDC);
   RCLCPP_INFO_STREAM(rclcpp::get_logger(LOGGER_NAME),
                      "Control mode '"
                          << lbr_fri_ros2::EnumMaps::control_mode_map(
-                                async_client_ptr_->get_state_interface()->get_state().control_mode)
+                                async_client_ptr_->get_state_interface()->get_control_mode())
                                 .c_str()
                          << "'");
   RCLCPP_INFO(rclcpp::get_logger(LOGGER_NAME), "Sample time %.3f s / %.1f Hz",
-              async_client_ptr_->get_state_interface()->get_state().sample_time,
-              1. / async_client_ptr_->get_state_interface()->get_state().sample_time);
-  while (!(async_client_ptr_->get_state_interface()->get_state().session_state >=
-           KUKA::FRI::ESessionState::COMMANDING_WAIT)) {
+              async_client_ptr_->get_state_interface()->get_sample_time(),
+              1. / async_client_ptr_->get_state_interface()->get_sample_time());
+  while (!async_client_ptr_->get_state_interface()->wait_for_session_state(
+      KUKA::FRI::ESessionState::COMMANDING_WAIT, ACTIVATION_PROGRESS_PERIOD)) {
     RCLCPP_INFO_STREAM(
         rclcpp::get_logger(LOGGER_NAME),
         "Awaiting '" << lbr_fri_ros2::ColorScheme::BOLD << lbr_fri_ros2::ColorScheme::OKBLUE
                      << lbr_fri_ros2::EnumMaps::session_state_map(
                             KUKA::FRI::ESessionState::COMMANDING_WAIT)
-                     << lbr_fri_ros2::ColorScheme::ENDC << "' state. Current state '"
+                     << lbr_fri_ros2::ColorScheme::ENDC << "' state for "
+                     << activation_elapsed_(start) << " s. Current state '"
                      << lbr_fri_ros2::ColorScheme::BOLD << lbr_fri_ros2::ColorScheme::OKBLUE
                      << lbr_fri_ros2::EnumMaps::session_state_map(
-                            async_client_ptr_->get_state_interface()->get_state().session_state)
+                            async_client_ptr_->get_state_interface()->get_session_state())
                      << lbr_fri_ros2::ColorScheme::ENDC << "'.");
-    if (!rclcpp::ok()) {
+    if (!activation_continues_(start)) {
+      app_ptr_->request_stop();
+      app_ptr_->close_udp_socket();
       return controller_interface::CallbackReturn::ERROR;
     }
-    std::this_thread::sleep_for(std::chrono::seconds(1));
   }
+  RCLCPP_INFO_STREAM(rclcpp::get_logger(LOGGER_NAME), lbr_fri_ros2::ColorScheme::OKGREEN
+                                                          << "Activated after "
+                                                          << activation_elapsed_(start) << " s"
+                                                          << lbr_fri_ros2::ColorScheme::ENDC);
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
@@ -256,28 +425,34 @@ controller_interface::CallbackReturn
 SystemInterface::on_deactivate(const rclcpp_lifecycle::State &) {
   app_ptr_->request_stop();
   app_ptr_->close_udp_socket();
+  if (ft_parameters_.calibrate_torque_bias) {
+    save_torque_bias_map_();
+  }
   return controller_interface::CallbackReturn::SUCCESS;
 }
 
 hardware_interface::return_type SystemInterface::read(const rclcpp::Time & /*time*/,
                                                       const rclcpp::Duration &period) {
-  if (!async_client_ptr_->get_state_interface()->is_initialized()) {
+  if (!state_initialized_()) {
     return hardware_interface::return_type::OK;
   }
 
-  hw_lbr_state_ = async_client_ptr_->get_state_interface()->get_state();
+  // single copy of the latest state block, casts are done on the FRI side
+  const double previous_session_state = hw_state_.session_state;
+  hw_state_ = get_state_block_();
 
-  if (period.seconds() - hw_lbr_state_.sample_time * 0.2 > hw_lbr_state_.sample_time) {
+  if (period.seconds() - hw_state_.state.sample_time * 0.2 > hw_state_.state.sample_time) {
     RCLCPP_WARN_STREAM(rclcpp::get_logger(LOGGER_NAME),
                        lbr_fri_ros2::ColorScheme::WARNING
                            << "Increase update_rate parameter for controller_manager to "
-                           << std::to_string(static_cast<int>(1. / hw_lbr_state_.sample_time))
+                           << std::to_string(static_cast<int>(1. / hw_state_.state.sample_time))
                            << " Hz or more" << lbr_fri_ros2::ColorScheme::ENDC);
   }
 
   // exit once robot exits COMMANDING_ACTIVE (for safety)
-  if (exit_commanding_active_(static_cast<KUKA::FRI::ESessionState>(hw_session_state_),
-                              static_cast<KUKA::FRI::ESessionState>(hw_lbr_state_.session_state))) {
+  if (exit_commanding_active_(
+          static_cast<KUKA::FRI::ESessionState>(previous_session_state),
+          static_cast<KUKA::FRI::ESessionState>(hw_state_.state.session_state))) {
     RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
                         lbr_fri_ros2::ColorScheme::ERROR
                             << "LBR left COMMANDING_ACTIVE. Please re-run lbr_bringup"
@@ -287,34 +462,61 @@ hardware_interface::return_type SystemInterface::read(const rclcpp::Time & /*tim
     return hardware_interface::return_type::ERROR;
   }
 
-  // state interfaces that require cast
-  hw_session_state_ = static_cast<double>(hw_lbr_state_.session_state);
-  hw_connection_quality_ = static_cast<double>(hw_lbr_state_.connection_quality);
-  hw_safety_state_ = static_cast<double>(hw_lbr_state_.safety_state);
-  hw_operation_mode_ = static_cast<double>(hw_lbr_state_.operation_mode);
-  hw_drive_state_ = static_cast<double>(hw_lbr_state_.drive_state);
-  hw_client_command_mode_ = static_cast<double>(hw_lbr_state_.client_command_mode);
-  hw_overlay_type_ = static_cast<double>(hw_lbr_state_.overlay_type);
-  hw_control_mode_ = static_cast<double>(hw_lbr_state_.control_mode);
-  hw_time_stamp_sec_ = static_cast<double>(hw_lbr_state_.time_stamp_sec);
-  hw_time_stamp_nano_sec_ = static_cast<double>(hw_lbr_state_.time_stamp_nano_sec);
+  // sample the external torque bias on new states
+  if (ft_parameters_.calibrate_torque_bias &&
+      (last_hw_time_stamp_sec_ != hw_state_.time_stamp_sec ||
+       last_hw_time_stamp_nano_sec_ != hw_state_.time_stamp_nano_sec)) {
+    torque_bias_map_ptr_->add_sample(hw_state_.state.measured_joint_position,
+                                     hw_state_.state.external_torque);
+  }
 
   // additional velocity state interface
   compute_hw_velocity_();
   update_last_hw_states_();
 
-  // additional force-torque state interface
-  ft_estimator_ptr_->compute(hw_lbr_state_.measured_joint_position, hw_lbr_state_.external_torque,
-                             hw_ft_, ft_parameters_.damping);
+  // additional kinematics state interfaces
+  if (kinematics_enabled_) {
+    compute_hw_kinematics_();
+  }
+
+  // payload identification, before force-torque estimation
+  if (payload_identifier_ptr_) {
+    identify_payload_();
+  }
+
+  // additional force-torque state interface, only estimated on demand
+  update_ft_active_frame_();
+  if (ft_estimation_due_()) {
+    // shared kinematics, evaluated once per state sample
+    kinematics_cache_ptr_->update(hw_state_.state.measured_joint_position, hw_state_.sequence);
+
+    // single estimate, expressed in all frames
+    ft_estimator_ptr_->estimate(hw_state_.state.external_torque, ft_parameters_.damping);
+    ft_estimator_ptr_->get_f_ext(ft_active_frame_, hw_ft_);
+    hw_ft_sigma_min_ = ft_estimator_ptr_->get_sigma_min();
+    hw_ft_manipulability_ = ft_estimator_ptr_->get_manipulability();
+    hw_ft_damping_factor_ = ft_estimator_ptr_->get_damping_factor();
+    for (std::size_t i = 0; i < hw_frame_ft_.size(); ++i) {
+      ft_estimator_ptr_->get_f_ext(ft_frame_indices_[i], hw_frame_ft_[i]);
+    }
+  }
   return hardware_interface::return_type::OK;
 }
 
 hardware_interface::return_type SystemInterface::write(const rclcpp::Time & /*time*/,
-                                                       const rclcpp::Duration & /*period*/) {
-  if (hw_session_state_ != KUKA::FRI::COMMANDING_ACTIVE) {
+                                                       const rclcpp::Duration &period) {
+  if (hw_state_.session_state != KUKA::FRI::COMMANDING_ACTIVE) {
     return hardware_interface::return_type::OK;
   }
-  async_client_ptr_->get_command_interface()->buffer_command_target(hw_lbr_command_);
+  if (blend_requested_.exchange(false)) {
+    start_blend_();
+  }
+  if (blending_) {
+    blend_command_(period.seconds());
+  } else {
+    hw_lbr_applied_command_ = hw_lbr_command_;
+  }
+  buffer_command_target_(hw_lbr_applied_command_);
   return hardware_interface::return_type::OK;
 }
 
@@ -372,6 +574,10 @@ bool SystemInterface::parse_parameters_(const hardware_interface::HardwareInfo &
                    info_.hardware_parameters["open_loop"].end(),
                    info_.hardware_parameters["open_loop"].begin(), ::tolower);
     parameters_.open_loop = info_.hardware_parameters["open_loop"] == "true";
+    std::transform(info_.hardware_parameters["cycle_sync"].begin(),
+                   info_.hardware_parameters["cycle_sync"].end(),
+                   info_.hardware_parameters["cycle_sync"].begin(), ::tolower);
+    parameters_.cycle_sync = info_.hardware_parameters["cycle_sync"] == "true";
     std::transform(info_.hardware_parameters["pid_antiwindup"].begin(),
                    info_.hardware_parameters["pid_antiwindup"].end(),
                    info_.hardware_parameters["pid_antiwindup"].begin(), ::tolower);
@@ -386,6 +592,16 @@ bool SystemInterface::parse_parameters_(const hardware_interface::HardwareInfo &
         std::stod(info_.hardware_parameters["external_torque_cutoff_frequency"]);
     parameters_.measured_torque_cutoff_frequency =
         std::stod(info_.hardware_parameters["measured_torque_cutoff_frequency"]);
+    parameters_.activation_timeout = std::stod(info_.hardware_parameters["activation_timeout"]);
+    parameters_.command_blend_time = std::stod(info_.hardware_parameters["command_blend_time"]);
+    if (parameters_.command_blend_time < 0.) {
+      RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                          lbr_fri_ros2::ColorScheme::ERROR
+                              << "Expected non-negative command_blend_time, got '"
+                              << lbr_fri_ros2::ColorScheme::BOLD << parameters_.command_blend_time
+                              << "'" << lbr_fri_ros2::ColorScheme::ENDC);
+      return false;
+    }
   } catch (const std::out_of_range &e) {
     RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
                         lbr_fri_ros2::ColorScheme::ERROR
@@ -400,38 +616,53 @@ void SystemInterface::nan_command_interfaces_() {
   hw_lbr_command_.joint_position.fill(std::numeric_limits<double>::quiet_NaN());
   hw_lbr_command_.torque.fill(std::numeric_limits<double>::quiet_NaN());
   hw_lbr_command_.wrench.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_ft_frame_command_ = std::numeric_limits<double>::quiet_NaN();
+  hw_lbr_applied_command_ = hw_lbr_command_;
 }
 
 void SystemInterface::nan_state_interfaces_() {
   // state interfaces of type double
-  hw_lbr_state_.measured_joint_position.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_state_.state.measured_joint_position.fill(std::numeric_limits<double>::quiet_NaN());
 #if FRI_CLIENT_VERSION_MAJOR == 1
-  hw_lbr_state_.commanded_joint_position.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_state_.state.commanded_joint_position.fill(std::numeric_limits<double>::quiet_NaN());
 #endif
-  hw_lbr_state_.measured_torque.fill(std::numeric_limits<double>::quiet_NaN());
-  hw_lbr_state_.commanded_torque.fill(std::numeric_limits<double>::quiet_NaN());
-  hw_lbr_state_.external_torque.fill(std::numeric_limits<double>::quiet_NaN());
-  hw_lbr_state_.ipo_joint_position.fill(std::numeric_limits<double>::quiet_NaN());
-  hw_lbr_state_.sample_time = std::numeric_limits<double>::quiet_NaN();
-  hw_lbr_state_.tracking_performance = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.state.measured_torque.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_state_.state.commanded_torque.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_state_.state.external_torque.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_state_.state.ipo_joint_position.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_state_.state.sample_time = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.state.tracking_performance = std::numeric_limits<double>::quiet_NaN();
 
   // state interfaces that require cast
-  hw_session_state_ = std::numeric_limits<double>::quiet_NaN();
-  hw_connection_quality_ = std::numeric_limits<double>::quiet_NaN();
-  hw_safety_state_ = std::numeric_limits<double>::quiet_NaN();
-  hw_operation_mode_ = std::numeric_limits<double>::quiet_NaN();
-  hw_drive_state_ = std::numeric_limits<double>::quiet_NaN();
-  hw_client_command_mode_ = std::numeric_limits<double>::quiet_NaN();
-  hw_overlay_type_ = std::numeric_limits<double>::quiet_NaN();
-  hw_control_mode_ = std::numeric_limits<double>::quiet_NaN();
-  hw_time_stamp_sec_ = std::numeric_limits<double>::quiet_NaN();
-  hw_time_stamp_nano_sec_ = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.session_state = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.connection_quality = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.safety_state = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.operation_mode = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.drive_state = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.client_command_mode = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.overlay_type = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.control_mode = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.time_stamp_sec = std::numeric_limits<double>::quiet_NaN();
+  hw_state_.time_stamp_nano_sec = std::numeric_limits<double>::quiet_NaN();
 
   // additional velocity state interface
   hw_velocity_.fill(std::numeric_limits<double>::quiet_NaN());
 
   // additional force-torque state interface
   hw_ft_.fill(std::numeric_limits<double>::quiet_NaN());
+
+  // additional kinematics state interfaces
+  hw_pose_.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_twist_.fill(std::numeric_limits<double>::quiet_NaN());
+  hw_jacobian_.fill(std::numeric_limits<double>::quiet_NaN());
+
+  hw_ft_sigma_min_ = std::numeric_limits<double>::quiet_NaN();
+  hw_ft_manipulability_ = std::numeric_limits<double>::quiet_NaN();
+  hw_ft_damping_factor_ = std::numeric_limits<double>::quiet_NaN();
+  for (auto &hw_frame_ft : hw_frame_ft_) {
+    hw_frame_ft.fill(std::numeric_limits<double>::quiet_NaN());
+  }
+  hw_ft_frame_ = static_cast<double>(ft_active_frame_);
 }
 
 bool SystemInterface::verify_number_of_joints_() {
@@ -513,10 +744,10 @@ bool SystemInterface::verify_joint_state_interfaces_() {
 
 bool SystemInterface::verify_sensors_() {
   // check lbr specific state interfaces
-  if (info_.sensors.size() != LBR_FRI_SENSORS) {
+  if (info_.sensors.size() < LBR_FRI_SENSORS) {
     RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
                         lbr_fri_ros2::ColorScheme::ERROR
-                            << "Expected '" << static_cast<int>(LBR_FRI_SENSORS)
+                            << "Expected at least '" << static_cast<int>(LBR_FRI_SENSORS)
                             << "' sensors, got '" << info_.sensors.size() << "'"
                             << lbr_fri_ros2::ColorScheme::ENDC);
     return false;
@@ -527,6 +758,12 @@ bool SystemInterface::verify_sensors_() {
   if (!verify_estimated_ft_sensor_()) {
     return false;
   }
+  if (!verify_kinematics_sensor_()) {
+    return false;
+  }
+  if (!verify_estimated_ft_frame_sensors_()) {
+    return false;
+  }
   return true;
 }
 
@@ -595,7 +832,9 @@ bool SystemInterface::verify_estimated_ft_sensor_() {
   // check only valid interfaces are defined
   for (const auto &si : estimated_ft_sensor.state_interfaces) {
     if (si.name != HW_IF_FORCE_X && si.name != HW_IF_FORCE_Y && si.name != HW_IF_FORCE_Z &&
-        si.name != HW_IF_TORQUE_X && si.name != HW_IF_TORQUE_Y && si.name != HW_IF_TORQUE_Z) {
+        si.name != HW_IF_TORQUE_X && si.name != HW_IF_TORQUE_Y && si.name != HW_IF_TORQUE_Z &&
+        si.name != HW_IF_SIGMA_MIN && si.name != HW_IF_MANIPULABILITY &&
+        si.name != HW_IF_DAMPING_FACTOR) {
       RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
                           lbr_fri_ros2::ColorScheme::ERROR
                               << "Sensor '" << estimated_ft_sensor.name.c_str()
@@ -607,6 +846,57 @@ bool SystemInterface::verify_estimated_ft_sensor_() {
   return true;
 }
 
+bool SystemInterface::verify_kinematics_sensor_() {
+  const auto &kinematics_sensor = info_.sensors[2];
+  if (kinematics_sensor.name != HW_IF_KINEMATICS_PREFIX) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                        lbr_fri_ros2::ColorScheme::ERROR
+                            << "Sensor '" << kinematics_sensor.name.c_str()
+                            << "' received invalid name. Expected '" << HW_IF_KINEMATICS_PREFIX
+                            << "'" << lbr_fri_ros2::ColorScheme::ENDC);
+    return false;
+  }
+  if (kinematics_sensor.state_interfaces.size() != KINEMATICS_SENSOR_SIZE) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                        lbr_fri_ros2::ColorScheme::ERROR
+                            << "Sensor '" << kinematics_sensor.name.c_str()
+                            << "' received invalid number of state interfaces. Received '"
+                            << kinematics_sensor.state_interfaces.size() << "', expected '"
+                            << static_cast<int>(KINEMATICS_SENSOR_SIZE) << "'"
+                            << lbr_fri_ros2::ColorScheme::ENDC);
+    return false;
+  }
+  return true;
+}
+
+bool SystemInterface::verify_estimated_ft_frame_sensors_() {
+  const std::string prefix = std::string(HW_IF_ESTIMATED_FT_PREFIX) + "_";
+  for (std::size_t i = LBR_FRI_SENSORS; i < info_.sensors.size(); ++i) {
+    const auto &frame_sensor = info_.sensors[i];
+    if (frame_sensor.name.rfind(prefix, 0) != 0 ||
+        frame_sensor.parameters.find("frame") == frame_sensor.parameters.end()) {
+      RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                          lbr_fri_ros2::ColorScheme::ERROR
+                              << "Sensor '" << frame_sensor.name.c_str()
+                              << "' received invalid name or is missing the frame parameter. "
+                                 "Expected prefix '"
+                              << prefix << "'" << lbr_fri_ros2::ColorScheme::ENDC);
+      return false;
+    }
+    if (frame_sensor.state_interfaces.size() != ESTIMATED_FT_FRAME_SENSOR_SIZE) {
+      RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                          lbr_fri_ros2::ColorScheme::ERROR
+                              << "Sensor '" << frame_sensor.name.c_str()
+                              << "' received invalid number of state interfaces. Received '"
+                              << frame_sensor.state_interfaces.size() << "', expected '"
+                              << static_cast<int>(ESTIMATED_FT_FRAME_SENSOR_SIZE) << "'"
+                              << lbr_fri_ros2::ColorScheme::ENDC);
+      return false;
+    }
+  }
+  return true;
+}
+
 bool SystemInterface::verify_gpios_() {
   if (info_.gpios.size() != GPIO_SIZE) {
     RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
@@ -633,6 +923,40 @@ bool SystemInterface::verify_gpios_() {
                             << lbr_fri_ros2::ColorScheme::ENDC);
     return false;
   }
+  if (info_.gpios[1].name != HW_IF_ESTIMATED_FT_FRAME_PREFIX ||
+      info_.gpios[1].command_interfaces.size() != 1 ||
+      info_.gpios[1].command_interfaces[0].name != HW_IF_INDEX ||
+      info_.gpios[1].state_interfaces.size() != 1 ||
+      info_.gpios[1].state_interfaces[0].name != HW_IF_INDEX) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                        lbr_fri_ros2::ColorScheme::ERROR
+                            << "GPIO '" << info_.gpios[1].name.c_str()
+                            << "' is invalid. Expected '" << HW_IF_ESTIMATED_FT_FRAME_PREFIX
+                            << "' with command and state interface '" << HW_IF_INDEX << "'"
+                            << lbr_fri_ros2::ColorScheme::ENDC);
+    return false;
+  }
+  return true;
+}
+
+bool SystemInterface::state_initialized_() {
+  return async_client_ptr_->get_state_interface()->is_initialized();
+}
+
+const lbr_fri_ros2::StateBlock &SystemInterface::get_state_block_() {
+  return async_client_ptr_->get_state_interface()->get_state_block();
+}
+
+void SystemInterface::buffer_command_target_(const lbr_fri_idl::msg::LBRCommand &command) {
+  async_client_ptr_->get_command_interface()->buffer_command_target(command);
+}
+
+bool SystemInterface::get_client_command_mode_(
+    KUKA::FRI::EClientCommandMode &client_command_mode) const {
+  if (!async_client_ptr_ || !async_client_ptr_->get_state_interface()->is_initialized()) {
+    return false;
+  }
+  client_command_mode = async_client_ptr_->get_state_interface()->get_client_command_mode();
   return true;
 }
 
@@ -650,6 +974,208 @@ double SystemInterface::time_stamps_to_sec_(const double &sec, const double &nan
   return sec + nano_sec / 1.e9;
 }
 
+void SystemInterface::compute_hw_kinematics_() {
+  // shared kinematics, evaluated once per state sample
+  kinematics_cache_ptr_->update(hw_state_.state.measured_joint_position, hw_state_.sequence);
+
+  // chain tip pose
+  const KDL::Frame &chain_tip_frame = kinematics_cache_ptr_->get_tip_frame();
+  hw_pose_[0] = chain_tip_frame.p.x();
+  hw_pose_[1] = chain_tip_frame.p.y();
+  hw_pose_[2] = chain_tip_frame.p.z();
+  chain_tip_frame.M.GetQuaternion(hw_pose_[3], hw_pose_[4], hw_pose_[5], hw_pose_[6]);
+
+  // row-major Jacobian and chain tip twist
+  const auto &jacobian = kinematics_cache_ptr_->get_jacobian().data;
+  Eigen::Map<Eigen::Matrix<double, lbr_fri_ros2::FTEstimator::CARTESIAN_DOF,
+                           KUKA::FRI::LBRState::NUMBER_OF_JOINTS, Eigen::RowMajor>>(
+      hw_jacobian_.data()) = jacobian;
+  Eigen::Map<Eigen::Matrix<double, TWIST_SIZE, 1>>(hw_twist_.data()).noalias() =
+      jacobian * Eigen::Map<const Eigen::Matrix<double, KUKA::FRI::LBRState::NUMBER_OF_JOINTS, 1>>(
+                     hw_velocity_.data());
+}
+
+bool SystemInterface::ft_estimation_due_() {
+  if (!ft_parameters_.enabled) {
+    return false;
+  }
+
+  // state wasn't updated
+  const uint64_t sequence = hw_state_.sequence;
+  if (ft_sequence_valid_ && ft_sequence_ == sequence) {
+    return false;
+  }
+  ft_sequence_ = sequence;
+  ft_sequence_valid_ = true;
+
+  // estimate every decimation-th state sample
+  if (++ft_decimation_counter_ < ft_parameters_.decimation) {
+    return false;
+  }
+  ft_decimation_counter_ = 0;
+  return true;
+}
+
+bool SystemInterface::setup_ft_frames_() {
+  // resolve frames once, no kinematic chains are rebuilt when switching frames
+  hw_frame_ft_.clear();
+  ft_frame_indices_.clear();
+  for (std::size_t i = LBR_FRI_SENSORS; i < info_.sensors.size(); ++i) {
+    const auto frame = info_.sensors[i].parameters.find("frame");
+    if (frame == info_.sensors[i].parameters.end()) {
+      continue; // reported by verify_estimated_ft_frame_sensors_
+    }
+    try {
+      ft_frame_indices_.push_back(ft_estimator_ptr_->add_frame(frame->second));
+    } catch (const std::exception &e) {
+      RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                          lbr_fri_ros2::ColorScheme::ERROR
+                              << "Failed to add estimation frame: " << e.what()
+                              << lbr_fri_ros2::ColorScheme::ENDC);
+      return false;
+    }
+    hw_frame_ft_.emplace_back();
+    hw_frame_ft_.back().fill(std::numeric_limits<double>::quiet_NaN());
+  }
+  ft_active_frame_ = 0;
+  return true;
+}
+
+void SystemInterface::update_ft_active_frame_() {
+  if (std::isnan(hw_ft_frame_command_)) {
+    return;
+  }
+  const double frame = std::round(hw_ft_frame_command_);
+  if (frame < 0. || frame >= static_cast<double>(ft_estimator_ptr_->get_number_of_frames()) ||
+      static_cast<std::size_t>(frame) == ft_active_frame_) {
+    return;
+  }
+  ft_active_frame_ = static_cast<std::size_t>(frame);
+  hw_ft_frame_ = frame;
+
+  // express the last estimate in the new frame right away
+  if (ft_parameters_.enabled && ft_sequence_valid_) {
+    ft_estimator_ptr_->get_f_ext(ft_active_frame_, hw_ft_);
+  }
+}
+
+bool SystemInterface::setup_torque_bias_map_() {
+  if (ft_parameters_.torque_bias_map_file == "none") {
+    if (ft_parameters_.calibrate_torque_bias) {
+      RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                          lbr_fri_ros2::ColorScheme::ERROR
+                              << "Torque bias calibration requires a torque_bias_map_file"
+                              << lbr_fri_ros2::ColorScheme::ENDC);
+      return false;
+    }
+    return true;
+  }
+  try {
+    if (ft_parameters_.calibrate_torque_bias) {
+      // grid spans the joint limits
+      std::vector<double> min, max;
+      for (const auto &joint : ft_parameters_.torque_bias_joints) {
+        if (joint >= info_.joints.size()) {
+          RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                              lbr_fri_ros2::ColorScheme::ERROR
+                                  << "Invalid torque bias joint '" << joint << "'"
+                                  << lbr_fri_ros2::ColorScheme::ENDC);
+          return false;
+        }
+        min.push_back(std::stod(info_.joints[joint].parameters.at("min_position")));
+        max.push_back(std::stod(info_.joints[joint].parameters.at("max_position")));
+      }
+      torque_bias_map_ptr_ = std::make_shared<lbr_fri_ros2::TorqueBiasMap>(
+          ft_parameters_.torque_bias_joints, min, max, ft_parameters_.torque_bias_resolution,
+          kinematics_cache_ptr_->get_robot_name(), ft_parameters_.chain_root,
+          ft_parameters_.chain_tip);
+      RCLCPP_INFO(rclcpp::get_logger(LOGGER_NAME),
+                  "Calibrating external torque bias. Move the robot freely and without contact. "
+                  "The map is saved to '%s' on deactivation.",
+                  ft_parameters_.torque_bias_map_file.c_str());
+    } else {
+      torque_bias_map_ptr_ = std::make_shared<lbr_fri_ros2::TorqueBiasMap>(
+          ft_parameters_.torque_bias_map_file, kinematics_cache_ptr_->get_robot_name(),
+          ft_parameters_.chain_root, ft_parameters_.chain_tip);
+      ft_estimator_ptr_->set_torque_bias_map(torque_bias_map_ptr_);
+      RCLCPP_INFO(rclcpp::get_logger(LOGGER_NAME), "Loaded external torque bias map from '%s'.",
+                  ft_parameters_.torque_bias_map_file.c_str());
+    }
+  } catch (const std::exception &e) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                        lbr_fri_ros2::ColorScheme::ERROR << "Failed to setup torque bias map: "
+                                                         << e.what()
+                                                         << lbr_fri_ros2::ColorScheme::ENDC);
+    return false;
+  }
+  return true;
+}
+
+void SystemInterface::save_torque_bias_map_() {
+  if (!torque_bias_map_ptr_) {
+    return;
+  }
+  if (torque_bias_map_ptr_->save(ft_parameters_.torque_bias_map_file)) {
+    RCLCPP_INFO(rclcpp::get_logger(LOGGER_NAME),
+                "Saved external torque bias map to '%s'. Grid coverage %.1f %%.",
+                ft_parameters_.torque_bias_map_file.c_str(),
+                torque_bias_map_ptr_->get_coverage() * 100.);
+  }
+}
+
+bool SystemInterface::standstill_() const {
+  return std::all_of(hw_velocity_.cbegin(), hw_velocity_.cend(),
+                     [](const double &v) { return std::abs(v) < STANDSTILL_VELOCITY_TH; });
+}
+
+void SystemInterface::identify_payload_() {
+  if (!standstill_()) {
+    return;
+  }
+
+  // one sample per state sample, the kinematics may already be up to date for it
+  const uint64_t sequence = hw_state_.sequence;
+  if (payload_sequence_valid_ && payload_sequence_ == sequence) {
+    return;
+  }
+  payload_sequence_ = sequence;
+  payload_sequence_valid_ = true;
+  kinematics_cache_ptr_->update(hw_state_.state.measured_joint_position, sequence);
+  payload_identifier_ptr_->add_sample(hw_state_.state.external_torque);
+  if (payload_identifier_ptr_->get_number_of_samples() <
+      ft_parameters_.payload_identification_samples) {
+    return;
+  }
+
+  // identify, retried on every new distinct pose until identifiable
+  if (payload_identifier_ptr_->get_number_of_poses() == payload_identification_poses_) {
+    return;
+  }
+  payload_identification_poses_ = payload_identifier_ptr_->get_number_of_poses();
+  lbr_fri_ros2::Payload payload;
+  if (!payload_identifier_ptr_->identify(payload)) {
+    RCLCPP_WARN_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                       lbr_fri_ros2::ColorScheme::WARNING
+                           << "Payload not yet identifiable, keeping the previous payload. Hold "
+                              "the robot at rest in a differently oriented pose"
+                           << lbr_fri_ros2::ColorScheme::ENDC);
+    return;
+  }
+
+  // apply and store once
+  ft_estimator_ptr_->set_payload(payload);
+  RCLCPP_INFO(rclcpp::get_logger(LOGGER_NAME),
+              "Identified payload with mass %.3f kg and center of mass [%.3f, %.3f, %.3f] m.",
+              payload.mass, payload.center_of_mass[0], payload.center_of_mass[1],
+              payload.center_of_mass[2]);
+  if (ft_parameters_.payload_file != "none" &&
+      lbr_fri_ros2::PayloadIdentifier::save(ft_parameters_.payload_file, payload)) {
+    RCLCPP_INFO(rclcpp::get_logger(LOGGER_NAME), "Saved payload to '%s'.",
+                ft_parameters_.payload_file.c_str());
+  }
+  payload_identifier_ptr_.reset();
+}
+
 void SystemInterface::nan_last_hw_states_() {
   last_hw_measured_joint_position_.fill(std::numeric_limits<double>::quiet_NaN());
   last_hw_time_stamp_sec_ = std::numeric_limits<double>::quiet_NaN();
@@ -657,9 +1183,9 @@ void SystemInterface::nan_last_hw_states_() {
 }
 
 void SystemInterface::update_last_hw_states_() {
-  last_hw_measured_joint_position_ = hw_lbr_state_.measured_joint_position;
-  last_hw_time_stamp_sec_ = hw_time_stamp_sec_;
-  last_hw_time_stamp_nano_sec_ = hw_time_stamp_nano_sec_;
+  last_hw_measured_joint_position_ = hw_state_.state.measured_joint_position;
+  last_hw_time_stamp_sec_ = hw_state_.time_stamp_sec;
+  last_hw_time_stamp_nano_sec_ = hw_state_.time_stamp_nano_sec;
 }
 
 void SystemInterface::compute_hw_velocity_() {
@@ -669,20 +1195,133 @@ void SystemInterface::compute_hw_velocity_() {
   }
 
   // state wasn't updated
-  if (last_hw_time_stamp_sec_ == hw_time_stamp_sec_ &&
-      last_hw_time_stamp_nano_sec_ == hw_time_stamp_nano_sec_) {
+  if (last_hw_time_stamp_sec_ == hw_state_.time_stamp_sec &&
+      last_hw_time_stamp_nano_sec_ == hw_state_.time_stamp_nano_sec) {
     return;
   }
 
-  double dt = time_stamps_to_sec_(hw_time_stamp_sec_, hw_time_stamp_nano_sec_) -
+  double dt = time_stamps_to_sec_(hw_state_.time_stamp_sec, hw_state_.time_stamp_nano_sec) -
               time_stamps_to_sec_(last_hw_time_stamp_sec_, last_hw_time_stamp_nano_sec_);
   std::size_t i = 0;
   std::for_each(hw_velocity_.begin(), hw_velocity_.end(), [&](double &v) {
-    v = (hw_lbr_state_.measured_joint_position[i] - last_hw_measured_joint_position_[i]) / dt;
+    v = (hw_state_.state.measured_joint_position[i] - last_hw_measured_joint_position_[i]) / dt;
     ++i;
   });
 }
 
+bool SystemInterface::verify_start_interfaces_(
+    const std::vector<std::string> &start_interfaces) const {
+  // the mode the robot application runs in, which may differ from the configured one
+  KUKA::FRI::EClientCommandMode client_command_mode;
+  const bool client_command_mode_known = get_client_command_mode_(client_command_mode);
+  for (const auto &interface : start_interfaces) {
+    const std::size_t separator = interface.rfind('/');
+    const std::string prefix = interface.substr(0, separator);
+    const std::string name =
+        separator == std::string::npos ? std::string() : interface.substr(separator + 1);
+    if (prefix == info_.gpios[1].name) {
+      continue; // estimation frame selection is independent of the client command mode
+    }
+    const bool is_joint = std::any_of(info_.joints.begin(), info_.joints.end(),
+                                      [&prefix](const hardware_interface::ComponentInfo &joint) {
+                                        return joint.name == prefix;
+                                      });
+    if (!client_command_mode_known) {
+      RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                          lbr_fri_ros2::ColorScheme::ERROR
+                              << "Command interface '" << interface
+                              << "' requested before the robot reported its client command mode"
+                              << lbr_fri_ros2::ColorScheme::ENDC);
+      return false;
+    }
+    bool valid = false;
+    if (is_joint && name == hardware_interface::HW_IF_POSITION) {
+      // joint position is commanded in all client command modes
+      valid = client_command_mode != KUKA::FRI::EClientCommandMode::NO_COMMAND_MODE;
+    } else if (is_joint && name == hardware_interface::HW_IF_EFFORT) {
+      valid = client_command_mode == KUKA::FRI::EClientCommandMode::TORQUE;
+    } else if (prefix == info_.gpios[0].name) {
+      valid = client_command_mode == KUKA::FRI::EClientCommandMode::WRENCH;
+    }
+    if (!valid) {
+      RCLCPP_ERROR_STREAM(
+          rclcpp::get_logger(LOGGER_NAME),
+          lbr_fri_ros2::ColorScheme::ERROR
+              << "Command interface '" << interface
+              << "' is not available in client command mode '"
+              << lbr_fri_ros2::EnumMaps::client_command_mode_map(client_command_mode)
+              << "' reported by the robot, configured '"
+              << lbr_fri_ros2::EnumMaps::client_command_mode_map(parameters_.client_command_mode)
+              << "'. Match the robot application and client_command_mode in "
+                 "lbr_system_parameters.yaml"
+              << lbr_fri_ros2::ColorScheme::ENDC);
+      return false;
+    }
+  }
+  return true;
+}
+
+void SystemInterface::start_blend_() {
+  // last applied command, or the measured state if nothing was applied yet
+  blend_start_command_ = hw_lbr_applied_command_;
+  for (std::size_t i = 0; i < blend_start_command_.joint_position.size(); ++i) {
+    if (std::isnan(blend_start_command_.joint_position[i])) {
+      blend_start_command_.joint_position[i] = hw_state_.state.measured_joint_position[i];
+    }
+    if (std::isnan(blend_start_command_.torque[i])) {
+      blend_start_command_.torque[i] = 0.;
+    }
+  }
+  for (auto &wrench : blend_start_command_.wrench) {
+    if (std::isnan(wrench)) {
+      wrench = 0.;
+    }
+  }
+  blend_elapsed_ = 0.;
+  blending_ = true;
+}
+
+void SystemInterface::blend_command_(const double &dt) {
+  blend_elapsed_ += dt;
+  const double s = std::min(blend_elapsed_ / parameters_.command_blend_time, 1.);
+  const double alpha = s * s * (3. - 2. * s); // smoothstep, no rate jump at either end
+
+  // targets not yet written by the new controller hold the start command
+  auto crossfade = [&alpha](const auto &from, const auto &to, auto &out) {
+    for (std::size_t i = 0; i < out.size(); ++i) {
+      out[i] = std::isnan(to[i]) ? from[i] : from[i] + alpha * (to[i] - from[i]);
+    }
+  };
+  crossfade(blend_start_command_.joint_position, hw_lbr_command_.joint_position,
+            hw_lbr_applied_command_.joint_position);
+  crossfade(blend_start_command_.torque, hw_lbr_command_.torque, hw_lbr_applied_command_.torque);
+  crossfade(blend_start_command_.wrench, hw_lbr_command_.wrench, hw_lbr_applied_command_.wrench);
+  if (s >= 1.) {
+    blending_ = false;
+  }
+}
+
+double SystemInterface::activation_elapsed_(
+    const std::chrono::steady_clock::time_point &start) const {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool SystemInterface::activation_continues_(
+    const std::chrono::steady_clock::time_point &start) const {
+  if (!rclcpp::ok()) {
+    return false;
+  }
+  if (parameters_.activation_timeout > 0. &&
+      activation_elapsed_(start) > parameters_.activation_timeout) {
+    RCLCPP_ERROR_STREAM(rclcpp::get_logger(LOGGER_NAME),
+                        lbr_fri_ros2::ColorScheme::ERROR
+                            << "Activation timed out after " << parameters_.activation_timeout
+                            << " s. Is the LBRServer application running on the robot?"
+                            << lbr_fri_ros2::ColorScheme::ENDC);
+    return false;
+  }
+  return true;
+}
 } // namespace lbr_ros2_control
 
 #include <pluginlib/class_list_macros.hpp>
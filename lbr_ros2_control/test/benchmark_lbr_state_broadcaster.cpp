@@ -0,0 +1,253 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hardware_interface/handle.hpp"
+#include "hardware_interface/loaned_state_interface.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "friLBRState.h"
+
+#include "lbr_fri_idl/msg/lbr_state.hpp"
+#include "lbr_ros2_control/controllers/lbr_state_broadcaster.hpp"
+#include "lbr_ros2_control/system_interface_type_values.hpp"
+
+// Measures the cost of LBRStateBroadcaster::update against the previous implementation, which
+// wrote all state interfaces into a nested, string-keyed map and looked the message fields up.
+// The state interfaces mirror the lbr_ros2_control::SystemInterface's.
+// Further measures the publish-to-receive latency of the state topic for copied and loaned
+// messages. Run with a shared-memory capable middleware for the latter, e.g. iceoryx or
+// Cyclone DDS with shared memory enabled.
+
+namespace {
+constexpr std::size_t ITERATIONS = 100000;
+constexpr std::size_t LATENCY_SAMPLES = 1000;
+using joint_names_t = std::array<std::string, KUKA::FRI::LBRState::NUMBER_OF_JOINTS>;
+
+std::vector<hardware_interface::StateInterface>
+make_state_interfaces(std::vector<double> &values, const joint_names_t &joints) {
+  using namespace lbr_ros2_control;
+  std::vector<std::pair<std::string, std::string>> names;
+  for (const auto &joint_name : joints) {
+    for (const auto &interface_name :
+         {hardware_interface::HW_IF_POSITION, HW_IF_COMMANDED_JOINT_POSITION,
+          hardware_interface::HW_IF_EFFORT, HW_IF_COMMANDED_TORQUE, HW_IF_EXTERNAL_TORQUE,
+          HW_IF_IPO_JOINT_POSITION, hardware_interface::HW_IF_VELOCITY}) {
+      names.emplace_back(joint_name, interface_name);
+    }
+  }
+  for (const auto &interface_name :
+       {HW_IF_SAMPLE_TIME, HW_IF_SESSION_STATE, HW_IF_CONNECTION_QUALITY, HW_IF_SAFETY_STATE,
+        HW_IF_OPERATION_MODE, HW_IF_DRIVE_STATE, HW_IF_CLIENT_COMMAND_MODE, HW_IF_OVERLAY_TYPE,
+        HW_IF_CONTROL_MODE, HW_IF_TIME_STAMP_SEC, HW_IF_TIME_STAMP_NANO_SEC,
+        HW_IF_TRACKING_PERFORMANCE}) {
+    names.emplace_back(HW_IF_AUXILIARY_PREFIX, interface_name);
+  }
+  for (const auto &interface_name :
+       {HW_IF_FORCE_X, HW_IF_FORCE_Y, HW_IF_FORCE_Z, HW_IF_TORQUE_X, HW_IF_TORQUE_Y,
+        HW_IF_TORQUE_Z, HW_IF_SIGMA_MIN, HW_IF_MANIPULABILITY, HW_IF_DAMPING_FACTOR}) {
+    names.emplace_back(HW_IF_ESTIMATED_FT_PREFIX, interface_name);
+  }
+  for (std::size_t row = 0; row < 6; ++row) { // pose and twist omitted
+    for (std::size_t col = 0; col < KUKA::FRI::LBRState::NUMBER_OF_JOINTS; ++col) {
+      names.emplace_back(HW_IF_KINEMATICS_PREFIX, std::string(HW_IF_JACOBIAN_PREFIX) + "_" +
+                                                      std::to_string(row) + "_" +
+                                                      std::to_string(col));
+    }
+  }
+
+  values.assign(names.size(), 0.);
+  std::vector<hardware_interface::StateInterface> state_interfaces;
+  for (std::size_t idx = 0; idx < names.size(); ++idx) {
+    values[idx] = 0.1 * idx;
+    state_interfaces.emplace_back(names[idx].first, names[idx].second, &values[idx]);
+  }
+  return state_interfaces;
+}
+
+// previous implementation
+class MapStateCopy {
+public:
+  MapStateCopy(const joint_names_t &joints) : joint_names_(joints) {}
+
+  void update(const std::vector<hardware_interface::LoanedStateInterface> &state_interfaces) {
+    using namespace lbr_ros2_control;
+    for (const auto &state_interface : state_interfaces) {
+      map_[state_interface.get_prefix_name()][state_interface.get_interface_name()] =
+          state_interface.get_value();
+    }
+    if (std::isnan(map_[joint_names_[0]][hardware_interface::HW_IF_POSITION])) {
+      return;
+    }
+    auto &aux = map_[HW_IF_AUXILIARY_PREFIX];
+    msg_.client_command_mode = static_cast<int8_t>(aux[HW_IF_CLIENT_COMMAND_MODE]);
+    msg_.connection_quality = static_cast<int8_t>(aux[HW_IF_CONNECTION_QUALITY]);
+    msg_.control_mode = static_cast<int8_t>(aux[HW_IF_CONTROL_MODE]);
+    msg_.drive_state = static_cast<int8_t>(aux[HW_IF_DRIVE_STATE]);
+    msg_.operation_mode = static_cast<int8_t>(aux[HW_IF_OPERATION_MODE]);
+    msg_.overlay_type = static_cast<int8_t>(aux[HW_IF_OVERLAY_TYPE]);
+    msg_.safety_state = static_cast<int8_t>(aux[HW_IF_SAFETY_STATE]);
+    msg_.sample_time = aux[HW_IF_SAMPLE_TIME];
+    msg_.session_state = static_cast<int8_t>(aux[HW_IF_SESSION_STATE]);
+    msg_.time_stamp_nano_sec = static_cast<uint32_t>(aux[HW_IF_TIME_STAMP_NANO_SEC]);
+    msg_.time_stamp_sec = static_cast<uint32_t>(aux[HW_IF_TIME_STAMP_SEC]);
+    msg_.tracking_performance = aux[HW_IF_TRACKING_PERFORMANCE];
+    for (std::size_t idx = 0; idx < joint_names_.size(); ++idx) {
+      msg_.commanded_torque[idx] = map_[joint_names_[idx]][HW_IF_COMMANDED_TORQUE];
+      msg_.external_torque[idx] = map_[joint_names_[idx]][HW_IF_EXTERNAL_TORQUE];
+      msg_.ipo_joint_position[idx] = map_[joint_names_[idx]][HW_IF_IPO_JOINT_POSITION];
+      msg_.measured_joint_position[idx] =
+          map_[joint_names_[idx]][hardware_interface::HW_IF_POSITION];
+      msg_.measured_torque[idx] = map_[joint_names_[idx]][hardware_interface::HW_IF_EFFORT];
+    }
+  }
+
+protected:
+  joint_names_t joint_names_;
+  std::unordered_map<std::string, std::unordered_map<std::string, double>> map_;
+  lbr_fri_idl::msg::LBRState msg_;
+};
+
+template <typename F> double mean_ns(F &&f) {
+  for (std::size_t i = 0; i < ITERATIONS / 10; ++i) {
+    f(); // warm up
+  }
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < ITERATIONS; ++i) {
+    f();
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+             .count() /
+         ITERATIONS;
+}
+// publish-to-receive latency, the time stamp state interfaces carry the steady clock at update()
+double mean_latency_us(std::vector<hardware_interface::StateInterface> &state_interfaces,
+                       std::vector<double> &values, const bool &loaned_messages,
+                       std::size_t &received) {
+  double *time_stamp_sec = nullptr, *time_stamp_nano_sec = nullptr;
+  std::vector<hardware_interface::LoanedStateInterface> loaned_state_interfaces;
+  for (std::size_t idx = 0; idx < state_interfaces.size(); ++idx) {
+    if (state_interfaces[idx].get_interface_name() == lbr_ros2_control::HW_IF_TIME_STAMP_SEC) {
+      time_stamp_sec = &values[idx];
+    }
+    if (state_interfaces[idx].get_interface_name() ==
+        lbr_ros2_control::HW_IF_TIME_STAMP_NANO_SEC) {
+      time_stamp_nano_sec = &values[idx];
+    }
+    loaned_state_interfaces.emplace_back(state_interfaces[idx]);
+  }
+
+  const std::string name =
+      std::string("lbr_state_broadcaster_") + (loaned_messages ? "loaned" : "copied");
+  lbr_ros2_control::LBRStateBroadcaster broadcaster;
+  if (broadcaster.init(name) != controller_interface::return_type::OK) {
+    throw std::runtime_error("Failed to initialize LBRStateBroadcaster.");
+  }
+  broadcaster.get_node()->set_parameter(rclcpp::Parameter("loaned_messages", loaned_messages));
+  broadcaster.assign_interfaces({}, std::move(loaned_state_interfaces));
+  broadcaster.on_configure(rclcpp_lifecycle::State());
+  broadcaster.on_activate(rclcpp_lifecycle::State());
+
+  // only accessed by the executor until it is joined
+  double latency_sum_us = 0.;
+  received = 0;
+  auto node = std::make_shared<rclcpp::Node>(name + "_subscriber");
+  auto subscription = node->create_subscription<lbr_fri_idl::msg::LBRState>(
+      "/" + name + "/state", 1, [&](const lbr_fri_idl::msg::LBRState::SharedPtr msg) {
+        const auto now = std::chrono::steady_clock::now().time_since_epoch();
+        const auto stamp = std::chrono::seconds(msg->time_stamp_sec) +
+                           std::chrono::nanoseconds(msg->time_stamp_nano_sec);
+        latency_sum_us += std::chrono::duration<double, std::micro>(now - stamp).count();
+        ++received;
+      });
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  std::thread spin_thread([&]() { executor.spin(); });
+  while (subscription->get_publisher_count() == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  const rclcpp::Time time(0, 0, RCL_STEADY_TIME);
+  const rclcpp::Duration period(0, 1000000);
+  for (std::size_t i = 0; i < LATENCY_SAMPLES; ++i) {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    const auto sec = std::chrono::duration_cast<std::chrono::seconds>(now);
+    const auto nano_sec = std::chrono::duration_cast<std::chrono::nanoseconds>(now - sec);
+    *time_stamp_sec = static_cast<double>(sec.count());
+    *time_stamp_nano_sec = static_cast<double>(nano_sec.count());
+    broadcaster.update(time, period);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1)); // FRI rate, no queueing
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  executor.cancel();
+  spin_thread.join();
+
+  broadcaster.on_deactivate(rclcpp_lifecycle::State());
+  broadcaster.release_interfaces();
+  return received > 0 ? latency_sum_us / received : std::numeric_limits<double>::quiet_NaN();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  rclcpp::init(argc, argv);
+  const joint_names_t joints = {"A1", "A2", "A3", "A4", "A5", "A6", "A7"};
+  std::vector<double> values;
+  auto state_interfaces = make_state_interfaces(values, joints);
+
+  // previous implementation
+  std::vector<hardware_interface::LoanedStateInterface> map_loaned_state_interfaces;
+  for (auto &state_interface : state_interfaces) {
+    map_loaned_state_interfaces.emplace_back(state_interface);
+  }
+  MapStateCopy map_state_copy(joints);
+  const double map_ns = mean_ns([&]() { map_state_copy.update(map_loaned_state_interfaces); });
+
+  // LBRStateBroadcaster
+  std::vector<hardware_interface::LoanedStateInterface> loaned_state_interfaces;
+  for (auto &state_interface : state_interfaces) {
+    loaned_state_interfaces.emplace_back(state_interface);
+  }
+  lbr_ros2_control::LBRStateBroadcaster broadcaster;
+  if (broadcaster.init("lbr_state_broadcaster") != controller_interface::return_type::OK) {
+    std::cerr << "Failed to initialize LBRStateBroadcaster." << std::endl;
+    return 1;
+  }
+  broadcaster.assign_interfaces({}, std::move(loaned_state_interfaces));
+  broadcaster.on_configure(rclcpp_lifecycle::State());
+  broadcaster.on_activate(rclcpp_lifecycle::State());
+  const rclcpp::Time time(0, 0, RCL_STEADY_TIME);
+  const rclcpp::Duration period(0, 1000000);
+  const double broadcaster_ns = mean_ns([&]() { broadcaster.update(time, period); });
+  broadcaster.on_deactivate(rclcpp_lifecycle::State());
+
+  std::cout << state_interfaces.size() << " state interfaces, mean over " << ITERATIONS
+            << " updates:" << std::endl;
+  std::cout << "  string-keyed map:    " << map_ns << " ns" << std::endl;
+  std::cout << "  LBRStateBroadcaster: " << broadcaster_ns << " ns, including publishing"
+            << std::endl;
+
+  broadcaster.release_interfaces();
+
+  std::size_t copied_received = 0, loaned_received = 0;
+  const double copied_us = mean_latency_us(state_interfaces, values, false, copied_received);
+  const double loaned_us = mean_latency_us(state_interfaces, values, true, loaned_received);
+  std::cout << "Publish-to-receive latency, mean over received of " << LATENCY_SAMPLES
+            << " samples:" << std::endl;
+  std::cout << "  copied: " << copied_us << " us, " << copied_received << " received"
+            << std::endl;
+  std::cout << "  loaned: " << loaned_us << " us, " << loaned_received
+            << " received (copied if the middleware cannot loan, see warning)" << std::endl;
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "eigen3/Eigen/Cholesky"
+#include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/Geometry"
+
+#include "lbr_ros2_control/controllers/admittance_rcm_controller.hpp"
+
+// Measures the cost of RCMSolver::solve per update of the AdmittanceRCMController, against the
+// unconstrained damped least-squares solve of the AdmittanceController. The chain tip pose is
+// integrated under a scripted twist, with a fixed Jacobian.
+
+namespace {
+constexpr std::size_t ITERATIONS = 100000;
+using cart_vector_t = lbr_ros2_control::RCMSolver::cart_vector_t;
+using jnt_vector_t = lbr_ros2_control::RCMSolver::jnt_vector_t;
+using jacobian_t = lbr_ros2_control::RCMSolver::jacobian_t;
+
+struct Timing {
+  double mean_ns{0.};
+  double max_ns{0.};
+};
+
+template <typename Solve> Timing time_ns(Solve &&solve) {
+  const double dt = 0.001;
+  Eigen::Vector3d position(0.4, 0.1, 0.6);
+  Eigen::Matrix3d rotation;
+  rotation = Eigen::AngleAxisd(2.5, Eigen::Vector3d(1., 0.2, 0.1).normalized());
+  jacobian_t jacobian;
+  for (int row = 0; row < 6; ++row) {
+    for (int col = 0; col < 7; ++col) {
+      jacobian(row, col) = std::cos(0.5 * (row + 1) * (col + 1));
+    }
+  }
+
+  Timing timing;
+  double sum_ns = 0.;
+  for (std::size_t i = 0; i < ITERATIONS; ++i) {
+    const double t = (i % 2000) * dt;
+    cart_vector_t twist;
+    twist << 0.05 * std::sin(2. * M_PI * t), 0.03 * std::cos(2. * M_PI * t), 0.02,
+        0.2 * std::sin(M_PI * t), -0.1, 0.3 * std::cos(M_PI * t);
+
+    const auto start = std::chrono::steady_clock::now();
+    const jnt_vector_t &dq = solve(position, rotation, jacobian, twist);
+    const double ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    sum_ns += ns;
+    timing.max_ns = std::max(timing.max_ns, ns);
+
+    // move the chain tip, so that every solve sees a new pose
+    const cart_vector_t chain_tip_twist = jacobian * dq;
+    position += dt * chain_tip_twist.head<3>();
+    const Eigen::Vector3d angular_velocity = chain_tip_twist.tail<3>();
+    if (angular_velocity.norm() > 0.) {
+      rotation = Eigen::AngleAxisd(dt * angular_velocity.norm(), angular_velocity.normalized()) *
+                 rotation;
+    }
+  }
+  timing.mean_ns = sum_ns / ITERATIONS;
+  return timing;
+}
+} // namespace
+
+int main() {
+  // AdmittanceController, dq = J^T (J J^T + lambda^2 I)^-1 twist
+  const double pinv_damping = 0.05;
+  Eigen::Matrix<double, 6, 6> jjt;
+  Eigen::LDLT<Eigen::Matrix<double, 6, 6>> jjt_ldlt;
+  jnt_vector_t dq;
+  const Timing dls = time_ns([&](const Eigen::Vector3d & /*position*/,
+                                 const Eigen::Matrix3d & /*rotation*/, const jacobian_t &jacobian,
+                                 const cart_vector_t &twist) -> const jnt_vector_t & {
+    jjt.noalias() = jacobian * jacobian.transpose();
+    jjt.diagonal().array() += pinv_damping * pinv_damping;
+    jjt_ldlt.compute(jjt);
+    dq.noalias() = jacobian.transpose() * jjt_ldlt.solve(twist);
+    return dq;
+  });
+
+  // AdmittanceRCMController
+  lbr_ros2_control::RCMSolver rcm_solver(10., pinv_damping);
+  rcm_solver.set_rcm(Eigen::Vector3d(0.4, 0.1, 0.6),
+                     Eigen::AngleAxisd(2.5, Eigen::Vector3d(1., 0.2, 0.1).normalized())
+                         .toRotationMatrix(),
+                     0.2);
+  double max_rcm_error = 0.;
+  const Timing rcm = time_ns([&](const Eigen::Vector3d &position, const Eigen::Matrix3d &rotation,
+                                 const jacobian_t &jacobian,
+                                 const cart_vector_t &twist) -> const jnt_vector_t & {
+    const jnt_vector_t &dq = rcm_solver.solve(position, rotation, jacobian, twist);
+    max_rcm_error = std::max(max_rcm_error, rcm_solver.get_rcm_error());
+    return dq;
+  });
+
+  std::cout << "Joint velocities from a twist, over " << ITERATIONS << " solves:" << std::endl;
+  std::cout << "  damped least-squares: mean " << dls.mean_ns << " ns, max " << dls.max_ns
+            << " ns" << std::endl;
+  std::cout << "  RCMSolver:            mean " << rcm.mean_ns << " ns, max " << rcm.max_ns
+            << " ns, max RCM error " << max_rcm_error << " m" << std::endl;
+  return 0;
+}
@@ -0,0 +1,143 @@
+#ifndef LBR_ROS2_CONTROL__TEST__CONTROLLER_TEST_UTILS_HPP_
+#define LBR_ROS2_CONTROL__TEST__CONTROLLER_TEST_UTILS_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/Geometry"
+#include "hardware_interface/handle.hpp"
+#include "hardware_interface/loaned_command_interface.hpp"
+#include "hardware_interface/loaned_state_interface.hpp"
+
+#include "lbr_ros2_control/system_interface_type_values.hpp"
+
+namespace controller_test_utils {
+using jacobian_t = Eigen::Matrix<double, 6, 7>;
+using jnt_vector_t = Eigen::Matrix<double, 7, 1>;
+using cart_vector_t = Eigen::Matrix<double, 6, 1>;
+
+const std::vector<std::string> JOINT_NAMES = {"A1", "A2", "A3", "A4", "A5", "A6", "A7"};
+const std::vector<std::string> POSE_NAMES = {
+    lbr_ros2_control::HW_IF_POSITION_X,    lbr_ros2_control::HW_IF_POSITION_Y,
+    lbr_ros2_control::HW_IF_POSITION_Z,    lbr_ros2_control::HW_IF_ORIENTATION_X,
+    lbr_ros2_control::HW_IF_ORIENTATION_Y, lbr_ros2_control::HW_IF_ORIENTATION_Z,
+    lbr_ros2_control::HW_IF_ORIENTATION_W};
+
+// prefix and interface name of prefix/interface_name
+inline std::pair<std::string, std::string> split(const std::string &name) {
+  const auto separator = name.find('/');
+  return {name.substr(0, separator), name.substr(separator + 1)};
+}
+
+inline std::string kinematics(const std::string &interface_name) {
+  return std::string(lbr_ros2_control::HW_IF_KINEMATICS_PREFIX) + "/" + interface_name;
+}
+
+// full rank, fixed Jacobian
+inline jacobian_t jacobian() {
+  jacobian_t jacobian;
+  for (int row = 0; row < 6; ++row) {
+    for (int col = 0; col < 7; ++col) {
+      jacobian(row, col) = std::cos(0.5 * (row + 1) * (col + 1));
+    }
+  }
+  return jacobian;
+}
+
+inline jnt_vector_t joint_position() {
+  jnt_vector_t q;
+  q << 0.1, 0.5, -0.2, -1.0, 0.3, 0.8, 0.;
+  return q;
+}
+
+inline Eigen::Vector3d position() { return Eigen::Vector3d(0.4, 0.1, 0.6); }
+
+/**
+ * @brief State and command interfaces as configured by a controller, backed by values that are
+ * read and written by interface name, e.g. A1/position.
+ *
+ */
+class ControllerInterfaces {
+public:
+  // construct the configured interfaces and loan them to the controller, once
+  template <class ControllerT> void assign(ControllerT &controller) {
+    const auto state_names = controller.state_interface_configuration().names;
+    const auto command_names = controller.command_interface_configuration().names;
+    state_values_.assign(state_names.size(), 0.);
+    command_values_.assign(command_names.size(), 0.);
+    for (std::size_t idx = 0; idx < state_names.size(); ++idx) {
+      const auto name = split(state_names[idx]);
+      state_interfaces_.emplace_back(name.first, name.second, &state_values_[idx]);
+      state_indices_[state_names[idx]] = idx;
+    }
+    for (std::size_t idx = 0; idx < command_names.size(); ++idx) {
+      const auto name = split(command_names[idx]);
+      command_interfaces_.emplace_back(name.first, name.second, &command_values_[idx]);
+      command_indices_[command_names[idx]] = idx;
+    }
+    std::vector<hardware_interface::LoanedStateInterface> loaned_state_interfaces;
+    for (auto &state_interface : state_interfaces_) {
+      loaned_state_interfaces.emplace_back(state_interface);
+    }
+    std::vector<hardware_interface::LoanedCommandInterface> loaned_command_interfaces;
+    for (auto &command_interface : command_interfaces_) {
+      loaned_command_interfaces.emplace_back(command_interface);
+    }
+    controller.assign_interfaces(std::move(loaned_command_interfaces),
+                                 std::move(loaned_state_interfaces));
+  }
+
+  double &state(const std::string &name) { return state_values_[state_indices_.at(name)]; }
+  double command(const std::string &name) const {
+    return command_values_[command_indices_.at(name)];
+  }
+
+  // in the order of the controller's configuration
+  std::vector<double> &state_values() { return state_values_; }
+  const std::vector<double> &command_values() const { return command_values_; }
+
+  // joint states of interface_name, e.g. position, of A1 to A7
+  void write_joint_states(const std::string &interface_name, const jnt_vector_t &values) {
+    for (std::size_t idx = 0; idx < JOINT_NAMES.size(); ++idx) {
+      state(JOINT_NAMES[idx] + "/" + interface_name) = values[idx];
+    }
+  }
+
+  jnt_vector_t joint_commands(const std::string &interface_name) const {
+    jnt_vector_t values;
+    for (std::size_t idx = 0; idx < JOINT_NAMES.size(); ++idx) {
+      values[idx] = command(JOINT_NAMES[idx] + "/" + interface_name);
+    }
+    return values;
+  }
+
+  // pose and Jacobian states of the kinematics
+  void write_kinematics(const Eigen::Vector3d &position, const Eigen::Quaterniond &orientation,
+                        const jacobian_t &jacobian) {
+    const std::vector<double> pose = {position.x(),    position.y(),    position.z(),
+                                      orientation.x(), orientation.y(), orientation.z(),
+                                      orientation.w()};
+    for (std::size_t idx = 0; idx < POSE_NAMES.size(); ++idx) {
+      state(kinematics(POSE_NAMES[idx])) = pose[idx];
+    }
+    for (int row = 0; row < 6; ++row) {
+      for (int col = 0; col < 7; ++col) {
+        state(kinematics(std::string(lbr_ros2_control::HW_IF_JACOBIAN_PREFIX) + "_" +
+                         std::to_string(row) + "_" + std::to_string(col))) = jacobian(row, col);
+      }
+    }
+  }
+
+protected:
+  std::vector<double> state_values_, command_values_;
+  std::vector<hardware_interface::StateInterface> state_interfaces_;
+  std::vector<hardware_interface::CommandInterface> command_interfaces_;
+  std::map<std::string, std::size_t> state_indices_, command_indices_;
+};
+} // namespace controller_test_utils
+#endif // LBR_ROS2_CONTROL__TEST__CONTROLLER_TEST_UTILS_HPP_
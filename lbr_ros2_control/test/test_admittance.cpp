@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+#include "lbr_ros2_control/controllers/admittance_controller.hpp"
+
+class TestAdmittance : public ::testing::Test {
+protected:
+  using cart_vector_t = lbr_ros2_control::Admittance::cart_vector_t;
+
+  // mass-damper, no deadband, velocities not limited
+  lbr_ros2_control::AdmittanceParameters mass_damper_() const {
+    lbr_ros2_control::AdmittanceParameters parameters;
+    parameters.threshold.fill(0.);
+    parameters.max_linear_velocity = 1.e3;
+    parameters.max_angular_velocity = 1.e3;
+    return parameters;
+  }
+
+  const double dt_{0.001};
+};
+
+TEST_F(TestAdmittance, TestDeadband) {
+  lbr_ros2_control::AdmittanceParameters parameters = mass_damper_();
+  parameters.threshold = {2., 2., 2., 0.5, 0.5, 0.5};
+  lbr_ros2_control::Admittance admittance(parameters);
+
+  // below the threshold, at rest
+  cart_vector_t f_ext;
+  f_ext << 1.9, -1.9, 0., 0.4, -0.4, 0.;
+  for (int i = 0; i < 100; ++i) {
+    admittance.update(f_ext, dt_);
+  }
+  EXPECT_TRUE(admittance.get_twist().isZero());
+  EXPECT_TRUE(admittance.get_displacement().isZero());
+
+  // above, the excess over the threshold is rendered, with the sign of the force-torque
+  lbr_ros2_control::Admittance reference(mass_damper_());
+  cart_vector_t excess;
+  excess << 1., -1., 0., 0.1, -0.1, 0.;
+  f_ext << 3., -3., 0., 0.6, -0.6, 0.;
+  for (int i = 0; i < 100; ++i) {
+    admittance.update(f_ext, dt_);
+    reference.update(excess, dt_);
+  }
+  EXPECT_TRUE(admittance.get_twist().isApprox(reference.get_twist(), 1.e-12));
+  EXPECT_GT(admittance.get_twist()[0], 0.);
+  EXPECT_LT(admittance.get_twist()[1], 0.);
+}
+
+TEST_F(TestAdmittance, TestVelocityLimits) {
+  lbr_ros2_control::AdmittanceParameters parameters = mass_damper_();
+  parameters.max_linear_velocity = 0.1;
+  parameters.max_angular_velocity = 0.5;
+  lbr_ros2_control::Admittance admittance(parameters);
+
+  // limited in norm, preserving the direction
+  cart_vector_t f_ext;
+  f_ext << 300., 400., 0., 0., 0., 100.;
+  for (int i = 0; i < 1000; ++i) {
+    admittance.update(f_ext, dt_);
+  }
+  const cart_vector_t &twist = admittance.get_twist();
+  EXPECT_NEAR(twist.head<3>().norm(), parameters.max_linear_velocity, 1.e-12);
+  EXPECT_NEAR(twist[1] / twist[0], 4. / 3., 1.e-9);
+  EXPECT_NEAR(twist[2], 0., 1.e-12);
+  EXPECT_NEAR(twist.tail<3>().norm(), parameters.max_angular_velocity, 1.e-12);
+  EXPECT_NEAR(twist[5], parameters.max_angular_velocity, 1.e-12);
+
+  // the displacement integrates the limited twist
+  EXPECT_NEAR(admittance.get_displacement().head<3>().norm(),
+              1000 * dt_ * parameters.max_linear_velocity, 1.e-2);
+}
+
+TEST_F(TestAdmittance, TestStepResponse) {
+  const lbr_ros2_control::AdmittanceParameters parameters = mass_damper_();
+  lbr_ros2_control::Admittance admittance(parameters);
+
+  // M xdd + D xd = f, from rest: xd = f / D (1 - exp(-t / tau)), tau = M / D
+  cart_vector_t f_ext;
+  f_ext << 5., -10., 2., 0.5, -1., 0.2;
+  for (int i = 1; i <= 500; ++i) {
+    admittance.update(f_ext, dt_);
+    const double t = i * dt_;
+    for (int axis = 0; axis < 6; ++axis) {
+      const double tau = parameters.mass[axis] / parameters.damping[axis];
+      const double steady_state = f_ext[axis] / parameters.damping[axis];
+      const double twist = steady_state * (1. - std::exp(-t / tau));
+      const double displacement = steady_state * (t - tau * (1. - std::exp(-t / tau)));
+      EXPECT_NEAR(admittance.get_twist()[axis], twist, 1.e-2 * std::abs(steady_state));
+      EXPECT_NEAR(admittance.get_displacement()[axis], displacement,
+                  1.e-2 * std::abs(steady_state) * t + 1.e-9);
+    }
+  }
+
+  // reset to rest
+  admittance.reset();
+  EXPECT_TRUE(admittance.get_twist().isZero());
+  EXPECT_TRUE(admittance.get_displacement().isZero());
+}
+
+TEST_F(TestAdmittance, TestStiffnessSteadyState) {
+  lbr_ros2_control::AdmittanceParameters parameters = mass_damper_();
+  parameters.stiffness = {1000., 1000., 1000., 100., 100., 100.};
+  lbr_ros2_control::Admittance admittance(parameters);
+
+  // K x = f at rest
+  cart_vector_t f_ext;
+  f_ext << 5., -10., 2., 0.5, -1., 0.2;
+  for (int i = 0; i < 10000; ++i) {
+    admittance.update(f_ext, dt_);
+  }
+  for (int axis = 0; axis < 6; ++axis) {
+    EXPECT_NEAR(admittance.get_displacement()[axis], f_ext[axis] / parameters.stiffness[axis],
+                1.e-6);
+    EXPECT_NEAR(admittance.get_twist()[axis], 0., 1.e-6);
+  }
+}
+
+TEST_F(TestAdmittance, TestInvalidParameters) {
+  lbr_ros2_control::AdmittanceParameters parameters;
+  parameters.mass[0] = 0.;
+  EXPECT_THROW(lbr_ros2_control::Admittance{parameters}, std::runtime_error);
+  parameters = {};
+  parameters.threshold[3] = -1.;
+  EXPECT_THROW(lbr_ros2_control::Admittance{parameters}, std::runtime_error);
+  parameters = {};
+  parameters.max_angular_velocity = 0.;
+  EXPECT_THROW(lbr_ros2_control::Admittance{parameters}, std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
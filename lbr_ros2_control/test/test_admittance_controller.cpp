@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eigen3/Eigen/Cholesky"
+#include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/Geometry"
+#include "hardware_interface/handle.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "lbr_ros2_control/controllers/admittance_controller.hpp"
+#include "lbr_ros2_control/system_interface_type_values.hpp"
+
+#include "controller_test_utils.hpp"
+
+using namespace controller_test_utils;
+
+class TestAdmittanceController : public ::testing::Test {
+protected:
+  void SetUp() override {
+    rclcpp::init(0, nullptr);
+    controller_ = std::make_unique<lbr_ros2_control::AdmittanceController>();
+    ASSERT_EQ(controller_->init("admittance_controller"), controller_interface::return_type::OK);
+    interfaces_.assign(*controller_);
+
+    // no force-torque
+    jacobian_ = jacobian();
+    q_ = joint_position();
+    position_ = position();
+    orientation_ = Eigen::Quaterniond::Identity();
+    write_state_(q_, cart_vector_t::Zero());
+
+    // chained, as by the controller_manager
+    ASSERT_EQ(controller_->configure().label(), "inactive");
+    reference_interfaces_ = controller_->export_reference_interfaces();
+    ASSERT_TRUE(controller_->set_chained_mode(true));
+    ASSERT_EQ(controller_->get_node()->activate().label(), "active");
+  }
+
+  void TearDown() override {
+    controller_->get_node()->deactivate();
+    controller_->release_interfaces();
+    controller_.reset();
+    rclcpp::shutdown();
+  }
+
+  void write_state_(const jnt_vector_t &q, const cart_vector_t &f_ext) {
+    interfaces_.write_joint_states(hardware_interface::HW_IF_POSITION, q);
+    std::size_t idx = 0;
+    for (const auto &ft : {lbr_ros2_control::HW_IF_FORCE_X, lbr_ros2_control::HW_IF_FORCE_Y,
+                           lbr_ros2_control::HW_IF_FORCE_Z, lbr_ros2_control::HW_IF_TORQUE_X,
+                           lbr_ros2_control::HW_IF_TORQUE_Y, lbr_ros2_control::HW_IF_TORQUE_Z}) {
+      interfaces_.state(std::string(lbr_ros2_control::HW_IF_ESTIMATED_FT_PREFIX) + "/" + ft) =
+          f_ext[idx++];
+    }
+    interfaces_.write_kinematics(position_, orientation_, jacobian_);
+  }
+
+  void write_joint_references_(const jnt_vector_t &q) {
+    for (std::size_t idx = 0; idx < JOINT_NAMES.size(); ++idx) {
+      reference_interfaces_[idx].set_value(q[idx]);
+    }
+  }
+
+  void write_pose_references_(const Eigen::Vector3d &position,
+                              const Eigen::Quaterniond &orientation) {
+    const std::vector<double> pose = {position.x(),    position.y(),    position.z(),
+                                      orientation.x(), orientation.y(), orientation.z(),
+                                      orientation.w()};
+    for (std::size_t idx = 0; idx < POSE_NAMES.size(); ++idx) {
+      reference_interfaces_[JOINT_NAMES.size() + idx].set_value(pose[idx]);
+    }
+  }
+
+  void update_() {
+    const rclcpp::Time time(0, 0, RCL_STEADY_TIME);
+    const rclcpp::Duration period = rclcpp::Duration::from_seconds(DT);
+    ASSERT_EQ(controller_->update(time, period), controller_interface::return_type::OK);
+  }
+
+  jnt_vector_t command_() const {
+    return interfaces_.joint_commands(hardware_interface::HW_IF_POSITION);
+  }
+
+  static constexpr double DT = 0.01;
+  static constexpr double MAX_DQ = 0.5 * DT; // default max_joint_velocity
+
+  std::unique_ptr<lbr_ros2_control::AdmittanceController> controller_;
+  ControllerInterfaces interfaces_;
+  std::vector<hardware_interface::CommandInterface> reference_interfaces_;
+
+  jacobian_t jacobian_;
+  jnt_vector_t q_;
+  Eigen::Vector3d position_;
+  Eigen::Quaterniond orientation_;
+};
+
+TEST_F(TestAdmittanceController, TestExportedReferenceInterfaces) {
+  ASSERT_EQ(reference_interfaces_.size(), JOINT_NAMES.size() + POSE_NAMES.size());
+  for (std::size_t idx = 0; idx < JOINT_NAMES.size(); ++idx) {
+    EXPECT_EQ(reference_interfaces_[idx].get_name(),
+              "admittance_controller/" + JOINT_NAMES[idx] + "/" +
+                  hardware_interface::HW_IF_POSITION);
+  }
+  for (std::size_t idx = 0; idx < POSE_NAMES.size(); ++idx) {
+    EXPECT_EQ(reference_interfaces_[JOINT_NAMES.size() + idx].get_name(),
+              "admittance_controller/pose/" + POSE_NAMES[idx]);
+  }
+
+  // unset on activation
+  for (const auto &reference_interface : reference_interfaces_) {
+    EXPECT_TRUE(std::isnan(reference_interface.get_value()));
+  }
+}
+
+TEST_F(TestAdmittanceController, TestUnsetReferencesHold) {
+  // NaN references are unset, the measured joint position is held
+  for (int i = 0; i < 10; ++i) {
+    update_();
+    EXPECT_EQ(command_(), q_);
+  }
+
+  // partially set joint references are unset, as is a partially set pose
+  reference_interfaces_[0].set_value(q_[0] + 0.1);
+  reference_interfaces_[JOINT_NAMES.size()].set_value(position_.x() + 0.1);
+  for (int i = 0; i < 10; ++i) {
+    update_();
+    EXPECT_EQ(command_(), q_);
+  }
+
+  // references reset to NaN hold the nominal joint position reached so far
+  const jnt_vector_t q_reference = q_ + jnt_vector_t::Constant(0.5 * MAX_DQ);
+  write_joint_references_(q_reference);
+  update_();
+  EXPECT_TRUE(command_().isApprox(q_reference, 1.e-12));
+  write_joint_references_(jnt_vector_t::Constant(std::numeric_limits<double>::quiet_NaN()));
+  for (int i = 0; i < 10; ++i) {
+    update_();
+    EXPECT_TRUE(command_().isApprox(q_reference, 1.e-12));
+  }
+}
+
+TEST_F(TestAdmittanceController, TestJointOverPosePrecedence) {
+  // both set, the joint references are followed, the pose reference is ignored
+  const jnt_vector_t q_reference = q_ + jnt_vector_t::Constant(0.5 * MAX_DQ);
+  write_joint_references_(q_reference);
+  write_pose_references_(position_ + Eigen::Vector3d(0.1, 0., 0.), orientation_);
+  update_();
+  EXPECT_TRUE(command_().isApprox(q_reference, 1.e-12));
+
+  // a joint reference unset, the pose reference is tracked, here along +x
+  reference_interfaces_[JOINT_NAMES.size() - 1].set_value(
+      std::numeric_limits<double>::quiet_NaN());
+  write_state_(command_(), cart_vector_t::Zero());
+  const jnt_vector_t q_previous = command_();
+  update_();
+  const cart_vector_t twist = jacobian_ * (command_() - q_previous) / DT;
+  EXPECT_GT(twist[0], 0.01);
+  EXPECT_LT(twist.tail<5>().norm(), 1.e-2 * twist[0]);
+}
+
+TEST_F(TestAdmittanceController, TestRateLimiting) {
+  // a distant joint reference is approached at max_joint_velocity
+  write_joint_references_(q_ + jnt_vector_t::Constant(1.));
+  jnt_vector_t q_previous = q_;
+  for (int i = 0; i < 10; ++i) {
+    update_();
+    EXPECT_TRUE((command_() - q_previous).isApprox(jnt_vector_t::Constant(MAX_DQ), 1.e-12));
+    q_previous = command_();
+  }
+
+  // with an admittance motion alongside, in the same direction per joint, the commanded step is
+  // still limited to max_joint_velocity
+  cart_vector_t f_ext;
+  f_ext << 100., 0., 0., 0., 0., 0.;
+  Eigen::Matrix<double, 6, 6> jjt = jacobian_ * jacobian_.transpose();
+  jjt.diagonal().array() += 0.05 * 0.05; // default pinv_damping
+  const jnt_vector_t dq_admittance = jacobian_.transpose() * jjt.ldlt().solve(f_ext);
+  write_joint_references_(q_previous + 1. * dq_admittance.cwiseSign());
+  write_state_(q_previous, f_ext);
+  for (int i = 0; i < 100; ++i) {
+    update_();
+    const jnt_vector_t step = command_() - q_previous;
+    EXPECT_LE(step.cwiseAbs().maxCoeff(), MAX_DQ * (1. + 1.e-12)) << "update " << i;
+    q_previous = command_();
+  }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
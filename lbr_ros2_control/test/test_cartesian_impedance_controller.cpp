@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/Geometry"
+#include "eigen3/Eigen/LU"
+#include "hardware_interface/handle.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "lbr_ros2_control/controllers/cartesian_impedance_controller.hpp"
+
+#include "controller_test_utils.hpp"
+
+using namespace controller_test_utils;
+
+class TestCartesianImpedanceController : public ::testing::Test {
+protected:
+  void SetUp() override {
+    rclcpp::init(0, nullptr);
+    controller_ = std::make_unique<lbr_ros2_control::CartesianImpedanceController>();
+    ASSERT_EQ(controller_->init("cartesian_impedance_controller"),
+              controller_interface::return_type::OK);
+
+    // nearly undamped inverse, i.e. a nearly exact null-space projection, torques not limited
+    controller_->get_node()->set_parameter(rclcpp::Parameter("pinv_damping", 1.e-4));
+    controller_->get_node()->set_parameter(rclcpp::Parameter("max_torque", 1.e3));
+    interfaces_.assign(*controller_);
+
+    jacobian_ = jacobian();
+    q_ = joint_position();
+    position_ = position();
+    orientation_ = Eigen::AngleAxisd(0.5, Eigen::Vector3d(1., 2., 3.).normalized());
+    write_state_(q_, jnt_vector_t::Zero(), position_, orientation_);
+
+    ASSERT_EQ(controller_->on_configure(rclcpp_lifecycle::State()),
+              controller_interface::CallbackReturn::SUCCESS);
+    ASSERT_EQ(controller_->on_activate(rclcpp_lifecycle::State()),
+              controller_interface::CallbackReturn::SUCCESS);
+
+    // target pose and null-space posture are taken on the first update
+    update_();
+  }
+
+  void TearDown() override {
+    controller_->on_deactivate(rclcpp_lifecycle::State());
+    controller_->release_interfaces();
+    controller_.reset();
+    rclcpp::shutdown();
+  }
+
+  void write_state_(const jnt_vector_t &q, const jnt_vector_t &dq, const Eigen::Vector3d &position,
+                    const Eigen::Quaterniond &orientation) {
+    interfaces_.write_joint_states(hardware_interface::HW_IF_POSITION, q);
+    interfaces_.write_joint_states(hardware_interface::HW_IF_VELOCITY, dq);
+    interfaces_.write_kinematics(position, orientation, jacobian_);
+  }
+
+  void update_() {
+    const rclcpp::Time time(0, 0, RCL_STEADY_TIME);
+    const rclcpp::Duration period(0, 1000000);
+    ASSERT_EQ(controller_->update(time, period), controller_interface::return_type::OK);
+  }
+
+  jnt_vector_t torque_() const {
+    return interfaces_.joint_commands(hardware_interface::HW_IF_EFFORT);
+  }
+
+  std::unique_ptr<lbr_ros2_control::CartesianImpedanceController> controller_;
+  ControllerInterfaces interfaces_;
+
+  jacobian_t jacobian_;
+  jnt_vector_t q_;
+  Eigen::Vector3d position_;
+  Eigen::Quaterniond orientation_;
+};
+
+TEST_F(TestCartesianImpedanceController, TestAtRest) {
+  // at the target pose and posture, no torque
+  EXPECT_LT(torque_().norm(), 1.e-9);
+}
+
+TEST_F(TestCartesianImpedanceController, TestNullspaceTorqueNoTaskWrench) {
+  // away from the posture, at the target pose, the posture torque does not act on the chain tip,
+  // J N tau ~ 0
+  jnt_vector_t q;
+  q << 0.3, 0.2, 0.1, -0.7, 0.6, 0.5, -0.4;
+  write_state_(q, jnt_vector_t::Zero(), position_, orientation_);
+  update_();
+  const jnt_vector_t tau = torque_();
+  EXPECT_GT(tau.norm(), 0.1);
+  EXPECT_LT((jacobian_ * tau).norm(), 1.e-4 * jacobian_.norm() * tau.norm());
+
+  // a null-space velocity, J dq = 0, is damped in the null space only
+  const jnt_vector_t dq = Eigen::FullPivLU<jacobian_t>(jacobian_).kernel().col(0).normalized();
+  write_state_(q_, dq, position_, orientation_);
+  update_();
+  const jnt_vector_t tau_damping = torque_();
+  EXPECT_NEAR(tau_damping.dot(dq), -3., 1.e-6); // default nullspace_damping
+  EXPECT_LT((jacobian_ * tau_damping).norm(), 1.e-4 * jacobian_.norm() * tau_damping.norm());
+}
+
+TEST_F(TestCartesianImpedanceController, TestPoseErrorSign) {
+  // the chain tip is displaced by -1 cm along x and rotated by -0.1 rad about z in the chain root,
+  // the impedance pulls it back, i.e. +x and +z
+  const Eigen::Vector3d position = position_ - Eigen::Vector3d(0.01, 0., 0.);
+  const Eigen::Quaterniond orientation =
+      Eigen::AngleAxisd(-0.1, Eigen::Vector3d::UnitZ()) * orientation_;
+  write_state_(q_, jnt_vector_t::Zero(), position, orientation);
+  update_();
+
+  // default stiffness 500 N/m and 50 Nm/rad
+  cart_vector_t wrench;
+  wrench << 500. * 0.01, 0., 0., 0., 0., 50. * 0.1;
+  const jnt_vector_t expected = jacobian_.transpose() * wrench;
+  const jnt_vector_t tau = torque_();
+  for (int idx = 0; idx < 7; ++idx) {
+    EXPECT_NEAR(tau[idx], expected[idx], 1.e-6);
+  }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
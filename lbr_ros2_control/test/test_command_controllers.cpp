@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "hardware_interface/handle.hpp"
+#include "hardware_interface/loaned_command_interface.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "lbr_fri_idl/msg/lbr_joint_position_command.hpp"
+#include "lbr_fri_idl/msg/lbr_torque_command.hpp"
+#include "lbr_fri_idl/msg/lbr_wrench_command.hpp"
+#include "lbr_ros2_control/controllers/lbr_joint_position_command_controller.hpp"
+#include "lbr_ros2_control/controllers/lbr_torque_command_controller.hpp"
+#include "lbr_ros2_control/controllers/lbr_wrench_command_controller.hpp"
+#include "lbr_ros2_control/system_interface_type_values.hpp"
+
+// count heap allocations of the calling thread only, i.e. not of the middleware's threads
+namespace {
+thread_local bool counting = false;
+thread_local std::size_t allocations = 0;
+thread_local std::size_t deallocations = 0;
+} // namespace
+
+void *operator new(std::size_t size) {
+  if (counting) {
+    ++allocations;
+  }
+  if (void *ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+  if (counting) {
+    ++deallocations;
+  }
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept { operator delete(ptr); }
+
+namespace {
+constexpr std::size_t MESSAGES = 10000;
+
+struct JointPositionCommand {
+  using controller_t = lbr_ros2_control::LBRJointPositionCommandController;
+  using message_t = lbr_fri_idl::msg::LBRJointPositionCommand;
+  static std::string topic() { return "command/joint_position"; }
+  static void fill(message_t &msg, const double &value) { msg.joint_position.fill(value); }
+  static std::vector<std::string> overlay_interfaces() { return {}; }
+};
+
+struct TorqueCommand {
+  using controller_t = lbr_ros2_control::LBRTorqueCommandController;
+  using message_t = lbr_fri_idl::msg::LBRTorqueCommand;
+  static std::string topic() { return "command/torque"; }
+  static void fill(message_t &msg, const double &value) {
+    msg.joint_position.fill(value);
+    msg.torque.fill(value);
+  }
+  static std::vector<std::string> overlay_interfaces() {
+    std::vector<std::string> names;
+    for (const auto &joint_name : {"A1", "A2", "A3", "A4", "A5", "A6", "A7"}) {
+      names.push_back(std::string(joint_name) + "/" + hardware_interface::HW_IF_EFFORT);
+    }
+    return names;
+  }
+};
+
+struct WrenchCommand {
+  using controller_t = lbr_ros2_control::LBRWrenchCommandController;
+  using message_t = lbr_fri_idl::msg::LBRWrenchCommand;
+  static std::string topic() { return "command/wrench"; }
+  static void fill(message_t &msg, const double &value) {
+    msg.joint_position.fill(value);
+    msg.wrench.fill(value);
+  }
+  static std::vector<std::string> overlay_interfaces() {
+    std::vector<std::string> names;
+    for (const auto &ft : {lbr_ros2_control::HW_IF_FORCE_X, lbr_ros2_control::HW_IF_FORCE_Y,
+                           lbr_ros2_control::HW_IF_FORCE_Z, lbr_ros2_control::HW_IF_TORQUE_X,
+                           lbr_ros2_control::HW_IF_TORQUE_Y, lbr_ros2_control::HW_IF_TORQUE_Z}) {
+      names.push_back(std::string(lbr_ros2_control::HW_IF_WRENCH_PREFIX) + "/" + ft);
+    }
+    return names;
+  }
+};
+} // namespace
+
+template <typename CommandT> class TestCommandControllers : public ::testing::Test {
+protected:
+  void SetUp() override {
+    rclcpp::init(0, nullptr);
+
+    // command interfaces, joint positions first
+    std::vector<std::string> names;
+    for (const auto &joint_name : {"A1", "A2", "A3", "A4", "A5", "A6", "A7"}) {
+      names.push_back(std::string(joint_name) + "/" + hardware_interface::HW_IF_POSITION);
+    }
+    for (const auto &name : CommandT::overlay_interfaces()) {
+      names.push_back(name);
+    }
+    values_.assign(names.size(), 0.);
+    for (std::size_t idx = 0; idx < names.size(); ++idx) {
+      const auto separator = names[idx].find('/');
+      command_interfaces_.emplace_back(names[idx].substr(0, separator),
+                                       names[idx].substr(separator + 1), &values_[idx]);
+    }
+    std::vector<hardware_interface::LoanedCommandInterface> loaned_command_interfaces;
+    for (auto &command_interface : command_interfaces_) {
+      loaned_command_interfaces.emplace_back(command_interface);
+    }
+
+    controller_ = std::make_unique<typename CommandT::controller_t>();
+    ASSERT_EQ(controller_->init("controller"), controller_interface::return_type::OK);
+    controller_->assign_interfaces(std::move(loaned_command_interfaces), {});
+    ASSERT_EQ(controller_->on_configure(rclcpp_lifecycle::State()),
+              controller_interface::CallbackReturn::SUCCESS);
+    ASSERT_EQ(controller_->on_activate(rclcpp_lifecycle::State()),
+              controller_interface::CallbackReturn::SUCCESS);
+    executor_.add_node(controller_->get_node()->get_node_base_interface());
+
+    node_ = std::make_shared<rclcpp::Node>("sender");
+    publisher_ = node_->create_publisher<typename CommandT::message_t>(
+        "/controller/" + CommandT::topic(), rclcpp::QoS(1).reliable());
+    while (publisher_->get_subscription_count() == 0) {
+      executor_.spin_some();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  void TearDown() override {
+    executor_.remove_node(controller_->get_node()->get_node_base_interface());
+    controller_->on_deactivate(rclcpp_lifecycle::State());
+    controller_->release_interfaces();
+    controller_.reset();
+    publisher_.reset();
+    node_.reset();
+    rclcpp::shutdown();
+  }
+
+  std::vector<double> values_;
+  std::vector<hardware_interface::CommandInterface> command_interfaces_;
+  std::unique_ptr<typename CommandT::controller_t> controller_;
+  rclcpp::executors::SingleThreadedExecutor executor_;
+  rclcpp::Node::SharedPtr node_;
+  typename rclcpp::Publisher<typename CommandT::message_t>::SharedPtr publisher_;
+};
+
+using CommandTypes = ::testing::Types<JointPositionCommand, TorqueCommand, WrenchCommand>;
+TYPED_TEST_SUITE(TestCommandControllers, CommandTypes);
+
+TYPED_TEST(TestCommandControllers, update_does_not_allocate) {
+  const rclcpp::Time time(0, 0, RCL_STEADY_TIME);
+  const rclcpp::Duration period(0, 1000000);
+  typename TypeParam::message_t msg;
+  std::size_t received = 0, update_allocations = 0, update_deallocations = 0;
+  for (std::size_t i = 1; i <= MESSAGES; ++i) {
+    TypeParam::fill(msg, static_cast<double>(i));
+    this->publisher_->publish(msg);
+
+    // update until the command is applied, or time out
+    for (std::size_t attempt = 0; attempt < 100; ++attempt) {
+      this->executor_.spin_some(std::chrono::milliseconds(1));
+      allocations = 0;
+      deallocations = 0;
+      counting = true;
+      this->controller_->update(time, period);
+      counting = false;
+      update_allocations += allocations;
+      update_deallocations += deallocations;
+      if (this->values_.front() == static_cast<double>(i)) {
+        ++received;
+        break;
+      }
+    }
+  }
+  EXPECT_GT(received, MESSAGES * 9 / 10);
+  EXPECT_EQ(update_allocations, 0u);
+  EXPECT_EQ(update_deallocations, 0u);
+  for (const auto &value : this->values_) {
+    EXPECT_EQ(value, this->values_.front());
+  }
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "lbr_ros2_control/controllers/joint_impedance_controller.hpp"
+
+#include "controller_test_utils.hpp"
+
+using namespace controller_test_utils;
+
+namespace {
+constexpr std::size_t N = 7;
+const std::vector<double> STIFFNESS = {200., 200., 200., 200., 100., 50., 20.};
+
+double smoothstep(const double &x) { return x * x * (3. - 2. * x); }
+} // namespace
+
+class TestJointImpedanceController : public ::testing::Test {
+protected:
+  void SetUp() override {
+    rclcpp::init(0, nullptr);
+    controller_ = std::make_unique<lbr_ros2_control::JointImpedanceController>();
+    ASSERT_EQ(controller_->init("joint_impedance_controller"),
+              controller_interface::return_type::OK);
+
+    // joint position and velocity states, joint position and torque commands
+    interfaces_.assign(*controller_);
+  }
+
+  void TearDown() override {
+    controller_->on_deactivate(rclcpp_lifecycle::State());
+    controller_->release_interfaces();
+    controller_.reset();
+    rclcpp::shutdown();
+  }
+
+  void activate_() {
+    ASSERT_EQ(controller_->on_configure(rclcpp_lifecycle::State()),
+              controller_interface::CallbackReturn::SUCCESS);
+    ASSERT_EQ(controller_->on_activate(rclcpp_lifecycle::State()),
+              controller_interface::CallbackReturn::SUCCESS);
+
+    // the setpoint is the joint position on the first update, then displace every joint
+    update_();
+    interfaces_.write_joint_states(hardware_interface::HW_IF_POSITION,
+                                   jnt_vector_t::Constant(-DISPLACEMENT));
+  }
+
+  void update_() {
+    const rclcpp::Time time(0, 0, RCL_STEADY_TIME);
+    const rclcpp::Duration period = rclcpp::Duration::from_seconds(DT);
+    ASSERT_EQ(controller_->update(time, period), controller_interface::return_type::OK);
+  }
+
+  // effective stiffness from the commanded torque, K (q_d - q) at rest
+  double stiffness_(const std::size_t &idx) const {
+    return interfaces_.command(JOINT_NAMES[idx] + "/" + hardware_interface::HW_IF_EFFORT) /
+           DISPLACEMENT;
+  }
+
+  bool set_(const std::string &name, const std::vector<double> &values) {
+    return controller_->get_node()->set_parameter(rclcpp::Parameter(name, values)).successful;
+  }
+
+  static constexpr double DT = 0.1;            // 10 updates per gain_ramp_time of 1 s
+  static constexpr double DISPLACEMENT = 0.01; // torques well below max_torque
+
+  std::unique_ptr<lbr_ros2_control::JointImpedanceController> controller_;
+  ControllerInterfaces interfaces_;
+};
+
+TEST_F(TestJointImpedanceController, TestGainValidation) {
+  EXPECT_FALSE(set_("stiffness", {100., 100., 100.}));
+  EXPECT_FALSE(set_("stiffness", {100., 100., 100., 100., 100., 100., -1.}));
+  EXPECT_FALSE(set_("damping", {10., 10., 10., 10., 10., 10.,
+                                std::numeric_limits<double>::quiet_NaN()}));
+  EXPECT_FALSE(set_("damping", {10., 10., 10., 10., 10., 10.,
+                                std::numeric_limits<double>::infinity()}));
+  EXPECT_TRUE(set_("stiffness", {100., 100., 100., 100., 100., 100., 0.}));
+  EXPECT_TRUE(set_("damping", {10., 10., 10., 10., 10., 10., 10.}));
+
+  // rejected gains are not applied
+  activate_();
+  update_();
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    EXPECT_NEAR(stiffness_(idx), idx < N - 1 ? 100. : 0., 1.e-9);
+  }
+}
+
+TEST_F(TestJointImpedanceController, TestGainRampSmoothstep) {
+  activate_();
+  update_();
+  for (std::size_t idx = 0; idx < N; ++idx) {
+    EXPECT_NEAR(stiffness_(idx), STIFFNESS[idx], 1.e-9);
+  }
+
+  // ramped over gain_ramp_time along a smoothstep, then held
+  std::vector<double> stiffness = STIFFNESS;
+  stiffness[0] = 400.;
+  ASSERT_TRUE(set_("stiffness", stiffness));
+  for (int step = 1; step <= 12; ++step) {
+    update_();
+    const double progress = std::min(step * DT, 1.);
+    EXPECT_NEAR(stiffness_(0), 200. + 200. * smoothstep(progress), 1.e-6) << "step " << step;
+    EXPECT_NEAR(stiffness_(1), STIFFNESS[1], 1.e-6);
+  }
+}
+
+TEST_F(TestJointImpedanceController, TestGainRampRestart) {
+  activate_();
+  update_();
+
+  std::vector<double> stiffness = STIFFNESS;
+  stiffness[0] = 400.;
+  ASSERT_TRUE(set_("stiffness", stiffness));
+  for (int step = 1; step <= 5; ++step) {
+    update_();
+  }
+  const double mid_ramp = 200. + 200. * smoothstep(0.5);
+  ASSERT_NEAR(stiffness_(0), mid_ramp, 1.e-6);
+
+  // a new target mid-ramp restarts the ramp from the current gains, without a step
+  stiffness[0] = 100.;
+  ASSERT_TRUE(set_("stiffness", stiffness));
+  for (int step = 1; step <= 10; ++step) {
+    update_();
+    EXPECT_NEAR(stiffness_(0), mid_ramp + (100. - mid_ramp) * smoothstep(step * DT), 1.e-6)
+        << "step " << step;
+  }
+  update_();
+  EXPECT_NEAR(stiffness_(0), 100., 1.e-6);
+}
+
+TEST_F(TestJointImpedanceController, TestRobotDescriptionTimeout) {
+  // neither set nor published, configuration fails after the timeout
+  controller_->get_node()->set_parameter(rclcpp::Parameter("gravity_compensation", true));
+  controller_->get_node()->set_parameter(rclcpp::Parameter("robot_description_timeout", 0.1));
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(controller_->on_configure(rclcpp_lifecycle::State()),
+            controller_interface::CallbackReturn::ERROR);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_GE(elapsed, std::chrono::milliseconds(100));
+  EXPECT_LT(elapsed, std::chrono::seconds(2));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
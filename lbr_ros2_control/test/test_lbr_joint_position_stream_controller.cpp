@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "trajectory_msgs/msg/joint_trajectory.hpp"
+
+#include "lbr_ros2_control/controllers/lbr_joint_position_stream_controller.hpp"
+
+#include "controller_test_utils.hpp"
+
+using namespace controller_test_utils;
+
+namespace {
+constexpr int64_t MS = 1000000; // [ns]
+
+// drives the stream as the update thread, without interfaces
+class StreamController : public lbr_ros2_control::LBRJointPositionStreamController {
+public:
+  StreamController() {
+    setpoint_ring_.reset(16);
+    q_command_.fill(0.);
+    q_target_ = q_command_;
+  }
+
+  bool push(const int64_t &time_ns, const double &joint_position) {
+    Setpoint setpoint;
+    setpoint.time_ns = time_ns;
+    setpoint.joint_position.fill(joint_position);
+    return setpoint_ring_.push(setpoint);
+  }
+
+  void queue(const trajectory_msgs::msg::JointTrajectory &joint_trajectory) {
+    queue_setpoints_(joint_trajectory);
+  }
+  void set_command(const double &joint_position) { q_command_.fill(joint_position); }
+  void advance(const int64_t &time_ns) { advance_(time_ns); }
+  double target() const { return q_target_[0]; }
+  uint64_t underruns() const { return underruns_; }
+  uint64_t late_setpoints() const { return late_setpoints_; }
+};
+} // namespace
+
+class TestLBRJointPositionStreamController : public ::testing::Test {
+protected:
+  // a chunk at 10 and 20 ms, executed to the end
+  void drain_() {
+    controller_.push(10 * MS, 1.);
+    controller_.push(20 * MS, 2.);
+    for (int64_t time = 0; time <= 20; ++time) {
+      controller_.advance(time * MS);
+    }
+    controller_.set_command(2.);
+  }
+
+  StreamController controller_;
+};
+
+TEST_F(TestLBRJointPositionStreamController, TestInterpolation) {
+  controller_.push(10 * MS, 1.);
+  controller_.push(20 * MS, 2.);
+
+  // starts from the current command
+  controller_.advance(0);
+  EXPECT_DOUBLE_EQ(controller_.target(), 0.);
+  controller_.advance(5 * MS);
+  EXPECT_DOUBLE_EQ(controller_.target(), 0.5);
+  controller_.advance(15 * MS);
+  EXPECT_DOUBLE_EQ(controller_.target(), 1.5);
+
+  // the last setpoint is held
+  controller_.advance(20 * MS);
+  EXPECT_DOUBLE_EQ(controller_.target(), 2.);
+  controller_.advance(30 * MS);
+  EXPECT_DOUBLE_EQ(controller_.target(), 2.);
+  EXPECT_EQ(controller_.underruns(), 0u);
+  EXPECT_EQ(controller_.late_setpoints(), 0u);
+}
+
+TEST_F(TestLBRJointPositionStreamController, TestFinished) {
+  drain_();
+
+  // a new stream of future setpoints after the previous finished is no underrun
+  controller_.advance(30 * MS);
+  controller_.push(40 * MS, 3.);
+  controller_.advance(30 * MS);
+  EXPECT_DOUBLE_EQ(controller_.target(), 2.);
+  controller_.advance(35 * MS);
+  EXPECT_DOUBLE_EQ(controller_.target(), 2.5);
+  EXPECT_EQ(controller_.underruns(), 0u);
+  EXPECT_EQ(controller_.late_setpoints(), 0u);
+}
+
+TEST_F(TestLBRJointPositionStreamController, TestUnderrun) {
+  drain_();
+
+  // the stream continues behind the clock, one underrun per gap
+  controller_.push(25 * MS, 2.5);
+  controller_.push(28 * MS, 2.8);
+  controller_.push(40 * MS, 4.);
+  controller_.advance(30 * MS);
+  EXPECT_EQ(controller_.underruns(), 1u);
+  EXPECT_EQ(controller_.late_setpoints(), 2u);
+
+  // restarts from the current command with the next future setpoint
+  EXPECT_DOUBLE_EQ(controller_.target(), 2.);
+  controller_.advance(35 * MS);
+  EXPECT_DOUBLE_EQ(controller_.target(), 3.);
+  controller_.advance(40 * MS);
+  EXPECT_DOUBLE_EQ(controller_.target(), 4.);
+  EXPECT_EQ(controller_.underruns(), 1u);
+}
+
+TEST_F(TestLBRJointPositionStreamController, TestLateBeforeStreaming) {
+  // setpoints already due before any stream started are dropped, no underrun
+  controller_.push(5 * MS, 1.);
+  controller_.push(20 * MS, 2.);
+  controller_.advance(10 * MS);
+  EXPECT_EQ(controller_.late_setpoints(), 1u);
+  EXPECT_EQ(controller_.underruns(), 0u);
+  EXPECT_DOUBLE_EQ(controller_.target(), 0.);
+  controller_.advance(15 * MS);
+  EXPECT_DOUBLE_EQ(controller_.target(), 1.);
+}
+
+// drives update() with the ROS time, as by the controller_manager
+class TestLBRJointPositionStreamControllerUpdate : public ::testing::Test {
+protected:
+  void SetUp() override {
+    rclcpp::init(0, nullptr);
+    controller_ = std::make_unique<StreamController>();
+    ASSERT_EQ(controller_->init("lbr_joint_position_stream_controller"),
+              controller_interface::return_type::OK);
+
+    // interfaces as configured by the controller, at rest in zero
+    interfaces_.assign(*controller_);
+
+    ASSERT_EQ(controller_->configure().label(), "inactive");
+    ASSERT_EQ(controller_->get_node()->activate().label(), "active");
+    start_ = controller_->get_node()->now();
+  }
+
+  void TearDown() override {
+    controller_->get_node()->deactivate();
+    controller_->release_interfaces();
+    controller_.reset();
+    rclcpp::shutdown();
+  }
+
+  // a chunk of setpoints at time_from_start, equal for all joints
+  trajectory_msgs::msg::JointTrajectory
+  chunk_(const std::vector<std::pair<int64_t, double>> &setpoints) const {
+    trajectory_msgs::msg::JointTrajectory joint_trajectory;
+    for (const auto &setpoint : setpoints) {
+      trajectory_msgs::msg::JointTrajectoryPoint point;
+      point.positions.assign(JOINT_NAMES.size(), setpoint.second);
+      point.time_from_start = rclcpp::Duration::from_nanoseconds(setpoint.first);
+      joint_trajectory.points.push_back(point);
+    }
+    return joint_trajectory;
+  }
+
+  // the controller_manager's time, i.e. the ROS time, cycle cycles after start_
+  void update_(const int64_t &cycle) {
+    const rclcpp::Time time = start_ + rclcpp::Duration::from_nanoseconds(cycle * DT);
+    ASSERT_EQ(controller_->update(time, rclcpp::Duration::from_nanoseconds(DT)),
+              controller_interface::return_type::OK);
+    for (const auto &command_value : interfaces_.command_values()) {
+      ASSERT_TRUE(std::isfinite(command_value));
+    }
+  }
+
+  static constexpr int64_t DT = 10 * MS;
+
+  std::unique_ptr<StreamController> controller_;
+  ControllerInterfaces interfaces_;
+  rclcpp::Time start_;
+};
+
+TEST_F(TestLBRJointPositionStreamControllerUpdate, TestUnstamped) {
+  // stamped on reception with the node clock, tracked against the ROS time
+  controller_->queue(chunk_({{100 * MS, 0.05}, {200 * MS, 0.1}}));
+  for (int64_t cycle = 0; cycle <= 5; ++cycle) {
+    update_(cycle);
+  }
+  for (const auto &command_value : interfaces_.command_values()) {
+    EXPECT_NEAR(command_value, 0.025, 1.e-3);
+  }
+  for (int64_t cycle = 6; cycle <= 25; ++cycle) {
+    update_(cycle);
+  }
+  for (const auto &command_value : interfaces_.command_values()) {
+    EXPECT_DOUBLE_EQ(command_value, 0.1);
+  }
+  EXPECT_EQ(controller_->late_setpoints(), 0u);
+}
+
+TEST_F(TestLBRJointPositionStreamControllerUpdate, TestNonFinite) {
+  // the non-finite setpoint is dropped, its neighbours are interpolated
+  auto joint_trajectory = chunk_({{100 * MS, 0.05}, {150 * MS, 0.}, {200 * MS, 0.1}});
+  joint_trajectory.header.stamp = start_;
+  joint_trajectory.points[1].positions[3] = std::numeric_limits<double>::quiet_NaN();
+  controller_->queue(joint_trajectory);
+  for (int64_t cycle = 0; cycle <= 15; ++cycle) {
+    update_(cycle);
+  }
+  for (const auto &command_value : interfaces_.command_values()) {
+    EXPECT_NEAR(command_value, 0.075, 1.e-9);
+  }
+
+  // a chunk of non-finite setpoints only, the last setpoint is held
+  joint_trajectory = chunk_({{300 * MS, std::numeric_limits<double>::infinity()},
+                             {400 * MS, std::numeric_limits<double>::quiet_NaN()}});
+  joint_trajectory.header.stamp = start_;
+  controller_->queue(joint_trajectory);
+  for (int64_t cycle = 16; cycle <= 50; ++cycle) {
+    update_(cycle);
+  }
+  for (const auto &command_value : interfaces_.command_values()) {
+    EXPECT_DOUBLE_EQ(command_value, 0.1);
+  }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
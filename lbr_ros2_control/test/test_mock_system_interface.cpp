@@ -0,0 +1,297 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "hardware_interface/types/hardware_interface_return_values.hpp"
+#include "kdl/chaindynparam.hpp"
+#include "kdl/jntarray.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "friClientVersion.h"
+#include "friLBRClient.h"
+
+#include "lbr_fri_idl/msg/lbr_command.hpp"
+#include "lbr_fri_idl/msg/lbr_state.hpp"
+#include "lbr_fri_ros2/dynamics_simulator.hpp"
+#include "lbr_fri_ros2/kinematics_cache.hpp"
+#include "lbr_fri_ros2/payload_identifier.hpp"
+#include "lbr_ros2_control/mock_system_interface.hpp"
+#include "lbr_ros2_control/sim_system_interface.hpp"
+
+namespace {
+using jnt_array_t = lbr_fri_idl::msg::LBRState::_measured_joint_position_type;
+
+std::string robot_description() {
+  // simplified 7 DoF serial chain with alternating joint axes and link inertias, similar to the
+  // LBR
+  const double offsets[] = {0.1575, 0.2025, 0.2045, 0.2155, 0.1845, 0.2155, 0.081, 0.045};
+  const double masses[] = {4., 4., 3., 2.7, 1.7, 1.8, 0.3};
+  const char *axes[] = {"0 0 1", "0 1 0", "0 0 1", "0 -1 0", "0 0 1", "0 1 0", "0 0 1"};
+  std::string urdf = "<?xml version=\"1.0\"?><robot name=\"lbr\">";
+  urdf += "<link name=\"link_0\"/>";
+  for (int i = 1; i <= 7; ++i) {
+    urdf += "<link name=\"link_" + std::to_string(i) + "\"><inertial>";
+    urdf += "<origin xyz=\"0 0.01 0.1\" rpy=\"0 0 0\"/>";
+    urdf += "<mass value=\"" + std::to_string(masses[i - 1]) + "\"/>";
+    urdf += "<inertia ixx=\"0.05\" ixy=\"0\" ixz=\"0\" iyy=\"0.05\" iyz=\"0\" izz=\"0.01\"/>";
+    urdf += "</inertial></link>";
+  }
+  urdf += "<link name=\"link_ee\"/>";
+  for (int i = 0; i < 7; ++i) {
+    urdf += "<joint name=\"A" + std::to_string(i + 1) + "\" type=\"revolute\">";
+    urdf += "<parent link=\"link_" + std::to_string(i) + "\"/>";
+    urdf += "<child link=\"link_" + std::to_string(i + 1) + "\"/>";
+    urdf += "<origin xyz=\"0 0 " + std::to_string(offsets[i]) + "\" rpy=\"0 0 0\"/>";
+    urdf += "<axis xyz=\"" + std::string(axes[i]) + "\"/>";
+    urdf += "<limit lower=\"-2.9\" upper=\"2.9\" effort=\"300\" velocity=\"10\"/>";
+    urdf += "</joint>";
+  }
+  urdf += "<joint name=\"joint_ee\" type=\"fixed\"><parent link=\"link_7\"/>"
+          "<child link=\"link_ee\"/><origin xyz=\"0 0 " +
+          std::to_string(offsets[7]) + "\" rpy=\"0 0 0\"/></joint>";
+  urdf += "</robot>";
+  return urdf;
+}
+
+// steps the emulated robot side in place of the emulation thread
+template <typename EmulatedSystemInterface> class EmulatedRobot : public EmulatedSystemInterface {
+public:
+  void configure(const KUKA::FRI::EClientCommandMode &client_command_mode,
+                 const jnt_array_t &initial_joint_position, const jnt_array_t &external_torque) {
+    this->parameters_.client_command_mode = client_command_mode;
+    this->mock_parameters_.session_transition_cycles = 1;
+    this->mock_parameters_.initial_joint_position = initial_joint_position;
+    this->mock_parameters_.external_torque = external_torque;
+    this->reset_();
+  }
+
+  void command(const lbr_fri_idl::msg::LBRCommand &command) {
+    this->buffer_command_target_(command);
+  }
+
+  void step(const std::size_t &cycles = 1) {
+    for (std::size_t i = 0; i < cycles; ++i) {
+      this->step_();
+    }
+  }
+
+  const lbr_fri_idl::msg::LBRState &state() const { return this->state_; }
+};
+
+class MockRobot : public EmulatedRobot<lbr_ros2_control::MockSystemInterface> {
+public:
+  // rigid and gravity compensated
+  jnt_array_t gravity(const jnt_array_t &) const {
+    jnt_array_t gravity;
+    gravity.fill(0.);
+    return gravity;
+  }
+};
+
+// reads the emulated states as the controller_manager would, kinematics enabled as shipped
+class PayloadIdentifyingMockRobot : public MockRobot {
+public:
+  void identify_payload() {
+    this->kinematics_cache_ptr_ =
+        std::make_shared<lbr_fri_ros2::KinematicsCache>(robot_description());
+    this->kinematics_enabled_ = true;
+    this->ft_parameters_.enabled = false;
+    this->payload_identifier_ptr_ =
+        std::make_unique<lbr_fri_ros2::PayloadIdentifier>(this->kinematics_cache_ptr_);
+    this->hw_ft_frame_command_ = std::numeric_limits<double>::quiet_NaN();
+    this->hw_velocity_.fill(0.);
+    this->nan_last_hw_states_();
+  }
+
+  std::size_t payload_samples() const {
+    return this->payload_identifier_ptr_->get_number_of_samples();
+  }
+};
+
+class SimRobot : public EmulatedRobot<lbr_ros2_control::SimSystemInterface> {
+public:
+  SimRobot() : kinematics_cache_(robot_description()) {
+    simulator_ptr_ = std::make_unique<lbr_fri_ros2::DynamicsSimulator>(
+        kinematics_cache_.get_chain(), lbr_fri_ros2::DynamicsSimulatorParameters{});
+  }
+
+  jnt_array_t gravity(const jnt_array_t &q) const {
+    KDL::ChainDynParam dyn_param(kinematics_cache_.get_chain(), KDL::Vector(0., 0., -9.81));
+    KDL::JntArray q_kdl(q.size()), gravity_kdl(q.size());
+    for (std::size_t i = 0; i < q.size(); ++i) {
+      q_kdl(i) = q[i];
+    }
+    dyn_param.JntToGravity(q_kdl, gravity_kdl);
+    jnt_array_t gravity;
+    for (std::size_t i = 0; i < q.size(); ++i) {
+      gravity[i] = gravity_kdl(i);
+    }
+    return gravity;
+  }
+
+protected:
+  lbr_fri_ros2::KinematicsCache kinematics_cache_;
+};
+
+#if FRI_CLIENT_VERSION_MAJOR == 1
+constexpr KUKA::FRI::EClientCommandMode POSITION_MODE = KUKA::FRI::EClientCommandMode::POSITION;
+#endif
+#if FRI_CLIENT_VERSION_MAJOR >= 2
+constexpr KUKA::FRI::EClientCommandMode POSITION_MODE =
+    KUKA::FRI::EClientCommandMode::JOINT_POSITION;
+#endif
+} // namespace
+
+template <typename Robot> class TestEmulatedTorques : public ::testing::Test {
+protected:
+  Robot robot_;
+};
+
+using EmulatedRobots = ::testing::Types<MockRobot, SimRobot>;
+TYPED_TEST_SUITE(TestEmulatedTorques, EmulatedRobots);
+
+TYPED_TEST(TestEmulatedTorques, TestFRITorqueConvention) {
+  // as by the FRI, the measured torque is the model torque plus the external torque, and the
+  // injected external torque is what gets reported
+  const jnt_array_t q = {0.3, 0.8, -0.2, -1.2, 0.1, 0.6, 0.};
+  const jnt_array_t external_torque = {0., -3., 0., 5., 0., 0., 1.};
+  this->robot_.configure(POSITION_MODE, q, external_torque);
+  this->robot_.step(1000); // settle
+  const auto &state = this->robot_.state();
+  ASSERT_EQ(state.session_state,
+            static_cast<int8_t>(KUKA::FRI::ESessionState::COMMANDING_ACTIVE));
+  const jnt_array_t gravity = this->robot_.gravity(state.measured_joint_position);
+  for (std::size_t i = 0; i < external_torque.size(); ++i) {
+    EXPECT_NEAR(state.external_torque[i], external_torque[i], 1.e-3);
+    EXPECT_NEAR(state.measured_torque[i] - gravity[i], state.external_torque[i], 1.e-3);
+  }
+}
+
+class TestMockSystemInterface : public ::testing::Test {
+public:
+  TestMockSystemInterface() {
+    q_ = {0.3, 0.8, -0.2, -1.2, 0.1, 0.6, 0.};
+    external_torque_ = {0.5, -1., 0., 2., 0., 0., -0.25};
+    command_.joint_position.fill(std::numeric_limits<double>::quiet_NaN());
+    command_.torque.fill(std::numeric_limits<double>::quiet_NaN());
+    command_.wrench.fill(std::numeric_limits<double>::quiet_NaN());
+  }
+
+protected:
+  // steps until commanding, the emulated robot passes one session state per cycle
+  void start_(const KUKA::FRI::EClientCommandMode &client_command_mode) {
+    robot_.configure(client_command_mode, q_, external_torque_);
+    robot_.step(4);
+    ASSERT_EQ(robot_.state().session_state,
+              static_cast<int8_t>(KUKA::FRI::ESessionState::COMMANDING_ACTIVE));
+  }
+
+  MockRobot robot_;
+  jnt_array_t q_, external_torque_;
+  lbr_fri_idl::msg::LBRCommand command_;
+};
+
+TEST_F(TestMockSystemInterface, TestPositionMode) {
+  start_(POSITION_MODE);
+  for (std::size_t i = 0; i < q_.size(); ++i) {
+    command_.joint_position[i] = q_[i] + 0.1;
+  }
+  command_.torque.fill(1.); // ignored
+  robot_.command(command_);
+
+  // the IPO joint position lags the command by ipo_lag_cycles, the measured joint position
+  // tracks the IPO joint position
+  for (uint32_t cycle = 0; cycle <= 2; ++cycle) {
+    robot_.step();
+    const auto &state = robot_.state();
+    for (std::size_t i = 0; i < q_.size(); ++i) {
+      EXPECT_DOUBLE_EQ(state.ipo_joint_position[i], cycle < 2 ? q_[i] : q_[i] + 0.1);
+      EXPECT_DOUBLE_EQ(state.measured_joint_position[i], state.ipo_joint_position[i]);
+      EXPECT_EQ(state.commanded_torque[i], 0.);
+      EXPECT_DOUBLE_EQ(state.measured_torque[i], external_torque_[i]);
+      EXPECT_EQ(state.external_torque[i], external_torque_[i]);
+    }
+  }
+}
+
+TEST_F(TestMockSystemInterface, TestTorqueMode) {
+  start_(KUKA::FRI::EClientCommandMode::TORQUE);
+  command_.joint_position = q_;
+  command_.torque = {1., 2., 3., 4., 5., 6., 7.};
+  command_.torque[6] = std::numeric_limits<double>::quiet_NaN(); // unset, no torque
+  robot_.command(command_);
+  robot_.step(3);
+
+  // measured torque is the commanded plus the external torque
+  const auto &state = robot_.state();
+  for (std::size_t i = 0; i < q_.size(); ++i) {
+    const double commanded_torque = i < 6 ? command_.torque[i] : 0.;
+    EXPECT_DOUBLE_EQ(state.measured_joint_position[i], q_[i]);
+    EXPECT_EQ(state.commanded_torque[i], commanded_torque);
+    EXPECT_DOUBLE_EQ(state.measured_torque[i], commanded_torque + external_torque_[i]);
+    EXPECT_EQ(state.external_torque[i], external_torque_[i]);
+  }
+  EXPECT_EQ(state.control_mode,
+            static_cast<int8_t>(KUKA::FRI::EControlMode::JOINT_IMP_CONTROL_MODE));
+}
+
+TEST_F(TestMockSystemInterface, TestWrenchMode) {
+  start_(KUKA::FRI::EClientCommandMode::WRENCH);
+  command_.joint_position = q_;
+  command_.joint_position[3] += 0.2;
+  command_.wrench = {1., 2., 3., 0.1, 0.2, 0.3};
+  command_.torque.fill(1.); // ignored
+  robot_.command(command_);
+  robot_.step(3);
+
+  // the rigid mock is not moved by the wrench, only the external torque is measured
+  const auto &state = robot_.state();
+  for (std::size_t i = 0; i < q_.size(); ++i) {
+    EXPECT_DOUBLE_EQ(state.measured_joint_position[i], command_.joint_position[i]);
+    EXPECT_EQ(state.commanded_torque[i], 0.);
+    EXPECT_DOUBLE_EQ(state.measured_torque[i], external_torque_[i]);
+  }
+  EXPECT_EQ(state.control_mode,
+            static_cast<int8_t>(KUKA::FRI::EControlMode::CART_IMP_CONTROL_MODE));
+}
+
+TEST_F(TestMockSystemInterface, TestNoCommandBeforeCommanding) {
+  robot_.configure(KUKA::FRI::EClientCommandMode::TORQUE, q_, external_torque_);
+  command_.joint_position[0] = q_[0] + 0.5;
+  command_.torque.fill(1.);
+  robot_.command(command_);
+  robot_.step(3); // COMMANDING_WAIT
+
+  // commands are only applied while commanding
+  const auto &state = robot_.state();
+  EXPECT_DOUBLE_EQ(state.measured_joint_position[0], q_[0]);
+  for (std::size_t i = 0; i < q_.size(); ++i) {
+    EXPECT_EQ(state.commanded_torque[i], 0.);
+    EXPECT_DOUBLE_EQ(state.measured_torque[i], external_torque_[i]);
+  }
+}
+
+TEST_F(TestMockSystemInterface, TestPayloadSamplesWithKinematics) {
+  // the kinematics are updated for each state before the payload is sampled
+  PayloadIdentifyingMockRobot robot;
+  robot.configure(POSITION_MODE, q_, external_torque_);
+  robot.identify_payload();
+  const rclcpp::Time time(0, 0, RCL_STEADY_TIME);
+  const rclcpp::Duration period = rclcpp::Duration::from_seconds(0.005);
+  for (std::size_t cycle = 1; cycle <= 10; ++cycle) {
+    robot.step();
+    ASSERT_EQ(robot.read(time, period), hardware_interface::return_type::OK);
+    EXPECT_EQ(robot.payload_samples(), cycle);
+
+    // one sample per state
+    ASSERT_EQ(robot.read(time, period), hardware_interface::return_type::OK);
+    EXPECT_EQ(robot.payload_samples(), cycle);
+  }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
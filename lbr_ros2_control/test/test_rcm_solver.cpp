@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+#include "eigen3/Eigen/Core"
+#include "eigen3/Eigen/Geometry"
+
+#include "lbr_ros2_control/controllers/admittance_rcm_controller.hpp"
+
+class TestRCMSolver : public ::testing::Test {
+protected:
+  using cart_vector_t = lbr_ros2_control::RCMSolver::cart_vector_t;
+  using jnt_vector_t = lbr_ros2_control::RCMSolver::jnt_vector_t;
+  using jacobian_t = lbr_ros2_control::RCMSolver::jacobian_t;
+
+  void SetUp() override {
+    // full rank, fixed Jacobian and an arbitrary chain tip pose
+    for (int row = 0; row < 6; ++row) {
+      for (int col = 0; col < 7; ++col) {
+        jacobian_(row, col) = std::cos(0.5 * (row + 1) * (col + 1));
+      }
+    }
+    position_ << 0.4, 0.1, 0.6;
+    rotation_ = Eigen::AngleAxisd(2.5, Eigen::Vector3d(1., 0.2, 0.1).normalized());
+  }
+
+  // velocity of the shaft point closest to the RCM, perpendicular to the shaft, i.e. A dq
+  Eigen::Vector2d shaft_velocity_(const lbr_ros2_control::RCMSolver &rcm_solver,
+                                  const Eigen::Vector3d &position, const Eigen::Matrix3d &rotation,
+                                  const jacobian_t &jacobian, const jnt_vector_t &dq) const {
+    const Eigen::Vector3d shaft = rotation.col(2);
+    const double alpha = shaft.dot(rcm_solver.get_rcm() - position);
+    const cart_vector_t twist = jacobian * dq;
+    const Eigen::Vector3d velocity = twist.head<3>() + twist.tail<3>().cross(alpha * shaft);
+    return {rotation.col(0).dot(velocity), rotation.col(1).dot(velocity)};
+  }
+
+  // drift correction towards the RCM, perpendicular to the shaft, i.e. b
+  Eigen::Vector2d drift_correction_(const lbr_ros2_control::RCMSolver &rcm_solver,
+                                    const Eigen::Vector3d &position,
+                                    const Eigen::Matrix3d &rotation) const {
+    const Eigen::Vector3d rcm_error = rcm_solver.get_rcm() - position;
+    return RCM_GAIN * Eigen::Vector2d(rotation.col(0).dot(rcm_error),
+                                      rotation.col(1).dot(rcm_error));
+  }
+
+  static constexpr double RCM_GAIN = 10.;
+  static constexpr double RCM_DISTANCE = 0.2;
+
+  jacobian_t jacobian_;
+  Eigen::Vector3d position_;
+  Eigen::Matrix3d rotation_;
+};
+
+TEST_F(TestRCMSolver, TestConstraint) {
+  // nearly undamped, the constraint is met exactly
+  lbr_ros2_control::RCMSolver rcm_solver(RCM_GAIN, 1.e-4);
+  rcm_solver.set_rcm(position_, rotation_, RCM_DISTANCE);
+  EXPECT_TRUE(rcm_solver.get_rcm().isApprox(position_ + RCM_DISTANCE * rotation_.col(2)));
+
+  // off the RCM, A dq = b, whatever the twist
+  const Eigen::Vector3d position =
+      position_ + 1.e-3 * rotation_.col(0) - 2.e-3 * rotation_.col(1) + 1.e-2 * rotation_.col(2);
+  cart_vector_t twist;
+  twist << 0.05, -0.02, 0.03, 0.2, -0.1, 0.3;
+  const jnt_vector_t dq = rcm_solver.solve(position, rotation_, jacobian_, twist);
+  EXPECT_NEAR(rcm_solver.get_rcm_error(), std::sqrt(5.) * 1.e-3, 1.e-12);
+  const Eigen::Vector2d b = drift_correction_(rcm_solver, position, rotation_);
+  EXPECT_LT((shaft_velocity_(rcm_solver, position, rotation_, jacobian_, dq) - b).norm(),
+            1.e-6 * b.norm());
+
+  // on the RCM, a twist along the shaft satisfies the constraint and is tracked
+  twist << 0.01 * rotation_.col(2), Eigen::Vector3d::Zero();
+  const jnt_vector_t dq_shaft = rcm_solver.solve(position_, rotation_, jacobian_, twist);
+  EXPECT_LT((jacobian_ * dq_shaft - twist).norm(), 1.e-6 * twist.norm());
+}
+
+TEST_F(TestRCMSolver, TestBoundedRCMErrorOverTwist) {
+  lbr_ros2_control::RCMSolver rcm_solver(RCM_GAIN);
+  rcm_solver.set_rcm(position_, rotation_, RCM_DISTANCE);
+
+  // integrate the chain tip pose under a scripted twist, lateral and rotational, for 2 s
+  const double dt = 0.001;
+  Eigen::Vector3d position = position_;
+  Eigen::Matrix3d rotation = rotation_;
+  double max_rcm_error = 0.;
+  for (int i = 0; i < 2000; ++i) {
+    const double t = i * dt;
+    cart_vector_t twist;
+    twist << 0.05 * std::sin(2. * M_PI * t), 0.03 * std::cos(2. * M_PI * t), 0.02,
+        0.2 * std::sin(M_PI * t), -0.1, 0.3 * std::cos(M_PI * t);
+    const jnt_vector_t &dq = rcm_solver.solve(position, rotation, jacobian_, twist);
+    ASSERT_TRUE(dq.allFinite());
+    max_rcm_error = std::max(max_rcm_error, rcm_solver.get_rcm_error());
+
+    const cart_vector_t chain_tip_twist = jacobian_ * dq;
+    position += dt * chain_tip_twist.head<3>();
+    const Eigen::Vector3d angular_velocity = chain_tip_twist.tail<3>();
+    if (angular_velocity.norm() > 0.) {
+      rotation = Eigen::AngleAxisd(dt * angular_velocity.norm(), angular_velocity.normalized()) *
+                 rotation;
+    }
+  }
+  EXPECT_LT(max_rcm_error, 1.e-5);
+}
+
+TEST_F(TestRCMSolver, TestNearSingularConstraint) {
+  // shaft along z, the constraint's y-row, vy - alpha wx, vanishes with vy and wx
+  const Eigen::Matrix3d rotation = Eigen::Matrix3d::Identity();
+  const Eigen::Vector3d position = position_ + Eigen::Vector3d(1.e-3, 1.e-3, 0.);
+  cart_vector_t twist;
+  twist << 0.05, 0.05, 0.02, 0.1, 0.1, 0.1;
+  for (const double &scale : {1.e-3, 1.e-6, 1.e-9, 0.}) {
+    jacobian_t jacobian = jacobian_;
+    jacobian.row(1) *= scale;
+    jacobian.row(3) *= scale;
+    const double pinv_damping = 0.05;
+    lbr_ros2_control::RCMSolver rcm_solver(RCM_GAIN, pinv_damping);
+    rcm_solver.set_rcm(position_, rotation, RCM_DISTANCE);
+
+    // a finite step, bounded by the damped least-squares inverses
+    const jnt_vector_t &dq = rcm_solver.solve(position, rotation, jacobian, twist);
+    ASSERT_TRUE(dq.allFinite()) << "scale " << scale;
+    const Eigen::Vector2d b = drift_correction_(rcm_solver, position, rotation);
+    EXPECT_LT(dq.norm(), (b.norm() + twist.norm()) / pinv_damping) << "scale " << scale;
+
+    // the regular x-row is still met
+    const Eigen::Vector2d shaft_velocity =
+        shaft_velocity_(rcm_solver, position, rotation, jacobian, dq);
+    EXPECT_NEAR(shaft_velocity.x(), b.x(), 1.e-2 * std::abs(b.x())) << "scale " << scale;
+  }
+}
+
+TEST_F(TestRCMSolver, TestInvalidParameters) {
+  EXPECT_THROW(lbr_ros2_control::RCMSolver(-1., 0.05), std::runtime_error);
+  EXPECT_THROW(lbr_ros2_control::RCMSolver(10., 0.), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "hardware_interface/hardware_info.hpp"
+#include "hardware_interface/types/hardware_interface_return_values.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+
+#include "friClientVersion.h"
+#include "friLBRClient.h"
+
+#include "lbr_ros2_control/system_interface.hpp"
+#include "lbr_ros2_control/system_interface_type_values.hpp"
+
+namespace {
+// the robot side client command mode is injected instead of received via the FRI
+class SwitchingSystemInterface : public lbr_ros2_control::SystemInterface {
+public:
+  SwitchingSystemInterface() {
+    for (const auto &joint_name : {"A1", "A2", "A3", "A4", "A5", "A6", "A7"}) {
+      hardware_interface::ComponentInfo joint;
+      joint.name = joint_name;
+      info_.joints.push_back(joint);
+    }
+    info_.gpios.resize(2);
+    info_.gpios[0].name = lbr_ros2_control::HW_IF_WRENCH_PREFIX;
+    info_.gpios[1].name = lbr_ros2_control::HW_IF_ESTIMATED_FT_FRAME_PREFIX;
+  }
+
+  void set_client_command_modes(const KUKA::FRI::EClientCommandMode &configured,
+                                const KUKA::FRI::EClientCommandMode &reported) {
+    parameters_.client_command_mode = configured;
+    reported_client_command_mode_ = reported;
+    reported_ = true;
+  }
+
+protected:
+  bool get_client_command_mode_(KUKA::FRI::EClientCommandMode &client_command_mode) const override {
+    client_command_mode = reported_client_command_mode_;
+    return reported_;
+  }
+
+  bool reported_{false};
+  KUKA::FRI::EClientCommandMode reported_client_command_mode_{
+      KUKA::FRI::EClientCommandMode::NO_COMMAND_MODE};
+};
+
+#if FRI_CLIENT_VERSION_MAJOR == 1
+constexpr KUKA::FRI::EClientCommandMode POSITION_MODE = KUKA::FRI::EClientCommandMode::POSITION;
+#endif
+#if FRI_CLIENT_VERSION_MAJOR >= 2
+constexpr KUKA::FRI::EClientCommandMode POSITION_MODE =
+    KUKA::FRI::EClientCommandMode::JOINT_POSITION;
+#endif
+
+std::vector<std::string> joint_interfaces(const std::string &interface_name) {
+  std::vector<std::string> interfaces;
+  for (const auto &joint_name : {"A1", "A2", "A3", "A4", "A5", "A6", "A7"}) {
+    interfaces.push_back(std::string(joint_name) + "/" + interface_name);
+  }
+  return interfaces;
+}
+
+std::vector<std::string> wrench_interfaces() {
+  std::vector<std::string> interfaces = joint_interfaces(hardware_interface::HW_IF_POSITION);
+  for (const auto &ft : {lbr_ros2_control::HW_IF_FORCE_X, lbr_ros2_control::HW_IF_FORCE_Y,
+                         lbr_ros2_control::HW_IF_FORCE_Z, lbr_ros2_control::HW_IF_TORQUE_X,
+                         lbr_ros2_control::HW_IF_TORQUE_Y, lbr_ros2_control::HW_IF_TORQUE_Z}) {
+    interfaces.push_back(std::string(lbr_ros2_control::HW_IF_WRENCH_PREFIX) + "/" + ft);
+  }
+  return interfaces;
+}
+
+std::vector<std::string> torque_interfaces() {
+  std::vector<std::string> interfaces = joint_interfaces(hardware_interface::HW_IF_POSITION);
+  for (const auto &interface : joint_interfaces(hardware_interface::HW_IF_EFFORT)) {
+    interfaces.push_back(interface);
+  }
+  return interfaces;
+}
+
+const std::vector<std::string> FT_FRAME_INTERFACES = {
+    std::string(lbr_ros2_control::HW_IF_ESTIMATED_FT_FRAME_PREFIX) + "/" +
+    lbr_ros2_control::HW_IF_INDEX};
+} // namespace
+
+class TestSystemInterface : public ::testing::Test {
+protected:
+  hardware_interface::return_type prepare_(const std::vector<std::string> &start_interfaces) {
+    return system_interface_.prepare_command_mode_switch(start_interfaces, {});
+  }
+
+  SwitchingSystemInterface system_interface_;
+};
+
+TEST_F(TestSystemInterface, TestAcceptedSwitches) {
+  system_interface_.set_client_command_modes(POSITION_MODE, POSITION_MODE);
+  EXPECT_EQ(prepare_(joint_interfaces(hardware_interface::HW_IF_POSITION)),
+            hardware_interface::return_type::OK);
+  EXPECT_EQ(prepare_(FT_FRAME_INTERFACES), hardware_interface::return_type::OK);
+  EXPECT_EQ(prepare_({}), hardware_interface::return_type::OK);
+
+  system_interface_.set_client_command_modes(KUKA::FRI::EClientCommandMode::TORQUE,
+                                             KUKA::FRI::EClientCommandMode::TORQUE);
+  EXPECT_EQ(prepare_(torque_interfaces()), hardware_interface::return_type::OK);
+  EXPECT_EQ(prepare_(joint_interfaces(hardware_interface::HW_IF_POSITION)),
+            hardware_interface::return_type::OK);
+
+  system_interface_.set_client_command_modes(KUKA::FRI::EClientCommandMode::WRENCH,
+                                             KUKA::FRI::EClientCommandMode::WRENCH);
+  EXPECT_EQ(prepare_(wrench_interfaces()), hardware_interface::return_type::OK);
+}
+
+TEST_F(TestSystemInterface, TestRejectedSwitches) {
+  system_interface_.set_client_command_modes(POSITION_MODE, POSITION_MODE);
+  EXPECT_EQ(prepare_(torque_interfaces()), hardware_interface::return_type::ERROR);
+  EXPECT_EQ(prepare_(wrench_interfaces()), hardware_interface::return_type::ERROR);
+  EXPECT_EQ(prepare_({"A8/position"}), hardware_interface::return_type::ERROR);
+  EXPECT_EQ(prepare_({"A1/velocity"}), hardware_interface::return_type::ERROR);
+
+  system_interface_.set_client_command_modes(KUKA::FRI::EClientCommandMode::TORQUE,
+                                             KUKA::FRI::EClientCommandMode::TORQUE);
+  EXPECT_EQ(prepare_(wrench_interfaces()), hardware_interface::return_type::ERROR);
+
+  system_interface_.set_client_command_modes(KUKA::FRI::EClientCommandMode::WRENCH,
+                                             KUKA::FRI::EClientCommandMode::WRENCH);
+  EXPECT_EQ(prepare_(torque_interfaces()), hardware_interface::return_type::ERROR);
+}
+
+TEST_F(TestSystemInterface, TestValidatesReportedClientCommandMode) {
+  // configured for torque, but the robot application runs in position
+  system_interface_.set_client_command_modes(KUKA::FRI::EClientCommandMode::TORQUE,
+                                             POSITION_MODE);
+  EXPECT_EQ(prepare_(torque_interfaces()), hardware_interface::return_type::ERROR);
+  EXPECT_EQ(prepare_(joint_interfaces(hardware_interface::HW_IF_POSITION)),
+            hardware_interface::return_type::OK);
+
+  // vice versa
+  system_interface_.set_client_command_modes(POSITION_MODE,
+                                             KUKA::FRI::EClientCommandMode::TORQUE);
+  EXPECT_EQ(prepare_(torque_interfaces()), hardware_interface::return_type::OK);
+}
+
+TEST_F(TestSystemInterface, TestRejectsBeforeStateReceived) {
+  // no client command mode reported yet
+  EXPECT_EQ(prepare_(joint_interfaces(hardware_interface::HW_IF_POSITION)),
+            hardware_interface::return_type::ERROR);
+  EXPECT_EQ(prepare_(FT_FRAME_INTERFACES), hardware_interface::return_type::OK);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}